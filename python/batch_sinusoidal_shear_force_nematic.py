@@ -121,15 +121,21 @@ if __name__ == "__main__":
 
     # Timescale of ERK activation used to non-dimensionalize
     tau_e = 1.0
-    # Specify the length of the burn-in period (in terms of the
-    # predicted period of oscillation)
-    #const_arg_dict["-end_time"] = np.round(100*calc_period(tau_e, const_arg_dict["-taul"]))
-    const_arg_dict["-end_time"] = dt
+    # Specify the longest burn-in period (in terms of the predicted
+    # period of oscillation). The burn-in ends as soon as the tissue
+    # is statistically steady over windows of a few periods, and the
+    # time used is written to params.txt as burn_in_time.
+    const_arg_dict["-end_time"] = np.round(100*calc_period(tau_e, const_arg_dict["-taul"]))
+    const_arg_dict["-burn_in_tolerance"] = 0.05
+    const_arg_dict["-burn_in_window"] = np.round(5*calc_period(tau_e, const_arg_dict["-taul"]))
     # Specify the length of the data capture period (in terms of the
     # predicted period of oscillation)
     const_arg_dict["-bonus_time"] = np.round(100*calc_period(tau_e, const_arg_dict["-taul"]))
     # Specify a sampling interval for the data capture period
     const_arg_dict["-sampling_timestep_multiple"] = 10*int(0.1/dt)
+    # Write VTK meshes less often than the numeric cell data (0 for
+    # no VTK output)
+    const_arg_dict["-vtk_timestep_multiple"] = 100*int(0.1/dt)
 
     # Parameter lists within this dictionary are paired by index,
     # i.e. p1[i] with p2[i]. Lists should be of the same length.
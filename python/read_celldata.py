@@ -0,0 +1,223 @@
+# Functions to read the binary columnar "celldata.bin" files written
+# by ErkPropulsionBinaryWriter. The file is memory mapped and each
+# field is returned as a numpy array viewing the file directly, so no
+# values are parsed or copied. Files written with error bounds
+# (format version 2) are decoded to float64 arrays that match the
+# simulated values to within each field's bound.
+import numpy as np
+
+
+MAGIC = b"ERKCOLS"
+
+
+def read_header(buf):
+    """Read the file header of a celldata.bin file
+
+    buf: numpy uint8 array (e.g. a memmap) of the file contents
+
+    Return: (header_size, fields, byte_order, error_bounds) where
+    fields is a list of (name, dtype) pairs in the order they are
+    written in each sample, byte_order is "<" or ">" and error_bounds
+    is a list with the absolute error bound of each field (0 if it is
+    stored exactly)
+    """
+    if bytes(buf[:7]) != MAGIC:
+        raise ValueError("Not a celldata.bin file (bad magic string)")
+    byte_order = chr(buf[7])
+    version, num_fields = np.frombuffer(buf, dtype=byte_order + "u4", count=2, offset=8)
+    if version not in (1, 2):
+        raise ValueError("Unsupported celldata.bin version {}".format(version))
+    header_size = int(np.frombuffer(buf, dtype=byte_order + "u8", count=1, offset=16)[0])
+
+    entry_size = 40 if version == 1 else 48
+    fields = []
+    error_bounds = []
+    for i in range(num_fields):
+        offset = 24 + entry_size*i
+        name = bytes(buf[offset:offset + 32]).rstrip(b"\0").decode()
+        dtype = bytes(buf[offset + 32:offset + 40]).rstrip(b"\0").decode()
+        fields.append((name, np.dtype(dtype)))
+        if version == 1:
+            error_bounds.append(0.0)
+        else:
+            error_bounds.append(float(np.frombuffer(buf, dtype=byte_order + "f8", count=1, offset=offset + 40)[0]))
+    return header_size, fields, byte_order, error_bounds
+
+
+def sample_dtype(fields, num_cells, byte_order="<"):
+    """Create a numpy structured dtype matching one sample record
+
+    Every column is padded to a multiple of 8 bytes.
+    """
+    record = [("time", byte_order + "f8"), ("num_cells", byte_order + "u8")]
+    for name, dtype in fields:
+        record.append((name, dtype, (num_cells,)))
+        padding = (-num_cells*dtype.itemsize) % 8
+        if padding:
+            record.append(("_pad_" + name, "V{}".format(padding)))
+    return np.dtype(record)
+
+
+# Length of the unary code marking an escaped residual (QuantisedDeltaCodec::ESCAPE)
+ESCAPE = 24
+
+
+def decode_block(buf, offset, num_cells, byte_order="<"):
+    """Decode one column compressed by QuantisedDeltaCodec
+
+    Return: (residuals, block_size) where residuals are the signed
+    differences between each cell's quantised value and its
+    prediction, and block_size is the number of bytes read
+    """
+    k = int(buf[offset])
+    num_escapes = int(np.frombuffer(buf, dtype=byte_order + "u4", count=1, offset=offset + 4)[0])
+    num_unary_bytes = int(np.frombuffer(buf, dtype=byte_order + "u8", count=1, offset=offset + 8)[0])
+    position = offset + 16
+    escapes = np.frombuffer(buf, dtype=byte_order + "u8", count=num_escapes, offset=position)
+    position += 8*num_escapes
+
+    # The quotient of each residual is the number of one bits before
+    # its terminating zero
+    unary = np.unpackbits(np.asarray(buf[position:position + num_unary_bytes]))
+    position += num_unary_bytes
+    zeros = np.flatnonzero(unary == 0)[:num_cells]
+    quotients = np.diff(zeros, prepend=-1) - 1
+
+    num_remainder_bytes = (num_cells*k + 7)//8
+    remainders = np.zeros(num_cells, dtype=np.uint64)
+    if k > 0:
+        bits = np.unpackbits(np.asarray(buf[position:position + num_remainder_bytes]))[:num_cells*k]
+        for column in bits.reshape(num_cells, k).T:
+            remainders = (remainders << np.uint64(1)) | column
+    position += num_remainder_bytes
+
+    zigzag = (quotients.astype(np.uint64) << np.uint64(k)) | remainders
+    zigzag[quotients == ESCAPE] = escapes
+    residuals = (zigzag >> np.uint64(1)).astype(np.int64) ^ -(zigzag & np.uint64(1)).astype(np.int64)
+
+    block_size = position - offset
+    return residuals, block_size + (-block_size) % 8
+
+
+def match_previous(previous_ids, ids):
+    """Find each cell in the previous sample
+
+    Return: for each cell id in ids, its row in previous_ids or -1
+    """
+    if np.array_equal(ids, previous_ids):
+        return np.arange(len(ids))
+    rows = np.full(len(ids), -1)
+    if len(previous_ids) == 0:
+        return rows
+    order = np.argsort(previous_ids)
+    candidates = order[np.minimum(np.searchsorted(previous_ids, ids, sorter=order), len(order) - 1)]
+    matched = previous_ids[candidates] == ids
+    rows[matched] = candidates[matched]
+    return rows
+
+
+def read_compressed_celldata(buf, header_size, fields, byte_order, error_bounds):
+    """Decode the samples of a version 2 (compressed) celldata.bin
+
+    Return: a list with one dict per sample, as for read_celldata
+    """
+    samples = []
+    previous_ids = np.empty(0, dtype=np.uint32)
+    previous = [np.empty(0, dtype=np.int64) for _ in fields]
+    offset = header_size
+    while offset + 24 <= len(buf):
+        time = np.frombuffer(buf, dtype=byte_order + "f8", count=1, offset=offset)[0]
+        num_cells, record_size = (int(n) for n in np.frombuffer(buf, dtype=byte_order + "u8", count=2, offset=offset + 8))
+        if offset + record_size > len(buf):
+            break    # Incomplete final sample, e.g. a run that was killed
+        sample = {"time": time}
+        rows = None
+        position = offset + 24
+        for i, ((name, dtype), bound) in enumerate(zip(fields, error_bounds)):
+            if bound == 0.0:
+                sample[name] = np.frombuffer(buf, dtype=dtype, count=num_cells, offset=position)
+                size = num_cells*dtype.itemsize
+                position += size + (-size) % 8
+                continue
+
+            # Values are predicted from the same cell in the previous sample
+            if rows is None:
+                rows = match_previous(previous_ids, sample["cell_id"])
+            residuals, size = decode_block(buf, position, num_cells, byte_order)
+            position += size
+            quantised = residuals
+            quantised[rows >= 0] += previous[i][rows[rows >= 0]]
+            previous[i] = quantised
+            sample[name] = quantised*(2.0*bound)
+        previous_ids = sample["cell_id"]
+        samples.append(sample)
+        offset += record_size
+    return samples
+
+
+def read_celldata(path):
+    """Memory map a celldata.bin file
+
+    path: location of the file, e.g.
+    "results_from_time_xxxx/celldata.bin"
+
+    Return: dict mapping "time" to a 1d array of sample times and each
+    field name (location_index, cell_id, x, y, erk, A0, A, theta and
+    any extras) to a 2d array of shape (num_samples, num_cells). The
+    arrays are read-only views of the file (or decoded copies for a
+    file written with error bounds). If the number of cells changes
+    between samples a list with one such dict per sample is returned
+    instead (with 1d arrays for each field).
+    """
+    buf = np.memmap(path, dtype=np.uint8, mode="r")
+    header_size, fields, byte_order, error_bounds = read_header(buf)
+
+    if any(error_bounds):
+        samples = read_compressed_celldata(buf, header_size, fields, byte_order, error_bounds)
+        if len(samples) == 0:
+            return {"time": np.empty(0)}
+        if len(set(len(sample["cell_id"]) for sample in samples)) > 1:
+            return samples
+        return {name: np.array([sample[name] for sample in samples]) for name in samples[0]}
+
+    if len(buf) == header_size:
+        return {"time": np.empty(0)}
+
+    # Try the fast path: a fixed number of cells in every sample lets
+    # us view the whole file as an array of records (an incomplete
+    # final sample, e.g. from a run that was killed, is dropped)
+    num_cells = int(np.frombuffer(buf, dtype=byte_order + "u8", count=1, offset=header_size + 8)[0])
+    record = sample_dtype(fields, num_cells, byte_order)
+    num_samples = (len(buf) - header_size) // record.itemsize
+    data = np.ndarray(shape=(num_samples,), dtype=record, buffer=buf, offset=header_size)
+    if np.all(data["num_cells"] == num_cells):
+        out = {"time": data["time"]}
+        for name, _ in fields:
+            out[name] = data[name]
+        return out
+
+    # Otherwise walk the samples one at a time
+    samples = []
+    offset = header_size
+    while offset + 16 <= len(buf):
+        num_cells = int(np.frombuffer(buf, dtype=byte_order + "u8", count=1, offset=offset + 8)[0])
+        record = sample_dtype(fields, num_cells, byte_order)
+        if offset + record.itemsize > len(buf):
+            break    # Incomplete final sample, e.g. a run that was killed
+        sample = np.ndarray(shape=(), dtype=record, buffer=buf, offset=offset)
+        samples.append({"time": sample["time"][()],
+                        **{name: sample[name] for name, _ in fields}})
+        offset += record.itemsize
+    return samples
+
+
+if __name__ == "__main__":
+    import sys
+
+    data = read_celldata(sys.argv[1])
+    if isinstance(data, dict):
+        print("{} samples".format(len(data["time"])))
+        for name, arr in data.items():
+            print(name, arr.dtype, arr.shape)
+    else:
+        print("{} samples with a varying number of cells".format(len(data)))
@@ -0,0 +1,38 @@
+# Function to read the "erk_spectrum.dat" files written by
+# ErkSpectrumModifier, e.g. to compare the measured ERK wave period
+# with calc_period() in batch_sinusoidal_shear_force_nematic.py.
+import numpy as np
+
+
+def read_erk_spectrum(path):
+    """Read an erk_spectrum.dat file
+
+    path: location of the file, e.g.
+    "results_from_time_xxxx/erk_spectrum.dat"
+
+    Return: dict with the scalar entries (peak_period, peak_wavelength,
+    sample_interval, ...), 1d arrays "frequencies", "wave_numbers",
+    "temporal_power" and "spatial_power", and the 2d array
+    "space_time_power" of shape (num_frequencies, num_wave_numbers)
+    """
+    out = {}
+    rows = []
+    with open(path) as f:
+        for line in f:
+            if line.startswith("#"):
+                continue
+            words = line.split()
+            if words[0][0].isalpha():
+                values = np.array(words[1:], dtype=float)
+                out[words[0]] = values[0] if len(values) == 1 and words[0] not in ("frequencies", "wave_numbers") else values
+            else:
+                rows.append(np.array(words, dtype=float))
+    out["space_time_power"] = np.array(rows)
+    return out
+
+
+if __name__ == "__main__":
+    import sys
+
+    spectrum = read_erk_spectrum(sys.argv[1])
+    print("peak period {}, peak wavelength {}".format(spectrum["peak_period"], spectrum["peak_wavelength"]))
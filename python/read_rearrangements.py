@@ -0,0 +1,44 @@
+# Function to read the binary "rearrangements.bin" event logs written
+# by RearrangementLog (see OutputCadenceVertexBasedCellPopulation).
+import numpy as np
+
+
+MAGIC = b"ERKREAR"
+
+# Marks an unused node index or cell id (RearrangementLog::UNSET)
+UNSET = 0xFFFFFFFF
+
+
+def read_rearrangements(path):
+    """Memory map a rearrangements.bin file
+
+    path: location of the file, e.g.
+    "results_from_time_xxxx/rearrangements.bin"
+
+    Return: read-only numpy structured array with one entry per T1 or
+    T2 swap and the fields time, x, y, type (1 for T1, 2 for T2),
+    nodes (the two nodes of the new edge), gained (the cells coming
+    into contact, or the removed cell for a T2) and lost (the cells
+    losing contact). Unused ids are UNSET.
+    """
+    buf = np.memmap(path, dtype=np.uint8, mode="r")
+    if bytes(buf[:7]) != MAGIC:
+        raise ValueError("Not a rearrangements.bin file (bad magic string)")
+    byte_order = chr(buf[7])
+    version, record_size = np.frombuffer(buf, dtype=byte_order + "u4", count=2, offset=8)
+    if version != 1:
+        raise ValueError("Unsupported rearrangements.bin version {}".format(version))
+    record = np.dtype([("time", byte_order + "f8"), ("x", byte_order + "f8"), ("y", byte_order + "f8"),
+                       ("type", byte_order + "u4"), ("nodes", byte_order + "u4", (2,)),
+                       ("gained", byte_order + "u4", (2,)), ("lost", byte_order + "u4", (2,)),
+                       ("_pad", "V4")])
+    assert record.itemsize == record_size
+    num_events = (len(buf) - 16) // record_size
+    return np.ndarray(shape=(num_events,), dtype=record, buffer=buf, offset=16)
+
+
+if __name__ == "__main__":
+    import sys
+
+    events = read_rearrangements(sys.argv[1])
+    print("{} T1 and {} T2 swaps".format(np.sum(events["type"] == 1), np.sum(events["type"] == 2)))
@@ -1,6 +1,7 @@
 # Functions to create argument arrays of parameter values and launch
 # simulations as separate subprocesses
 import itertools as it
+import os
 import subprocess
 
 
@@ -63,8 +64,36 @@ def create_args_arr(executable, const_arg_dict, paired_arg_dict,
     return args_arr
 
 
+def read_run_status(outdir):
+    """Read the run_status.txt file a simulation writes when it ends
+
+    outdir: the simulation's -outdir, relative to CHASTE_TEST_OUTPUT
+
+    Return: dict with the status ("complete" or "aborted"), reason,
+    time and message, or None if the run never wrote the file
+    """
+    path = os.path.join(os.environ.get("CHASTE_TEST_OUTPUT", ""), outdir, "run_status.txt")
+    try:
+        with open(path) as f:
+            return dict(line.rstrip("\n").split(" ", 1) for line in f if " " in line)
+    except OSError:
+        return None
+
+
 def launch_subprocess(args):
+    """Run one simulation
+
+    Return: the run's status from read_run_status, or None if it is
+    not known
+    """
+    outdir = args[args.index("-outdir") + 1] if "-outdir" in args else None
     try:
-        p = subprocess.run(args=args, check=True)
+        subprocess.run(args=args, check=True)
     except Exception:
-        print("Process not complete ", args)
+        status = read_run_status(outdir) if outdir else None
+        if status is not None and status.get("status") == "aborted":
+            print("Process aborted ({} at time {}) ".format(status.get("reason"), status.get("time")), args)
+        else:
+            print("Process not complete ", args)
+        return status
+    return read_run_status(outdir) if outdir else None
@@ -0,0 +1,108 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "BatchMeans.hpp"
+#include "Exception.hpp"
+
+#include <cmath>
+
+BatchMeans::BatchMeans(unsigned batchLength)
+    : mBatchLength(batchLength),
+      mCurrentSum(0.0),
+      mNumInCurrentBatch(0)
+{
+    if (batchLength == 0)
+    {
+        EXCEPTION("A batch must contain at least one value");
+    }
+}
+
+void BatchMeans::Add(double value)
+{
+    mCurrentSum += value;
+    mNumInCurrentBatch++;
+    if (mNumInCurrentBatch == mBatchLength)
+    {
+        mBatchMeans.push_back(mCurrentSum/mBatchLength);
+        mCurrentSum = 0.0;
+        mNumInCurrentBatch = 0;
+    }
+}
+
+void BatchMeans::Reset()
+{
+    mCurrentSum = 0.0;
+    mNumInCurrentBatch = 0;
+    mBatchMeans.clear();
+}
+
+unsigned BatchMeans::GetNumBatches() const
+{
+    return mBatchMeans.size();
+}
+
+const std::vector<double>& BatchMeans::rGetBatchMeans() const
+{
+    return mBatchMeans;
+}
+
+double BatchMeans::GetMean() const
+{
+    if (mBatchMeans.empty())
+    {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (unsigned i=0; i<mBatchMeans.size(); i++)
+    {
+        sum += mBatchMeans[i];
+    }
+    return sum/mBatchMeans.size();
+}
+
+double BatchMeans::GetStandardError() const
+{
+    unsigned num_batches = mBatchMeans.size();
+    if (num_batches < 2)
+    {
+        return 0.0;
+    }
+    double mean = GetMean();
+    double sum_squares = 0.0;
+    for (unsigned i=0; i<num_batches; i++)
+    {
+        sum_squares += (mBatchMeans[i] - mean)*(mBatchMeans[i] - mean);
+    }
+    return sqrt(sum_squares/(num_batches - 1)/num_batches);
+}
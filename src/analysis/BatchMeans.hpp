@@ -0,0 +1,105 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef BATCHMEANS_HPP_
+#define BATCHMEANS_HPP_
+
+#include <vector>
+
+/**
+ * Running mean of a correlated time series with an error bar from the
+ * method of batch means: consecutive values are averaged in batches
+ * of a fixed length and the standard error is estimated from the
+ * scatter of the batch means. This is valid when the batches are long
+ * compared with the correlation time of the series.
+ */
+class BatchMeans
+{
+private:
+
+    /** The number of values in each batch. */
+    unsigned mBatchLength;
+
+    /** Sum of the values in the current, incomplete, batch. */
+    double mCurrentSum;
+
+    /** The number of values in the current batch. */
+    unsigned mNumInCurrentBatch;
+
+    /** The mean of each complete batch. */
+    std::vector<double> mBatchMeans;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param batchLength the number of values in each batch (at least 1)
+     */
+    BatchMeans(unsigned batchLength=1);
+
+    /**
+     * Add a value.
+     *
+     * @param value the value
+     */
+    void Add(double value);
+
+    /**
+     * Discard all values.
+     */
+    void Reset();
+
+    /**
+     * @return the number of complete batches
+     */
+    unsigned GetNumBatches() const;
+
+    /**
+     * @return the mean of each complete batch
+     */
+    const std::vector<double>& rGetBatchMeans() const;
+
+    /**
+     * @return the mean over the complete batches, or 0 if there are none
+     */
+    double GetMean() const;
+
+    /**
+     * @return the standard error of GetMean(), or 0 if there are fewer than two batches
+     */
+    double GetStandardError() const;
+};
+
+#endif /*BATCHMEANS_HPP_*/
@@ -0,0 +1,123 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "Fft.hpp"
+#include "Exception.hpp"
+
+#include <cassert>
+#include <cmath>
+
+bool Fft::IsPowerOfTwo(unsigned n)
+{
+    return (n > 0) && ((n & (n-1)) == 0);
+}
+
+void Fft::Transform(std::vector<std::complex<double> >& rData, bool inverse)
+{
+    unsigned n = rData.size();
+    if (!IsPowerOfTwo(n))
+    {
+        EXCEPTION("Fft::Transform() needs a power of two length, not " << n);
+    }
+
+    // Bit reversal permutation
+    for (unsigned i=1, j=0; i<n; i++)
+    {
+        unsigned bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+        {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j)
+        {
+            std::swap(rData[i], rData[j]);
+        }
+    }
+
+    // Butterflies
+    double sign = inverse ? 1.0 : -1.0;
+    for (unsigned length=2; length<=n; length <<= 1)
+    {
+        double angle = sign*2.0*M_PI/length;
+        std::complex<double> w_length(cos(angle), sin(angle));
+        for (unsigned start=0; start<n; start+=length)
+        {
+            std::complex<double> w(1.0, 0.0);
+            for (unsigned k=0; k<length/2; k++)
+            {
+                std::complex<double> u = rData[start+k];
+                std::complex<double> v = rData[start+k+length/2]*w;
+                rData[start+k] = u + v;
+                rData[start+k+length/2] = u - v;
+                w *= w_length;
+            }
+        }
+    }
+}
+
+void Fft::TransformAxis(std::vector<std::complex<double> >& rData,
+                        const std::vector<unsigned>& rShape,
+                        unsigned axis)
+{
+    assert(axis < rShape.size());
+
+    // Distance between neighbouring entries along the axis, and the
+    // number of blocks before it
+    unsigned stride = 1;
+    for (unsigned i=axis+1; i<rShape.size(); i++)
+    {
+        stride *= rShape[i];
+    }
+    unsigned length = rShape[axis];
+    unsigned num_blocks = rData.size()/(stride*length);
+
+    std::vector<std::complex<double> > line(length);
+    for (unsigned block=0; block<num_blocks; block++)
+    {
+        for (unsigned offset=0; offset<stride; offset++)
+        {
+            unsigned start = block*length*stride + offset;
+            for (unsigned i=0; i<length; i++)
+            {
+                line[i] = rData[start + i*stride];
+            }
+            Transform(line);
+            for (unsigned i=0; i<length; i++)
+            {
+                rData[start + i*stride] = line[i];
+            }
+        }
+    }
+}
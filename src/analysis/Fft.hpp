@@ -0,0 +1,78 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef FFT_HPP_
+#define FFT_HPP_
+
+#include <complex>
+#include <vector>
+
+/**
+ * A minimal in-place radix-2 fast Fourier transform, used by the
+ * in-situ analysis modifiers so that they do not need an external FFT
+ * library. Only power of two lengths are supported.
+ */
+class Fft
+{
+public:
+
+    /**
+     * @param n a length
+     * @return whether n is a power of two (and non-zero)
+     */
+    static bool IsPowerOfTwo(unsigned n);
+
+    /**
+     * Compute the discrete Fourier transform
+     *   X_k = sum_j x_j exp(-2 pi i j k/n)
+     * in place, or the unnormalised inverse transform (exp(+2 pi i j k/n)).
+     *
+     * @param rData the data, whose size must be a power of two
+     * @param inverse whether to compute the inverse transform
+     */
+    static void Transform(std::vector<std::complex<double> >& rData, bool inverse=false);
+
+    /**
+     * Transform every line of a multidimensional array along one axis.
+     *
+     * @param rData the array in row-major order
+     * @param rShape the size of each axis (each a power of two)
+     * @param axis the axis along which to transform
+     */
+    static void TransformAxis(std::vector<std::complex<double> >& rData,
+                              const std::vector<unsigned>& rShape,
+                              unsigned axis);
+};
+
+#endif /*FFT_HPP_*/
@@ -0,0 +1,115 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "Histogram.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+Histogram::Histogram(double min, double max, unsigned numBins)
+    : mMin(min),
+      mMax(max),
+      mCounts(numBins, 0),
+      mNumBelow(0),
+      mNumAbove(0)
+{
+    if (numBins == 0 || !(max > min))
+    {
+        EXCEPTION("A Histogram needs at least one bin and a maximum greater than its minimum");
+    }
+}
+
+Histogram Histogram::FromValues(const std::vector<double>& rValues, unsigned numBins)
+{
+    double min = 0.0;
+    double max = 1.0;
+    if (!rValues.empty())
+    {
+        min = *std::min_element(rValues.begin(), rValues.end());
+        max = *std::max_element(rValues.begin(), rValues.end());
+    }
+
+    // Widen the range slightly so that the largest value falls in the
+    // last bin, and give identical values a bin of non-zero width
+    double padding = (max > min) ? 1e-9*(max - min) : std::max(0.5*fabs(min), 0.5);
+    Histogram histogram(min - ((max > min) ? 0.0 : padding), max + padding, numBins);
+    for (unsigned i=0; i<rValues.size(); i++)
+    {
+        histogram.Add(rValues[i]);
+    }
+    return histogram;
+}
+
+void Histogram::Add(double value)
+{
+    if (value < mMin)
+    {
+        mNumBelow++;
+    }
+    else if (value >= mMax)
+    {
+        mNumAbove++;
+    }
+    else
+    {
+        unsigned bin = static_cast<unsigned>((value - mMin)/(mMax - mMin)*mCounts.size());
+        mCounts[std::min<unsigned>(bin, mCounts.size() - 1)]++;
+    }
+}
+
+const std::vector<unsigned>& Histogram::rGetCounts() const
+{
+    return mCounts;
+}
+
+double Histogram::GetBinEdge(unsigned i) const
+{
+    return mMin + (mMax - mMin)*i/mCounts.size();
+}
+
+void Histogram::Write(std::ostream& rStream, const std::string& rName) const
+{
+    rStream << rName << "_bin_edges";
+    for (unsigned i=0; i<=mCounts.size(); i++)
+    {
+        rStream << " " << GetBinEdge(i);
+    }
+    rStream << "\n" << rName << "_counts";
+    for (unsigned i=0; i<mCounts.size(); i++)
+    {
+        rStream << " " << mCounts[i];
+    }
+    rStream << "\n" << rName << "_out_of_range " << mNumBelow << " " << mNumAbove << "\n";
+}
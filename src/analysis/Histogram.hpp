@@ -0,0 +1,114 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef HISTOGRAM_HPP_
+#define HISTOGRAM_HPP_
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * A histogram with equal width bins over a fixed range, used by the
+ * in-situ analysis modifiers to summarise per-cell statistics. Values
+ * outside the range are counted separately.
+ */
+class Histogram
+{
+private:
+
+    /** Lower edge of the first bin. */
+    double mMin;
+
+    /** Upper edge of the last bin. */
+    double mMax;
+
+    /** The number of values in each bin. */
+    std::vector<unsigned> mCounts;
+
+    /** The number of values below mMin. */
+    unsigned mNumBelow;
+
+    /** The number of values at or above mMax. */
+    unsigned mNumAbove;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param min lower edge of the first bin
+     * @param max upper edge of the last bin (must exceed min)
+     * @param numBins the number of bins (at least 1)
+     */
+    Histogram(double min, double max, unsigned numBins);
+
+    /**
+     * Create a histogram whose range just covers a set of values.
+     *
+     * @param rValues the values, which are also added to the histogram
+     * @param numBins the number of bins
+     * @return the histogram
+     */
+    static Histogram FromValues(const std::vector<double>& rValues, unsigned numBins);
+
+    /**
+     * Add a value.
+     *
+     * @param value the value
+     */
+    void Add(double value);
+
+    /**
+     * @return the number of values in each bin
+     */
+    const std::vector<unsigned>& rGetCounts() const;
+
+    /**
+     * @param i a bin edge index, from 0 to the number of bins
+     * @return the position of the edge
+     */
+    double GetBinEdge(unsigned i) const;
+
+    /**
+     * Write the histogram as two lines, "<name>_bin_edges ..." and
+     * "<name>_counts ...", followed by the out of range counts.
+     *
+     * @param rStream the stream to write to
+     * @param rName the name of the histogram
+     */
+    void Write(std::ostream& rStream, const std::string& rName) const;
+};
+
+#endif /*HISTOGRAM_HPP_*/
@@ -0,0 +1,222 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "MultipleTauCorrelator.hpp"
+#include "Exception.hpp"
+
+#include <cassert>
+
+MultipleTauCorrelator::ShiftRegister::ShiftRegister()
+{
+}
+
+MultipleTauCorrelator::MultipleTauCorrelator(unsigned dimension, Mode mode, unsigned numLevels,
+                                             unsigned pointsPerLevel, unsigned averagingFactor)
+    : mDimension(dimension),
+      mNumLevels(numLevels),
+      mPointsPerLevel(pointsPerLevel),
+      mAveragingFactor(averagingFactor),
+      mMode(mode),
+      mSums(numLevels*pointsPerLevel, 0.0),
+      mCounts(numLevels*pointsPerLevel, 0)
+{
+    if (dimension == 0 || numLevels == 0)
+    {
+        EXCEPTION("A correlator needs at least one component and one level");
+    }
+    if (averagingFactor < 2 || pointsPerLevel < averagingFactor || pointsPerLevel%averagingFactor != 0)
+    {
+        EXCEPTION("The points per level must be a multiple of an averaging factor of at least 2");
+    }
+    ResetShiftRegister(mShiftRegister);
+}
+
+void MultipleTauCorrelator::ResetShiftRegister(ShiftRegister& rShiftRegister) const
+{
+    rShiftRegister.mValues.assign(mNumLevels*mPointsPerLevel*mDimension, 0.0);
+    rShiftRegister.mBlockSums.assign(mNumLevels*mDimension, 0.0);
+    rShiftRegister.mNewest.assign(mNumLevels, 0);
+    rShiftRegister.mNumValues.assign(mNumLevels, 0);
+    rShiftRegister.mBlockSizes.assign(mNumLevels, 0);
+}
+
+void MultipleTauCorrelator::Add(const std::vector<double>& rValue)
+{
+    Add(mShiftRegister, rValue);
+}
+
+void MultipleTauCorrelator::Add(ShiftRegister& rShiftRegister, const std::vector<double>& rValue)
+{
+    assert(rValue.size() == mDimension);
+    assert(rShiftRegister.mNewest.size() == mNumLevels);
+    AddToLevel(rShiftRegister, 0, &rValue[0]);
+}
+
+void MultipleTauCorrelator::AddToLevel(ShiftRegister& rShiftRegister, unsigned level, const double* pValue)
+{
+    double* p_values = &rShiftRegister.mValues[level*mPointsPerLevel*mDimension];
+    unsigned& r_newest = rShiftRegister.mNewest[level];
+    unsigned& r_num_values = rShiftRegister.mNumValues[level];
+    r_newest = (r_newest + 1)%mPointsPerLevel;
+    double* p_newest = &p_values[r_newest*mDimension];
+    for (unsigned d=0; d<mDimension; d++)
+    {
+        p_newest[d] = pValue[d];
+    }
+    if (r_num_values < mPointsPerLevel)
+    {
+        r_num_values++;
+    }
+
+    // Lags shorter than mPointsPerLevel/mAveragingFactor are covered
+    // more finely by the level below
+    double* p_sums = &mSums[level*mPointsPerLevel];
+    unsigned long* p_counts = &mCounts[level*mPointsPerLevel];
+    unsigned first_point = (level == 0) ? 0 : mPointsPerLevel/mAveragingFactor;
+    for (unsigned j=first_point; j<r_num_values; j++)
+    {
+        const double* p_old = &p_values[((r_newest + mPointsPerLevel - j)%mPointsPerLevel)*mDimension];
+        double sum = 0.0;
+        for (unsigned d=0; d<mDimension; d++)
+        {
+            if (mMode == PRODUCT)
+            {
+                sum += p_newest[d]*p_old[d];
+            }
+            else
+            {
+                sum += (p_newest[d] - p_old[d])*(p_newest[d] - p_old[d]);
+            }
+        }
+        p_sums[j] += sum;
+        p_counts[j]++;
+    }
+
+    if (level + 1 == mNumLevels)
+    {
+        return;
+    }
+    double* p_block_sum = &rShiftRegister.mBlockSums[level*mDimension];
+    for (unsigned d=0; d<mDimension; d++)
+    {
+        p_block_sum[d] += pValue[d];
+    }
+    rShiftRegister.mBlockSizes[level]++;
+    if (rShiftRegister.mBlockSizes[level] == mAveragingFactor)
+    {
+        if (mMode == PRODUCT)
+        {
+            for (unsigned d=0; d<mDimension; d++)
+            {
+                p_block_sum[d] /= mAveragingFactor;
+            }
+            AddToLevel(rShiftRegister, level + 1, p_block_sum);
+        }
+        else
+        {
+            AddToLevel(rShiftRegister, level + 1, p_newest);
+        }
+        for (unsigned d=0; d<mDimension; d++)
+        {
+            p_block_sum[d] = 0.0;
+        }
+        rShiftRegister.mBlockSizes[level] = 0;
+    }
+}
+
+unsigned MultipleTauCorrelator::GetNumLags() const
+{
+    return mPointsPerLevel + (mNumLevels - 1)*(mPointsPerLevel - mPointsPerLevel/mAveragingFactor);
+}
+
+/**
+ * Find the level and point of a lag index.
+ *
+ * @param i the lag index
+ * @param pointsPerLevel the number of values kept at each level
+ * @param averagingFactor the ratio of the lag spacing of successive levels
+ * @param rLevel set to the level
+ * @param rPoint set to the point within the level
+ */
+static void FindLevelAndPoint(unsigned i, unsigned pointsPerLevel, unsigned averagingFactor,
+                              unsigned& rLevel, unsigned& rPoint)
+{
+    if (i < pointsPerLevel)
+    {
+        rLevel = 0;
+        rPoint = i;
+        return;
+    }
+    unsigned points_per_coarse_level = pointsPerLevel - pointsPerLevel/averagingFactor;
+    rLevel = 1 + (i - pointsPerLevel)/points_per_coarse_level;
+    rPoint = pointsPerLevel/averagingFactor + (i - pointsPerLevel)%points_per_coarse_level;
+}
+
+unsigned long MultipleTauCorrelator::GetLag(unsigned i) const
+{
+    assert(i < GetNumLags());
+    unsigned level;
+    unsigned point;
+    FindLevelAndPoint(i, mPointsPerLevel, mAveragingFactor, level, point);
+    unsigned long lag = point;
+    for (unsigned l=0; l<level; l++)
+    {
+        lag *= mAveragingFactor;
+    }
+    return lag;
+}
+
+double MultipleTauCorrelator::GetSum(unsigned i) const
+{
+    assert(i < GetNumLags());
+    unsigned level;
+    unsigned point;
+    FindLevelAndPoint(i, mPointsPerLevel, mAveragingFactor, level, point);
+    return mSums[level*mPointsPerLevel + point];
+}
+
+unsigned long MultipleTauCorrelator::GetCount(unsigned i) const
+{
+    assert(i < GetNumLags());
+    unsigned level;
+    unsigned point;
+    FindLevelAndPoint(i, mPointsPerLevel, mAveragingFactor, level, point);
+    return mCounts[level*mPointsPerLevel + point];
+}
+
+double MultipleTauCorrelator::GetCorrelation(unsigned i) const
+{
+    unsigned long count = GetCount(i);
+    return (count > 0) ? GetSum(i)/count : 0.0;
+}
@@ -0,0 +1,209 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef MULTIPLETAUCORRELATOR_HPP_
+#define MULTIPLETAUCORRELATOR_HPP_
+
+#include <vector>
+
+/**
+ * A multiple-tau correlator (Ramirez et al., J. Chem. Phys. 133,
+ * 154103, 2010) for a vector-valued time series, which estimates a
+ * time correlation function on a logarithmic grid of lags with memory
+ * and work per sample independent of the length of the series.
+ *
+ * Level 0 keeps the last mPointsPerLevel samples and correlates each
+ * new sample with them at lags 0 to mPointsPerLevel-1. Every
+ * mAveragingFactor samples a level passes one value to the next level,
+ * whose lags are therefore mAveragingFactor times longer; only the
+ * lags not already covered by the level below are used. In PRODUCT
+ * mode the passed value is the block average and the dot product
+ * a(t).a(t-tau) is accumulated, as for a velocity autocorrelation. In
+ * SQUARED_DIFFERENCE mode the last value of the block is passed on, so
+ * that |x(t)-x(t-tau)|^2 is exact at every lag, as for a mean squared
+ * displacement.
+ *
+ * The values held at each level of a time series are kept in a
+ * ShiftRegister, separate from the sums and counts at each lag. Many
+ * time series with the same lag grid, such as the trajectories of the
+ * cells of a population, can therefore share one correlator, each
+ * keeping only its own ShiftRegister, so that their pairs are
+ * accumulated together.
+ */
+class MultipleTauCorrelator
+{
+public:
+
+    /** The quantity accumulated for each pair of values. */
+    enum Mode
+    {
+        PRODUCT,
+        SQUARED_DIFFERENCE
+    };
+
+    /** The values held at each level for one time series. */
+    class ShiftRegister
+    {
+        friend class MultipleTauCorrelator;
+
+        /** The last values at each level, ring buffers of pointsPerLevel values, indexed [level][point][component]. */
+        std::vector<double> mValues;
+
+        /** Sum of the current block of values at each level, indexed [level][component]. */
+        std::vector<double> mBlockSums;
+
+        /** The position of the newest value in each ring buffer. */
+        std::vector<unsigned> mNewest;
+
+        /** The number of values seen at each level, up to pointsPerLevel. */
+        std::vector<unsigned> mNumValues;
+
+        /** The number of values in the current block at each level. */
+        std::vector<unsigned> mBlockSizes;
+
+    public:
+
+        /**
+         * Constructor. An empty register must be reset by the
+         * correlator it is used with before use.
+         */
+        ShiftRegister();
+    };
+
+private:
+
+    /** The number of components of each value. */
+    unsigned mDimension;
+
+    /** The number of levels. */
+    unsigned mNumLevels;
+
+    /** The number of values kept at each level. */
+    unsigned mPointsPerLevel;
+
+    /** The number of values of one level making a value of the next. */
+    unsigned mAveragingFactor;
+
+    /** The quantity accumulated. */
+    Mode mMode;
+
+    /** The shift register of the time series passed to Add() without one. */
+    ShiftRegister mShiftRegister;
+
+    /** Sum of the accumulated quantity at each lag, indexed [level][point]. */
+    std::vector<double> mSums;
+
+    /** The number of pairs accumulated at each lag, indexed [level][point]. */
+    std::vector<unsigned long> mCounts;
+
+    /**
+     * Add a value to a level of a shift register, correlate it with
+     * the values held there and pass a value on to the next level at
+     * the end of a block.
+     *
+     * @param rShiftRegister the shift register of the time series
+     * @param level the level
+     * @param pValue the value, of mDimension components
+     */
+    void AddToLevel(ShiftRegister& rShiftRegister, unsigned level, const double* pValue);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param dimension the number of components of each value
+     * @param mode the quantity accumulated for each pair of values
+     * @param numLevels the number of levels
+     * @param pointsPerLevel the number of values kept at each level (a multiple of averagingFactor)
+     * @param averagingFactor the ratio of the lag spacing of successive levels (at least 2)
+     */
+    MultipleTauCorrelator(unsigned dimension, Mode mode=PRODUCT, unsigned numLevels=16,
+                          unsigned pointsPerLevel=16, unsigned averagingFactor=2);
+
+    /**
+     * Add the next value of the time series.
+     *
+     * @param rValue the value, of as many components as the dimension
+     */
+    void Add(const std::vector<double>& rValue);
+
+    /**
+     * Empty a shift register and size it for this correlator.
+     *
+     * @param rShiftRegister the shift register
+     */
+    void ResetShiftRegister(ShiftRegister& rShiftRegister) const;
+
+    /**
+     * Add the next value of the time series whose values are held in
+     * a shift register, accumulating its pairs with those of every
+     * other series added to this correlator.
+     *
+     * @param rShiftRegister the shift register of the time series, reset by ResetShiftRegister()
+     * @param rValue the value, of as many components as the dimension
+     */
+    void Add(ShiftRegister& rShiftRegister, const std::vector<double>& rValue);
+
+    /**
+     * @return the number of lags at which the correlation is estimated
+     */
+    unsigned GetNumLags() const;
+
+    /**
+     * @param i a lag index, from 0 to GetNumLags()-1
+     * @return the lag, in samples
+     */
+    unsigned long GetLag(unsigned i) const;
+
+    /**
+     * @param i a lag index
+     * @return the sum of the accumulated quantity at the lag
+     */
+    double GetSum(unsigned i) const;
+
+    /**
+     * @param i a lag index
+     * @return the number of pairs accumulated at the lag
+     */
+    unsigned long GetCount(unsigned i) const;
+
+    /**
+     * @param i a lag index
+     * @return the estimated correlation at the lag, or 0 if no pairs have been seen
+     */
+    double GetCorrelation(unsigned i) const;
+};
+
+#endif /*MULTIPLETAUCORRELATOR_HPP_*/
@@ -0,0 +1,131 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "PeriodicGrid.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+PeriodicGrid::PeriodicGrid(unsigned numPointsX, unsigned numPointsY, double width, double height,
+                           Kernel kernel, double kernelWidth)
+    : mNumPointsX(numPointsX),
+      mNumPointsY(numPointsY),
+      mWidth(width),
+      mHeight(height),
+      mKernel(kernel),
+      mKernelWidth(kernelWidth)
+{
+    if (numPointsX == 0 || numPointsY == 0 || !(width > 0.0) || !(height > 0.0))
+    {
+        EXCEPTION("A PeriodicGrid needs at least one grid point and a positive width and height in each direction");
+    }
+    if (kernel == GAUSSIAN && !(kernelWidth > 0.0))
+    {
+        EXCEPTION("The width of a Gaussian kernel must be positive");
+    }
+}
+
+unsigned PeriodicGrid::GetNumPoints() const
+{
+    return mNumPointsX*mNumPointsY;
+}
+
+double PeriodicGrid::GetSpacingX() const
+{
+    return mWidth/mNumPointsX;
+}
+
+double PeriodicGrid::GetSpacingY() const
+{
+    return mHeight/mNumPointsY;
+}
+
+void PeriodicGrid::GetStencil(double x, double y, std::vector<std::pair<unsigned, double> >& rStencil) const
+{
+    rStencil.clear();
+
+    // Position in units of the grid spacing, wrapped into [0, n)
+    double gx = x/GetSpacingX();
+    double gy = y/GetSpacingY();
+    gx -= mNumPointsX*floor(gx/mNumPointsX);
+    gy -= mNumPointsY*floor(gy/mNumPointsY);
+
+    if (mKernel == NEAREST_GRID_POINT)
+    {
+        unsigned i = static_cast<unsigned>(floor(gx + 0.5))%mNumPointsX;
+        unsigned j = static_cast<unsigned>(floor(gy + 0.5))%mNumPointsY;
+        rStencil.push_back(std::make_pair(j*mNumPointsX + i, 1.0));
+    }
+    else if (mKernel == GAUSSIAN)
+    {
+        // All grid points within three standard deviations, counting
+        // each periodic image once, with weights normalised to one
+        int reach_x = std::min(static_cast<int>(ceil(3.0*mKernelWidth/GetSpacingX())), static_cast<int>(mNumPointsX - 1)/2);
+        int reach_y = std::min(static_cast<int>(ceil(3.0*mKernelWidth/GetSpacingY())), static_cast<int>(mNumPointsY - 1)/2);
+        int nearest_i = static_cast<int>(floor(gx + 0.5));
+        int nearest_j = static_cast<int>(floor(gy + 0.5));
+        double total_weight = 0.0;
+        for (int dj=-reach_y; dj<=reach_y; dj++)
+        {
+            double distance_y = (nearest_j + dj - gy)*GetSpacingY();
+            for (int di=-reach_x; di<=reach_x; di++)
+            {
+                double distance_x = (nearest_i + di - gx)*GetSpacingX();
+                double weight = exp(-0.5*(distance_x*distance_x + distance_y*distance_y)/(mKernelWidth*mKernelWidth));
+                unsigned i = (nearest_i + di + 2*mNumPointsX)%mNumPointsX;
+                unsigned j = (nearest_j + dj + 2*mNumPointsY)%mNumPointsY;
+                rStencil.push_back(std::make_pair(j*mNumPointsX + i, weight));
+                total_weight += weight;
+            }
+        }
+        for (unsigned k=0; k<rStencil.size(); k++)
+        {
+            rStencil[k].second /= total_weight;
+        }
+    }
+    else
+    {
+        unsigned i0 = static_cast<unsigned>(floor(gx))%mNumPointsX;
+        unsigned j0 = static_cast<unsigned>(floor(gy))%mNumPointsY;
+        unsigned i1 = (i0 + 1)%mNumPointsX;
+        unsigned j1 = (j0 + 1)%mNumPointsY;
+        double fx = gx - floor(gx);
+        double fy = gy - floor(gy);
+        rStencil.push_back(std::make_pair(j0*mNumPointsX + i0, (1.0 - fx)*(1.0 - fy)));
+        rStencil.push_back(std::make_pair(j0*mNumPointsX + i1, fx*(1.0 - fy)));
+        rStencil.push_back(std::make_pair(j1*mNumPointsX + i0, (1.0 - fx)*fy));
+        rStencil.push_back(std::make_pair(j1*mNumPointsX + i1, fx*fy));
+    }
+}
@@ -0,0 +1,122 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef PERIODICGRID_HPP_
+#define PERIODICGRID_HPP_
+
+#include <utility>
+#include <vector>
+
+/**
+ * A fixed Cartesian grid covering a doubly periodic domain, such as
+ * that of a Toroidal2dVertexMesh, onto which per-cell quantities are
+ * deposited by the in-situ analysis modifiers.
+ *
+ * Grid point (i, j) sits at (i*width/nx, j*height/ny) and has index
+ * j*nx + i. GetStencil() gives the grid points and weights to which a
+ * quantity at a given location is assigned; the weights sum to one.
+ */
+class PeriodicGrid
+{
+public:
+
+    /** Assignment schemes for depositing a point quantity onto the grid. */
+    enum Kernel
+    {
+        NEAREST_GRID_POINT,    /**< Assign everything to the nearest grid point. */
+        CLOUD_IN_CELL,         /**< Bilinear assignment to the four surrounding grid points. */
+        GAUSSIAN               /**< Gaussian weights, truncated at three times the kernel width. */
+    };
+
+private:
+
+    /** Number of grid points in x. */
+    unsigned mNumPointsX;
+
+    /** Number of grid points in y. */
+    unsigned mNumPointsY;
+
+    /** Width of the periodic domain. */
+    double mWidth;
+
+    /** Height of the periodic domain. */
+    double mHeight;
+
+    /** The assignment scheme. */
+    Kernel mKernel;
+
+    /** Standard deviation of the GAUSSIAN kernel. */
+    double mKernelWidth;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param numPointsX number of grid points in x
+     * @param numPointsY number of grid points in y
+     * @param width width of the periodic domain
+     * @param height height of the periodic domain
+     * @param kernel the assignment scheme (defaults to CLOUD_IN_CELL)
+     * @param kernelWidth standard deviation of the GAUSSIAN kernel (ignored by the others)
+     */
+    PeriodicGrid(unsigned numPointsX, unsigned numPointsY, double width, double height,
+                 Kernel kernel=CLOUD_IN_CELL, double kernelWidth=1.0);
+
+    /**
+     * @return the total number of grid points
+     */
+    unsigned GetNumPoints() const;
+
+    /**
+     * @return the grid spacing in x
+     */
+    double GetSpacingX() const;
+
+    /**
+     * @return the grid spacing in y
+     */
+    double GetSpacingY() const;
+
+    /**
+     * Find the grid points to which a quantity at (x, y) is assigned.
+     *
+     * @param x the x coordinate (need not lie within the domain)
+     * @param y the y coordinate (need not lie within the domain)
+     * @param rStencil cleared and filled with (grid point index, weight) pairs
+     */
+    void GetStencil(double x, double y, std::vector<std::pair<unsigned, double> >& rStencil) const;
+};
+
+#endif /*PERIODICGRID_HPP_*/
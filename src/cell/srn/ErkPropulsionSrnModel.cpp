@@ -32,9 +32,12 @@ LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
 OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
+#include "ErkPropulsionSrnModelNoAlignment.hpp"
 #include "ErkPropulsionSrnModelVelocityAlignment.hpp"
+#include "ErkPropulsionSrnModelNeighbourAlignment.hpp"
 
-ErkPropulsionSrnModelVelocityAlignment::ErkPropulsionSrnModelVelocityAlignment(boost::shared_ptr<AbstractCellCycleModelOdeSolver> pOdeSolver)
+template<class ALIGNMENT>
+ErkPropulsionSrnModel<ALIGNMENT>::ErkPropulsionSrnModel(boost::shared_ptr<AbstractCellCycleModelOdeSolver> pOdeSolver)
   : AbstractOdeSrnModel(3, pOdeSolver)
 {
     if (mpOdeSolver == boost::shared_ptr<AbstractCellCycleModelOdeSolver>())
@@ -42,13 +45,14 @@ ErkPropulsionSrnModelVelocityAlignment::ErkPropulsionSrnModelVelocityAlignment(b
       // Evolution of self propulsion angle follows a stochastic
       // differential equation so use a basic Euler solver rather than
       // one solver with an addaptive timestep.
-      mpOdeSolver = CellCycleModelOdeSolver<ErkPropulsionSrnModelVelocityAlignment, EulerIvpOdeSolver>::Instance();
+      mpOdeSolver = CellCycleModelOdeSolver<ErkPropulsionSrnModel<ALIGNMENT>, EulerIvpOdeSolver>::Instance();
       mpOdeSolver->Initialise();
- }
+    }
     assert(mpOdeSolver->IsSetUp());
 }
 
-ErkPropulsionSrnModelVelocityAlignment::ErkPropulsionSrnModelVelocityAlignment(const ErkPropulsionSrnModelVelocityAlignment& rModel)
+template<class ALIGNMENT>
+ErkPropulsionSrnModel<ALIGNMENT>::ErkPropulsionSrnModel(const ErkPropulsionSrnModel<ALIGNMENT>& rModel)
     : AbstractOdeSrnModel(rModel)
 {
     /*
@@ -66,53 +70,60 @@ ErkPropulsionSrnModelVelocityAlignment::ErkPropulsionSrnModelVelocityAlignment(c
      * in parent classes will be defined there.
      */
   assert(rModel.GetOdeSystem());
-  SetOdeSystem(new ErkPropulsionOdeSystemVelocityAlignment(rModel.GetOdeSystem()->rGetStateVariables()));
+  SetOdeSystem(new OdeSystem(rModel.GetOdeSystem()->rGetStateVariables()));
 }
 
-AbstractSrnModel* ErkPropulsionSrnModelVelocityAlignment::CreateSrnModel()
+template<class ALIGNMENT>
+AbstractSrnModel* ErkPropulsionSrnModel<ALIGNMENT>::CreateSrnModel()
 {
-    return new ErkPropulsionSrnModelVelocityAlignment(*this);
+    return new ErkPropulsionSrnModel<ALIGNMENT>(*this);
 }
 
-void ErkPropulsionSrnModelVelocityAlignment::SimulateToCurrentTime()
+template<class ALIGNMENT>
+void ErkPropulsionSrnModel<ALIGNMENT>::SimulateToCurrentTime()
 {
     // Update areas from CellData in the ODE system
     UpdateSrnAreas();
-    // Update angles of instantaneous cell velocties in the ODE system
-    UpdateSrnVelocityAngles();
+    // Update the angles to align with in the ODE system
+    UpdateSrnAlignmentAngles();
     // Run the ODE simulation
     AbstractOdeSrnModel::SimulateToCurrentTime();
 }
 
-void ErkPropulsionSrnModelVelocityAlignment::Initialise()
+template<class ALIGNMENT>
+void ErkPropulsionSrnModel<ALIGNMENT>::Initialise()
 {
-    AbstractOdeSrnModel::Initialise(new ErkPropulsionOdeSystemVelocityAlignment);
+    AbstractOdeSrnModel::Initialise(new OdeSystem);
     SetSrnParams();    // Pass parameters from cell data to the OdeSystem
 }
 
-void ErkPropulsionSrnModelVelocityAlignment::UpdateSrnAreas()
+template<class ALIGNMENT>
+void ErkPropulsionSrnModel<ALIGNMENT>::UpdateSrnAreas()
 {
     assert(mpOdeSystem != nullptr);
     assert(mpCell != nullptr);
 
     // Send the cell area (2D volume) to the ode solver
     double cell_area = mpCell->GetCellData()->GetItem("volume");
-    mpOdeSystem->SetParameter("Cell Area", cell_area);
+    mpOdeSystem->SetParameter(OdeSystem::CELL_AREA, cell_area);
 }
 
-
-void ErkPropulsionSrnModelVelocityAlignment::UpdateSrnVelocityAngles()
+template<class ALIGNMENT>
+void ErkPropulsionSrnModel<ALIGNMENT>::UpdateSrnAlignmentAngles()
 {
-    assert(mpOdeSystem != nullptr);
-    assert(mpCell != nullptr);
+    if (ALIGNMENT::ALIGNS)
+    {
+        assert(mpOdeSystem != nullptr);
+        assert(mpCell != nullptr);
 
-    // Send the angle of instantaneous cell velocity to the ODE solver
-    double theta_vi = mpCell->GetCellData()->GetItem("theta_vi");
-    mpOdeSystem->SetParameter("theta_vi", theta_vi);
+        // Send the angle to align with to the ODE solver
+        double theta_vi = mpCell->GetCellData()->GetItem("theta_vi");
+        mpOdeSystem->SetParameter(OdeSystem::ALIGNMENT_ANGLE, theta_vi);
+    }
 }
 
-
-void ErkPropulsionSrnModelVelocityAlignment::SetSrnParams()
+template<class ALIGNMENT>
+void ErkPropulsionSrnModel<ALIGNMENT>::SetSrnParams()
 {
   assert(mpOdeSystem != nullptr);
   assert(mpCell != nullptr);
@@ -121,74 +132,91 @@ void ErkPropulsionSrnModelVelocityAlignment::SetSrnParams()
 
   // timescale of prefered area changes
   double taul = mpCell->GetCellData()->GetItem("taul");
-  mpOdeSystem->SetParameter("taul", taul);
+  mpOdeSystem->SetParameter(OdeSystem::TAUL, taul);
 
   // Coupling strength from ERK onto preferred area
   double alpha = mpCell->GetCellData()->GetItem("alpha");
-  mpOdeSystem->SetParameter("alpha", alpha);
+  mpOdeSystem->SetParameter(OdeSystem::ALPHA, alpha);
 
   // Coupling strength from area onto ERK
   double beta = mpCell->GetCellData()->GetItem("beta");
-  mpOdeSystem->SetParameter("beta", beta);
+  mpOdeSystem->SetParameter(OdeSystem::BETA, beta);
 
   // std of the guassian noise on self propulsion angle
   double eta_std = mpCell->GetCellData()->GetItem("Eta Std");
-  mpOdeSystem->SetParameter("Eta Std", eta_std);
+  mpOdeSystem->SetParameter(OdeSystem::ETA_STD, eta_std);
 
   // ODE timestep
   double dt_ode = mpCell->GetCellData()->GetItem("dt_ode");
-  mpOdeSystem->SetParameter("dt_ode", dt_ode);
-
-  // Strength of velocity alignment K*sin(theta_vi - theta)
-  double K = mpCell->GetCellData()->GetItem("K");
-  mpOdeSystem->SetParameter("K", K);
-
+  mpOdeSystem->SetParameter(OdeSystem::DT_ODE, dt_ode);
+
+  if (ALIGNMENT::ALIGNS)
+  {
+      // Strength of alignment K*sin(theta_vi - theta)
+      double K = mpCell->GetCellData()->GetItem("K");
+      mpOdeSystem->SetParameter(OdeSystem::ALIGNMENT_STRENGTH, K);
+  }
 }
 
-double ErkPropulsionSrnModelVelocityAlignment::GetTheta()
+template<class ALIGNMENT>
+double ErkPropulsionSrnModel<ALIGNMENT>::GetTheta()
 {
     assert(mpOdeSystem != nullptr);
     double theta = mpOdeSystem->rGetStateVariables()[0];
     return theta;
 }
 
-double ErkPropulsionSrnModelVelocityAlignment::GetErk()
+template<class ALIGNMENT>
+double ErkPropulsionSrnModel<ALIGNMENT>::GetErk()
 {
     assert(mpOdeSystem != nullptr);
     double erk = mpOdeSystem->rGetStateVariables()[1];
     return erk;
 }
 
-double ErkPropulsionSrnModelVelocityAlignment::GetTargetArea()
+template<class ALIGNMENT>
+double ErkPropulsionSrnModel<ALIGNMENT>::GetTargetArea()
 {
     assert(mpOdeSystem != nullptr);
     double target_area = mpOdeSystem->rGetStateVariables()[2];
     return target_area;
 }
 
-double ErkPropulsionSrnModelVelocityAlignment::GetCellArea()
+template<class ALIGNMENT>
+double ErkPropulsionSrnModel<ALIGNMENT>::GetCellArea()
 {
     assert(mpOdeSystem != nullptr);
-    double cell_area = mpOdeSystem->GetParameter("Cell Area");
+    double cell_area = mpOdeSystem->GetParameter(OdeSystem::CELL_AREA);
     return cell_area;
 }
 
-double ErkPropulsionSrnModelVelocityAlignment::GetCellVelocityAngle()
+template<class ALIGNMENT>
+double ErkPropulsionSrnModel<ALIGNMENT>::GetAlignmentAngle()
 {
     assert(mpOdeSystem != nullptr);
-    double cell_area = mpOdeSystem->GetParameter("Theta_vi");    // Instantaneous cell velocity
-    return cell_area;
+    assert(ALIGNMENT::ALIGNS);
+    double theta_vi = mpOdeSystem->GetParameter(OdeSystem::ALIGNMENT_ANGLE);
+    return theta_vi;
 }
 
-
-void ErkPropulsionSrnModelVelocityAlignment::OutputSrnModelParameters(out_stream& rParamsFile)
+template<class ALIGNMENT>
+void ErkPropulsionSrnModel<ALIGNMENT>::OutputSrnModelParameters(out_stream& rParamsFile)
 {
     // No new parameters to output, so just call method on direct parent class
     AbstractOdeSrnModel::OutputSrnModelParameters(rParamsFile);
 }
 
+// Explicit instantiation
+template class ErkPropulsionSrnModel<NoAlignment>;
+template class ErkPropulsionSrnModel<VelocityAlignment>;
+template class ErkPropulsionSrnModel<NeighbourAlignment>;
+
 // Declare identifier for the serializer
 #include "SerializationExportWrapperForCpp.hpp"
+CHASTE_CLASS_EXPORT(ErkPropulsionSrnModelNoAlignment)
 CHASTE_CLASS_EXPORT(ErkPropulsionSrnModelVelocityAlignment)
+CHASTE_CLASS_EXPORT(ErkPropulsionSrnModelNeighbourAlignment)
 #include "CellCycleModelOdeSolverExportWrapper.hpp"
+EXPORT_CELL_CYCLE_MODEL_ODE_SOLVER(ErkPropulsionSrnModelNoAlignment)
 EXPORT_CELL_CYCLE_MODEL_ODE_SOLVER(ErkPropulsionSrnModelVelocityAlignment)
+EXPORT_CELL_CYCLE_MODEL_ODE_SOLVER(ErkPropulsionSrnModelNeighbourAlignment)
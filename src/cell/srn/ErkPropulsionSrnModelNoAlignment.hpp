@@ -36,127 +36,14 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ERKPROPULSIONSRNMODELNOALIGNMENT_HPP_
 #define ERKPROPULSIONSRNMODELNOALIGNMENT_HPP_
 
-#include "ChasteSerialization.hpp"
-#include <boost/serialization/base_object.hpp>
-
+#include "ErkPropulsionSrnModel.hpp"
 #include "ErkPropulsionOdeSystemNoAlignment.hpp"
-#include "AbstractOdeSrnModel.hpp"
 
 /**
- * A subclass of AbstractOdeSrnModel that includes mechanochemical
- * ERK-area dynamics and a persistent random walk (SDE) in self
- * propulsion angle in the sub-cellular reaction network.
- *
- * \todo #2752 document this class more thoroughly here
+ * The ErkPropulsionSrnModel without alignment of the self propulsion
+ * angle.
  */
-class ErkPropulsionSrnModelNoAlignment : public AbstractOdeSrnModel
-{
-private:
-
-    /** Needed for serialization. */
-    friend class boost::serialization::access;
-    /**
-     * Archive the SRN model and member variables.
-     *
-     * @param archive the archive
-     * @param version the current version of this class
-     */
-    template<class Archive>
-    void serialize(Archive & archive, const unsigned int version)
-    {
-        archive & boost::serialization::base_object<AbstractOdeSrnModel>(*this);
-    }
-
-protected:
-    /**
-     * Protected copy-constructor for use by CreateSrnModel(). The
-     * only way for external code to create a copy of a SRN model is
-     * by calling that method, to ensure that a model of the correct
-     * subclass is created. This copy-constructor helps subclasses to
-     * ensure that all member variables are correctly copied when this
-     * happens.
-     *
-     * This method is called by child classes to set member variables
-     * for a daughter cell upon cell division.  Note that the parent
-     * SRN model will have had ResetForDivision() called just before
-     * CreateSrnModel() is called, so performing an exact copy of the
-     * parent is suitable behaviour. Any daughter-cell-specific
-     * initialisation can be done in InitialiseDaughterCell().
-     *
-     * @param rModel  the SRN model to copy.
-     */
-    ErkPropulsionSrnModelNoAlignment(const ErkPropulsionSrnModelNoAlignment& rModel);
-
-public:
-
-    /**
-     * Default constructor calls base class.
-     *
-     * @param pOdeSolver An optional pointer to a cell-cycle model ODE
-     * solver object (allows the use of different ODE solvers)
-     */
-    ErkPropulsionSrnModelNoAlignment(boost::shared_ptr<AbstractCellCycleModelOdeSolver> pOdeSolver = boost::shared_ptr<AbstractCellCycleModelOdeSolver>());
-
-    /**
-     * Overridden builder method to create new copies of
-     * this SRN model.
-     *
-     * @return a copy of the current SRN model.
-     */
-    AbstractSrnModel* CreateSrnModel();
-
-    /**
-     * Initialise the SRN model at the start of a simulation.
-     *
-     * This overridden method sets up a new ODE system.
-     */
-    void Initialise();
-
-    /**
-     * Overridden SimulateToTime() method for custom behaviour.
-     *
-     * \todo #2752 say what it does in this class
-     */
-    void SimulateToCurrentTime();
-
-    /**
-     * Copies the current cell areas from the CellData to the
-     * OdeSystem.
-     */
-    void UpdateSrnAreas();
-
-    /**
-     * Copies parameters from the CellData to the OdeSystem.
-     */
-    void SetSrnParams();
-
-    /**
-     * @return the current self propulsion angle in this cell.
-     */
-    double GetTheta();
-
-    /**
-     * @return the current Erk level in this cell.
-     */
-    double GetErk();
-
-    /**
-     * @return the current target area in this cell.
-     */
-    double GetTargetArea();
-
-    /**
-     * @return the current cell area in this cell.
-     */
-    double GetCellArea();
-
-    /**
-     * Output SRN model parameters to file.
-     *
-     * @param rParamsFile the file stream to which the parameters are output
-     */
-    void OutputSrnModelParameters(out_stream& rParamsFile);
-};
+typedef ErkPropulsionSrnModel<NoAlignment> ErkPropulsionSrnModelNoAlignment;
 
 // Declare identifier for the serializer
 #include "SerializationExportWrapper.hpp"
@@ -0,0 +1,165 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "HalfEdgeMeshView.hpp"
+#include "Exception.hpp"
+
+const unsigned HalfEdgeMeshView::NONE;
+
+void HalfEdgeMeshView::Update(VertexMesh<2, 2>& rMesh)
+{
+    // Number the half-edges element by element. Deleted elements (if
+    // any are still in the mesh) have none.
+    unsigned num_elements = rMesh.GetNumAllElements();
+    mFirstHalfEdges.resize(num_elements + 1);
+    mFirstHalfEdges[0] = 0;
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        VertexElement<2, 2>* p_element = rMesh.GetElement(elem_index);
+        unsigned num_nodes_elem = p_element->IsDeleted() ? 0 : p_element->GetNumNodes();
+        mFirstHalfEdges[elem_index+1] = mFirstHalfEdges[elem_index] + num_nodes_elem;
+    }
+    unsigned num_half_edges = mFirstHalfEdges[num_elements];
+    mOrigins.resize(num_half_edges);
+    mFaces.resize(num_half_edges);
+    mNext.resize(num_half_edges);
+    mPrevious.resize(num_half_edges);
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        unsigned first = mFirstHalfEdges[elem_index];
+        unsigned num_nodes_elem = mFirstHalfEdges[elem_index+1] - first;
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            unsigned half_edge = first + local_index;
+            mOrigins[half_edge] = rMesh.GetElement(elem_index)->GetNodeGlobalIndex(local_index);
+            mFaces[half_edge] = elem_index;
+            mNext[half_edge] = first + (local_index+1)%num_nodes_elem;
+            mPrevious[half_edge] = first + (local_index+num_nodes_elem-1)%num_nodes_elem;
+        }
+    }
+
+    // Bucket the half-edges by the node they start from, so that the
+    // twin of each half-edge is found among the few half-edges
+    // leaving its destination
+    unsigned num_nodes = rMesh.GetNumAllNodes();
+    std::vector<unsigned> bucket_starts(num_nodes + 1, 0);
+    for (unsigned half_edge=0; half_edge<num_half_edges; half_edge++)
+    {
+        bucket_starts[mOrigins[half_edge] + 1]++;
+    }
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        bucket_starts[node_index+1] += bucket_starts[node_index];
+    }
+    std::vector<unsigned> outgoing(num_half_edges);
+    std::vector<unsigned> next_in_bucket(bucket_starts.begin(), bucket_starts.end() - 1);
+    for (unsigned half_edge=0; half_edge<num_half_edges; half_edge++)
+    {
+        outgoing[next_in_bucket[mOrigins[half_edge]]++] = half_edge;
+    }
+
+    mTwins.assign(num_half_edges, NONE);
+    mEdges.clear();
+    mEdges.reserve(num_half_edges/2 + 1);
+    for (unsigned half_edge=0; half_edge<num_half_edges; half_edge++)
+    {
+        unsigned origin = mOrigins[half_edge];
+        unsigned destination = mOrigins[mNext[half_edge]];
+        for (unsigned k=bucket_starts[destination]; k<bucket_starts[destination+1]; k++)
+        {
+            if (mOrigins[mNext[outgoing[k]]] == origin)
+            {
+                if (mTwins[half_edge] != NONE)
+                {
+                    EXCEPTION("An edge of the vertex mesh is shared by more than two elements");
+                }
+                mTwins[half_edge] = outgoing[k];
+            }
+        }
+        if (mTwins[half_edge] == NONE || half_edge < mTwins[half_edge])
+        {
+            mEdges.push_back(half_edge);
+        }
+    }
+}
+
+unsigned HalfEdgeMeshView::GetNumHalfEdges() const
+{
+    return mOrigins.size();
+}
+
+unsigned HalfEdgeMeshView::GetFirstHalfEdge(unsigned elemIndex) const
+{
+    return mFirstHalfEdges[elemIndex];
+}
+
+unsigned HalfEdgeMeshView::GetNumHalfEdgesOfElement(unsigned elemIndex) const
+{
+    return mFirstHalfEdges[elemIndex+1] - mFirstHalfEdges[elemIndex];
+}
+
+unsigned HalfEdgeMeshView::GetOrigin(unsigned halfEdge) const
+{
+    return mOrigins[halfEdge];
+}
+
+unsigned HalfEdgeMeshView::GetDestination(unsigned halfEdge) const
+{
+    return mOrigins[mNext[halfEdge]];
+}
+
+unsigned HalfEdgeMeshView::GetFace(unsigned halfEdge) const
+{
+    return mFaces[halfEdge];
+}
+
+unsigned HalfEdgeMeshView::GetNext(unsigned halfEdge) const
+{
+    return mNext[halfEdge];
+}
+
+unsigned HalfEdgeMeshView::GetPrevious(unsigned halfEdge) const
+{
+    return mPrevious[halfEdge];
+}
+
+unsigned HalfEdgeMeshView::GetTwin(unsigned halfEdge) const
+{
+    return mTwins[halfEdge];
+}
+
+const std::vector<unsigned>& HalfEdgeMeshView::rGetEdges() const
+{
+    return mEdges;
+}
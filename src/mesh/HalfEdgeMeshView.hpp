@@ -0,0 +1,160 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef HALFEDGEMESHVIEW_HPP_
+#define HALFEDGEMESHVIEW_HPP_
+
+#include <climits>
+#include <vector>
+
+#include "VertexMesh.hpp"
+
+/**
+ * A half-edge view of the topology of a 2D vertex mesh, for forces
+ * that work per edge rather than per node.
+ *
+ * Each element contributes one half-edge per node, running
+ * anticlockwise from that node to the next one round the element.
+ * The half-edges of element e are numbered consecutively from
+ * GetFirstHalfEdge(e), in the order of the element's nodes, so the
+ * half-edge from local node i of the element is GetFirstHalfEdge(e) + i.
+ * The twin of a half-edge is the half-edge of the neighbouring element
+ * along the same edge in the opposite direction (NONE on the boundary
+ * of a non-periodic mesh). Each edge is listed once in rGetEdges(),
+ * by one of its half-edges.
+ *
+ * The view only stores indices, so it stays valid as nodes move but
+ * must be rebuilt with Update() whenever the topology changes, e.g.
+ * by T1 or T2 swaps in ReMesh().
+ */
+class HalfEdgeMeshView
+{
+public:
+
+    /** Marks a missing twin. */
+    static const unsigned NONE = UINT_MAX;
+
+private:
+
+    /** The position of the first half-edge of each element, followed by the number of half-edges. */
+    std::vector<unsigned> mFirstHalfEdges;
+
+    /** The node each half-edge starts from. */
+    std::vector<unsigned> mOrigins;
+
+    /** The element each half-edge belongs to. */
+    std::vector<unsigned> mFaces;
+
+    /** The next half-edge round the same element. */
+    std::vector<unsigned> mNext;
+
+    /** The previous half-edge round the same element. */
+    std::vector<unsigned> mPrevious;
+
+    /** The twin of each half-edge, or NONE. */
+    std::vector<unsigned> mTwins;
+
+    /** One half-edge of each edge. */
+    std::vector<unsigned> mEdges;
+
+public:
+
+    /**
+     * Rebuild the view from the current topology of a mesh.
+     *
+     * @param rMesh the mesh
+     */
+    void Update(VertexMesh<2, 2>& rMesh);
+
+    /**
+     * @return the number of half-edges
+     */
+    unsigned GetNumHalfEdges() const;
+
+    /**
+     * @param elemIndex the index of an element
+     * @return the half-edge from the element's first node
+     */
+    unsigned GetFirstHalfEdge(unsigned elemIndex) const;
+
+    /**
+     * @param elemIndex the index of an element
+     * @return the number of half-edges (and nodes) of the element
+     */
+    unsigned GetNumHalfEdgesOfElement(unsigned elemIndex) const;
+
+    /**
+     * @param halfEdge a half-edge
+     * @return the index of the node it starts from
+     */
+    unsigned GetOrigin(unsigned halfEdge) const;
+
+    /**
+     * @param halfEdge a half-edge
+     * @return the index of the node it ends at
+     */
+    unsigned GetDestination(unsigned halfEdge) const;
+
+    /**
+     * @param halfEdge a half-edge
+     * @return the index of the element it belongs to
+     */
+    unsigned GetFace(unsigned halfEdge) const;
+
+    /**
+     * @param halfEdge a half-edge
+     * @return the next half-edge round its element
+     */
+    unsigned GetNext(unsigned halfEdge) const;
+
+    /**
+     * @param halfEdge a half-edge
+     * @return the previous half-edge round its element
+     */
+    unsigned GetPrevious(unsigned halfEdge) const;
+
+    /**
+     * @param halfEdge a half-edge
+     * @return its twin, or NONE
+     */
+    unsigned GetTwin(unsigned halfEdge) const;
+
+    /**
+     * @return one half-edge of each edge (the one with the smaller
+     *     index for an edge between two elements)
+     */
+    const std::vector<unsigned>& rGetEdges() const;
+};
+
+#endif /*HALFEDGEMESHVIEW_HPP_*/
@@ -0,0 +1,100 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "HilbertCurve.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <utility>
+
+uint64_t HilbertCurve::GetIndex(uint32_t x, uint32_t y)
+{
+    const uint32_t n = 1u << ORDER;
+    assert(x < n && y < n);
+
+    uint64_t index = 0;
+    for (uint32_t s=n/2; s>0; s/=2)
+    {
+        uint32_t rx = (x & s) > 0;
+        uint32_t ry = (y & s) > 0;
+        index += uint64_t(s)*s*((3*rx) ^ ry);
+
+        // Rotate the quadrant so that the curve within it has the
+        // standard orientation
+        if (ry == 0)
+        {
+            if (rx == 1)
+            {
+                x = n-1 - x;
+                y = n-1 - y;
+            }
+            std::swap(x, y);
+        }
+    }
+    return index;
+}
+
+std::vector<unsigned> HilbertCurve::GetOrder(const std::vector<double>& rX,
+                                             const std::vector<double>& rY,
+                                             double width,
+                                             double height)
+{
+    if (rX.size() != rY.size())
+    {
+        EXCEPTION("HilbertCurve::GetOrder() needs the same number of x and y coordinates");
+    }
+    assert(width > 0.0 && height > 0.0);
+
+    const uint32_t n = 1u << ORDER;
+    std::vector<std::pair<uint64_t, unsigned> > keys(rX.size());
+    for (unsigned i=0; i<rX.size(); i++)
+    {
+        // Wrap into the rectangle and bin on the grid
+        double x = rX[i] - width*floor(rX[i]/width);
+        double y = rY[i] - height*floor(rY[i]/height);
+        uint32_t grid_x = std::min(n-1, uint32_t(x/width*n));
+        uint32_t grid_y = std::min(n-1, uint32_t(y/height*n));
+        keys[i] = std::make_pair(GetIndex(grid_x, grid_y), i);
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<unsigned> order(keys.size());
+    for (unsigned i=0; i<keys.size(); i++)
+    {
+        order[i] = keys[i].second;
+    }
+    return order;
+}
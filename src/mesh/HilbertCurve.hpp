@@ -0,0 +1,81 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef HILBERTCURVE_HPP_
+#define HILBERTCURVE_HPP_
+
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Ordering of points in a periodic rectangle along a Hilbert curve, a
+ * space-filling curve on which points that are close in the plane
+ * tend to be close in the ordering. Used to number mesh nodes and
+ * elements so that neighbours are stored close together in memory.
+ */
+class HilbertCurve
+{
+public:
+
+    /**
+     * The number of bits per coordinate. Points are binned on a
+     * 2^ORDER x 2^ORDER grid before being ordered.
+     */
+    static const unsigned ORDER = 16;
+
+    /**
+     * @param x the column of a grid cell, less than 2^ORDER
+     * @param y the row of a grid cell, less than 2^ORDER
+     * @return the distance of the grid cell along the Hilbert curve
+     */
+    static uint64_t GetIndex(uint32_t x, uint32_t y);
+
+    /**
+     * Sort points along the Hilbert curve. The points are first
+     * wrapped into the rectangle [0, width) x [0, height). Points in
+     * the same grid cell keep their relative order.
+     *
+     * @param rX the x coordinate of each point
+     * @param rY the y coordinate of each point
+     * @param width the width of the periodic rectangle
+     * @param height the height of the periodic rectangle
+     * @return the index of the point at each position in the ordering
+     */
+    static std::vector<unsigned> GetOrder(const std::vector<double>& rX,
+                                          const std::vector<double>& rY,
+                                          double width,
+                                          double height);
+};
+
+#endif /*HILBERTCURVE_HPP_*/
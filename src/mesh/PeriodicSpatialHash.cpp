@@ -0,0 +1,125 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "PeriodicSpatialHash.hpp"
+#include "Exception.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+PeriodicSpatialHash::PeriodicSpatialHash(unsigned numBinsX, unsigned numBinsY, double width, double height)
+    : mNumBinsX(numBinsX),
+      mNumBinsY(numBinsY),
+      mWidth(width),
+      mHeight(height)
+{
+    if (numBinsX == 0 || numBinsY == 0 || !(width > 0.0) || !(height > 0.0))
+    {
+        EXCEPTION("A PeriodicSpatialHash needs at least one bin and a positive width and height in each direction");
+    }
+    mBinStarts.assign(mNumBinsX*mNumBinsY + 1, 0);
+}
+
+unsigned PeriodicSpatialHash::GetNumBins() const
+{
+    return mNumBinsX*mNumBinsY;
+}
+
+unsigned PeriodicSpatialHash::GetBinX(double x) const
+{
+    double bx = floor(x*mNumBinsX/mWidth);
+    bx -= mNumBinsX*floor(bx/mNumBinsX);
+    return std::min(unsigned(bx), mNumBinsX - 1);    // Guard against rounding up to mNumBinsX
+}
+
+unsigned PeriodicSpatialHash::GetBinY(double y) const
+{
+    double by = floor(y*mNumBinsY/mHeight);
+    by -= mNumBinsY*floor(by/mNumBinsY);
+    return std::min(unsigned(by), mNumBinsY - 1);
+}
+
+void PeriodicSpatialHash::Clear()
+{
+    mEntries.clear();
+    mItems.clear();
+    mBinStarts.assign(mNumBinsX*mNumBinsY + 1, 0);
+}
+
+void PeriodicSpatialHash::AddBoundingBox(unsigned item, double xMin, double xMax, double yMin, double yMax)
+{
+    // The number of bins the box spans in each direction, at most all of them
+    double first_x = floor(xMin*mNumBinsX/mWidth);
+    double first_y = floor(yMin*mNumBinsY/mHeight);
+    unsigned num_x = unsigned(std::min(floor(xMax*mNumBinsX/mWidth) - first_x + 1.0, double(mNumBinsX)));
+    unsigned num_y = unsigned(std::min(floor(yMax*mNumBinsY/mHeight) - first_y + 1.0, double(mNumBinsY)));
+
+    unsigned bin_x = GetBinX(xMin);
+    unsigned bin_y = GetBinY(yMin);
+    for (unsigned j=0; j<num_y; j++)
+    {
+        unsigned row = (bin_y + j)%mNumBinsY;
+        for (unsigned i=0; i<num_x; i++)
+        {
+            mEntries.push_back(std::make_pair(row*mNumBinsX + (bin_x + i)%mNumBinsX, item));
+        }
+    }
+}
+
+void PeriodicSpatialHash::Build()
+{
+    // Counting sort of the entries by bin, which keeps the items of
+    // each bin in the order they were added
+    mBinStarts.assign(mNumBinsX*mNumBinsY + 1, 0);
+    for (unsigned k=0; k<mEntries.size(); k++)
+    {
+        mBinStarts[mEntries[k].first + 1]++;
+    }
+    for (unsigned bin=0; bin<mNumBinsX*mNumBinsY; bin++)
+    {
+        mBinStarts[bin + 1] += mBinStarts[bin];
+    }
+    mItems.resize(mEntries.size());
+    std::vector<unsigned> next(mBinStarts.begin(), mBinStarts.end() - 1);
+    for (unsigned k=0; k<mEntries.size(); k++)
+    {
+        mItems[next[mEntries[k].first]++] = mEntries[k].second;
+    }
+}
+
+PeriodicSpatialHash::ItemRange PeriodicSpatialHash::GetItemsNear(double x, double y) const
+{
+    unsigned bin = GetBinY(y)*mNumBinsX + GetBinX(x);
+    return ItemRange(mItems.begin() + mBinStarts[bin], mItems.begin() + mBinStarts[bin + 1]);
+}
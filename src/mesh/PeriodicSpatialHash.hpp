@@ -0,0 +1,142 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef PERIODICSPATIALHASH_HPP_
+#define PERIODICSPATIALHASH_HPP_
+
+#include <utility>
+#include <vector>
+
+/**
+ * A uniform grid of bins over a doubly periodic domain, such as that
+ * of a Toroidal2dVertexMesh, used to find the items (e.g. elements)
+ * whose bounding boxes may contain a given point without looping over
+ * every item.
+ *
+ * Items are added with AddBoundingBox(), which records the item in
+ * every bin its box overlaps (wrapping round the periodic
+ * boundaries), and Build() then packs the bins into one contiguous
+ * array. Within each bin the items are kept in the order in which
+ * they were added.
+ */
+class PeriodicSpatialHash
+{
+private:
+
+    /** Number of bins in x. */
+    unsigned mNumBinsX;
+
+    /** Number of bins in y. */
+    unsigned mNumBinsY;
+
+    /** Width of the periodic domain. */
+    double mWidth;
+
+    /** Height of the periodic domain. */
+    double mHeight;
+
+    /** The (bin, item) pairs added since the last call to Clear(). */
+    std::vector<std::pair<unsigned, unsigned> > mEntries;
+
+    /** The position in mItems of the first item of each bin, followed by the total number of items. */
+    std::vector<unsigned> mBinStarts;
+
+    /** The items of each bin, bin by bin. */
+    std::vector<unsigned> mItems;
+
+    /**
+     * @param x the x coordinate (need not lie within the domain)
+     * @return the column of bins containing x
+     */
+    unsigned GetBinX(double x) const;
+
+    /**
+     * @param y the y coordinate (need not lie within the domain)
+     * @return the row of bins containing y
+     */
+    unsigned GetBinY(double y) const;
+
+public:
+
+    /** A range of items. */
+    typedef std::pair<std::vector<unsigned>::const_iterator, std::vector<unsigned>::const_iterator> ItemRange;
+
+    /**
+     * Constructor.
+     *
+     * @param numBinsX number of bins in x
+     * @param numBinsY number of bins in y
+     * @param width width of the periodic domain
+     * @param height height of the periodic domain
+     */
+    PeriodicSpatialHash(unsigned numBinsX, unsigned numBinsY, double width, double height);
+
+    /**
+     * @return the total number of bins
+     */
+    unsigned GetNumBins() const;
+
+    /**
+     * Remove all the items.
+     */
+    void Clear();
+
+    /**
+     * Add an item to every bin overlapped by a bounding box. The box
+     * may extend outside the domain, in which case it wraps round.
+     *
+     * @param item the item
+     * @param xMin the left of the box
+     * @param xMax the right of the box
+     * @param yMin the bottom of the box
+     * @param yMax the top of the box
+     */
+    void AddBoundingBox(unsigned item, double xMin, double xMax, double yMin, double yMax);
+
+    /**
+     * Pack the items added since the last call to Clear() into their
+     * bins. Must be called before GetItemsNear().
+     */
+    void Build();
+
+    /**
+     * @param x the x coordinate (need not lie within the domain)
+     * @param y the y coordinate (need not lie within the domain)
+     * @return the items in the bin containing (x, y), including every
+     *     item whose bounding box contains (x, y)
+     */
+    ItemRange GetItemsNear(double x, double y) const;
+};
+
+#endif /*PERIODICSPATIALHASH_HPP_*/
@@ -0,0 +1,298 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "ReorderableToroidal2dVertexMesh.hpp"
+#include "HilbertCurve.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+ReorderableToroidal2dVertexMesh::ReorderableToroidal2dVertexMesh(double width,
+                                                                 double height,
+                                                                 std::vector<Node<2>*> nodes,
+                                                                 std::vector<VertexElement<2, 2>*> vertexElements,
+                                                                 double cellRearrangementThreshold,
+                                                                 double t2Threshold)
+    : Toroidal2dVertexMesh(width, height, nodes, vertexElements, cellRearrangementThreshold, t2Threshold),
+      mIntersectionCheckInterval(1),
+      mNumReMeshes(0),
+      mIntersectionCheckDue(true),
+      mpElementHash(nullptr),
+      mHalfEdgesUpToDate(false),
+      mIntersectionSwapPerformed(false)
+{
+}
+
+ReorderableToroidal2dVertexMesh::ReorderableToroidal2dVertexMesh()
+    : Toroidal2dVertexMesh(),
+      mIntersectionCheckInterval(1),
+      mNumReMeshes(0),
+      mIntersectionCheckDue(true),
+      mpElementHash(nullptr),
+      mHalfEdgesUpToDate(false),
+      mIntersectionSwapPerformed(false)
+{
+}
+
+ReorderableToroidal2dVertexMesh::~ReorderableToroidal2dVertexMesh()
+{
+    delete mpElementHash;
+}
+
+void ReorderableToroidal2dVertexMesh::ReMesh(VertexElementMap& rElementMap)
+{
+    // Record enough of the topology to tell whether ReMesh() changes
+    // it. Every swap changes the number of nodes of some element,
+    // except a T1 swap undone by another, which is caught by the
+    // record of T1 swap locations.
+    unsigned num_nodes_before = this->mNodes.size();
+    unsigned num_elements_before = this->mElements.size();
+    unsigned num_t1_swaps_before = this->mLocationsOfT1Swaps.size();
+    unsigned num_t3_swaps_before = this->mLocationsOfT3Swaps.size();
+    mElementSizesBeforeReMesh.resize(num_elements_before);
+    for (unsigned elem_index=0; elem_index<num_elements_before; elem_index++)
+    {
+        mElementSizesBeforeReMesh[elem_index] = this->mElements[elem_index]->GetNumNodes();
+    }
+    mIntersectionSwapPerformed = false;
+
+    mIntersectionCheckDue = (mNumReMeshes%mIntersectionCheckInterval == 0);
+    mNumReMeshes++;
+    Toroidal2dVertexMesh::ReMesh(rElementMap);
+    mIntersectionCheckDue = true;
+
+    bool topology_changed = mIntersectionSwapPerformed
+        || this->mNodes.size() != num_nodes_before
+        || this->mElements.size() != num_elements_before
+        || this->mLocationsOfT1Swaps.size() != num_t1_swaps_before
+        || this->mLocationsOfT3Swaps.size() != num_t3_swaps_before;
+    for (unsigned elem_index=0; !topology_changed && elem_index<num_elements_before; elem_index++)
+    {
+        topology_changed = (this->mElements[elem_index]->GetNumNodes() != mElementSizesBeforeReMesh[elem_index]);
+    }
+    if (topology_changed)
+    {
+        mHalfEdgesUpToDate = false;
+    }
+}
+
+const HalfEdgeMeshView& ReorderableToroidal2dVertexMesh::rGetHalfEdges()
+{
+    if (!mHalfEdgesUpToDate)
+    {
+        mHalfEdges.Update(*this);
+        mHalfEdgesUpToDate = true;
+    }
+    return mHalfEdges;
+}
+
+bool ReorderableToroidal2dVertexMesh::CheckForIntersections()
+{
+    if (!mCheckForInternalIntersections || !mIntersectionCheckDue)
+    {
+        return false;
+    }
+
+    // Bins of about one element each, so each node is tested against
+    // a handful of elements. The bounding boxes are padded so that
+    // rounding when wrapping round the domain cannot lose an element.
+    double width = GetWidth(0);
+    double height = GetWidth(1);
+    double spacing = sqrt(width*height/std::max(this->GetNumElements(), 1u));
+    unsigned num_bins_x = std::max(unsigned(width/spacing), 1u);
+    unsigned num_bins_y = std::max(unsigned(height/spacing), 1u);
+    if (mpElementHash == nullptr)
+    {
+        mpElementHash = new PeriodicSpatialHash(num_bins_x, num_bins_y, width, height);
+    }
+    else if (mpElementHash->GetNumBins() != num_bins_x*num_bins_y)
+    {
+        delete mpElementHash;
+        mpElementHash = new PeriodicSpatialHash(num_bins_x, num_bins_y, width, height);
+    }
+    mpElementHash->Clear();
+    double padding = this->mCellRearrangementThreshold;
+    for (VertexMesh<2, 2>::VertexElementIterator elem_iter = this->GetElementIteratorBegin();
+         elem_iter != this->GetElementIteratorEnd();
+         ++elem_iter)
+    {
+        const c_vector<double, 2>& r_first_location = elem_iter->GetNodeLocation(0);
+        c_vector<double, 2> lower = zero_vector<double>(2);
+        c_vector<double, 2> upper = zero_vector<double>(2);
+        for (unsigned local_index=1; local_index<elem_iter->GetNumNodes(); local_index++)
+        {
+            c_vector<double, 2> relative = this->GetVectorFromAtoB(r_first_location, elem_iter->GetNodeLocation(local_index));
+            for (unsigned i=0; i<2; i++)
+            {
+                lower[i] = std::min(lower[i], relative[i]);
+                upper[i] = std::max(upper[i], relative[i]);
+            }
+        }
+        mpElementHash->AddBoundingBox(elem_iter->GetIndex(),
+                                      r_first_location[0] + lower[0] - padding, r_first_location[0] + upper[0] + padding,
+                                      r_first_location[1] + lower[1] - padding, r_first_location[1] + upper[1] + padding);
+    }
+    mpElementHash->Build();
+
+    // Elements are added in index order, so the first element found
+    // for each node is the one the full check in MutableVertexMesh
+    // would find
+    for (AbstractMesh<2, 2>::NodeIterator node_iter = this->GetNodeIteratorBegin();
+         node_iter != this->GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        const c_vector<double, 2>& r_location = node_iter->rGetLocation();
+        PeriodicSpatialHash::ItemRange nearby = mpElementHash->GetItemsNear(r_location[0], r_location[1]);
+        for (std::vector<unsigned>::const_iterator elem_iter = nearby.first;
+             elem_iter != nearby.second;
+             ++elem_iter)
+        {
+            // Check that the node is not part of this element
+            if (node_iter->rGetContainingElementIndices().count(*elem_iter) == 0
+                && this->ElementIncludesPoint(r_location, *elem_iter))
+            {
+                PerformIntersectionSwap(&(*node_iter), *elem_iter);
+                mIntersectionSwapPerformed = true;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+unsigned ReorderableToroidal2dVertexMesh::GetIntersectionCheckInterval() const
+{
+    return mIntersectionCheckInterval;
+}
+
+void ReorderableToroidal2dVertexMesh::SetIntersectionCheckInterval(unsigned intersectionCheckInterval)
+{
+    if (intersectionCheckInterval == 0)
+    {
+        EXCEPTION("The intersection check interval must be at least 1");
+    }
+    mIntersectionCheckInterval = intersectionCheckInterval;
+}
+
+void ReorderableToroidal2dVertexMesh::PermuteNodesAndElements(const std::vector<unsigned>& rNodeOrder,
+                                                              const std::vector<unsigned>& rElementOrder)
+{
+    unsigned num_nodes = this->mNodes.size();
+    unsigned num_elements = this->mElements.size();
+    if (this->GetNumNodes() != num_nodes || this->GetNumElements() != num_elements)
+    {
+        EXCEPTION("Nodes and elements can only be renumbered after deleted ones have been removed by ReMesh()");
+    }
+    if (rNodeOrder.size() != num_nodes || rElementOrder.size() != num_elements)
+    {
+        EXCEPTION("A new order is needed for every node and element of the mesh");
+    }
+
+    // Each element re-registers with its nodes when its index is
+    // reset, so elements are first moved to indices that no element
+    // has yet (num_elements and above) and then to their new ones,
+    // so that an index is never held by two elements at once
+    std::vector<VertexElement<2, 2>*> elements(num_elements);
+    for (unsigned new_index=0; new_index<num_elements; new_index++)
+    {
+        elements[new_index] = this->mElements[rElementOrder[new_index]];
+        elements[new_index]->ResetIndex(num_elements + new_index);
+    }
+    for (unsigned new_index=0; new_index<num_elements; new_index++)
+    {
+        elements[new_index]->ResetIndex(new_index);
+    }
+    this->mElements.swap(elements);
+
+    // Elements refer to their nodes by pointer, so the nodes only
+    // need new indices
+    std::vector<Node<2>*> nodes(num_nodes);
+    for (unsigned new_index=0; new_index<num_nodes; new_index++)
+    {
+        nodes[new_index] = this->mNodes[rNodeOrder[new_index]];
+        nodes[new_index]->SetIndex(new_index);
+    }
+    this->mNodes.swap(nodes);
+    mHalfEdgesUpToDate = false;
+}
+
+std::vector<unsigned> ReorderableToroidal2dVertexMesh::ReorderAlongHilbertCurve()
+{
+    unsigned num_elements = this->mElements.size();
+    std::vector<double> centroid_x(num_elements);
+    std::vector<double> centroid_y(num_elements);
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        c_vector<double, 2> centroid = this->GetCentroidOfElement(elem_index);
+        centroid_x[elem_index] = centroid[0];
+        centroid_y[elem_index] = centroid[1];
+    }
+    std::vector<unsigned> element_order = HilbertCurve::GetOrder(centroid_x, centroid_y, this->GetWidth(0), this->GetWidth(1));
+
+    // Number the nodes as they are first met going round the elements
+    // in their new order
+    unsigned num_nodes = this->mNodes.size();
+    std::vector<unsigned> node_order;
+    node_order.reserve(num_nodes);
+    std::vector<bool> is_numbered(num_nodes, false);
+    for (unsigned i=0; i<num_elements; i++)
+    {
+        VertexElement<2, 2>* p_element = this->mElements[element_order[i]];
+        for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+        {
+            unsigned node_index = p_element->GetNodeGlobalIndex(local_index);
+            if (!is_numbered[node_index])
+            {
+                is_numbered[node_index] = true;
+                node_order.push_back(node_index);
+            }
+        }
+    }
+
+    // Keep any nodes that are not in an element, at the end
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        if (!is_numbered[node_index])
+        {
+            node_order.push_back(node_index);
+        }
+    }
+
+    PermuteNodesAndElements(node_order, element_order);
+    return element_order;
+}
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+CHASTE_CLASS_EXPORT(ReorderableToroidal2dVertexMesh)
@@ -0,0 +1,226 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef REORDERABLETOROIDAL2DVERTEXMESH_HPP_
+#define REORDERABLETOROIDAL2DVERTEXMESH_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "Toroidal2dVertexMesh.hpp"
+#include "PeriodicSpatialHash.hpp"
+#include "HalfEdgeMeshView.hpp"
+
+#include <vector>
+
+/**
+ * A toroidal vertex mesh whose nodes and elements can be renumbered,
+ * so that nodes and elements that are close together in space are
+ * close together in memory.
+ *
+ * ReorderAlongHilbertCurve() numbers the elements in the order of
+ * their centroids along a Hilbert curve, and the nodes in the order
+ * in which they are first met going round the renumbered elements.
+ * The loops over nodes and their containing elements in the forces
+ * then move steadily through memory rather than jumping around it,
+ * which they otherwise do increasingly as T1 swaps rearrange the
+ * cells. Since the mesh does not know about cells, the caller must
+ * update anything keyed by element index (such as the cell population's
+ * location indices) using the returned element order.
+ *
+ * The check for nodes that have moved inside other elements (enabled
+ * by SetCheckForInternalIntersections()) is restricted to the
+ * elements whose bounding boxes overlap a periodic spatial hash bin
+ * around each node, instead of every element, which makes it cheap
+ * enough to leave on. It finds the same node and element as the
+ * check in MutableVertexMesh and fixes it in the same way. It can
+ * also be made to run only every few calls to ReMesh().
+ *
+ * rGetHalfEdges() gives a half-edge view of the mesh, rebuilt when
+ * first asked for after any change to the topology.
+ */
+class ReorderableToroidal2dVertexMesh : public Toroidal2dVertexMesh
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the mesh.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<Toroidal2dVertexMesh>(*this);
+        archive & mIntersectionCheckInterval;
+    }
+
+    /**
+     * The internal intersection check is made on every
+     * mIntersectionCheckInterval-th call to ReMesh(). Defaults to 1.
+     */
+    unsigned mIntersectionCheckInterval;
+
+    /** The number of calls to ReMesh() so far. Not archived. */
+    unsigned mNumReMeshes;
+
+    /** Whether the current call to ReMesh() checks for internal intersections. */
+    bool mIntersectionCheckDue;
+
+    /** Spatial index of the elements, rebuilt for each intersection check. */
+    PeriodicSpatialHash* mpElementHash;
+
+    /** Half-edge view of the mesh. Not archived. */
+    HalfEdgeMeshView mHalfEdges;
+
+    /** Whether mHalfEdges matches the current topology. */
+    bool mHalfEdgesUpToDate;
+
+    /** Whether an intersection swap was performed in the current call to ReMesh(). */
+    bool mIntersectionSwapPerformed;
+
+    /**
+     * The number of nodes of each element at the start of the
+     * current call to ReMesh(), kept between calls to save
+     * reallocating. Not archived.
+     */
+    std::vector<unsigned> mElementSizesBeforeReMesh;
+
+protected:
+
+    /**
+     * Overridden CheckForIntersections() method, called repeatedly by
+     * ReMesh() until it returns false.
+     *
+     * If internal intersections are checked, find the first node (in
+     * index order) lying inside an element it does not belong to,
+     * testing only the elements near each node, and perform an
+     * intersection swap. A toroidal mesh has no boundary nodes, so
+     * there is nothing else to check.
+     *
+     * @return whether an intersection was found and fixed
+     */
+    virtual bool CheckForIntersections();
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param width the width of the periodic domain
+     * @param height the height of the periodic domain
+     * @param nodes vector of pointers to nodes
+     * @param vertexElements vector of pointers to VertexElements
+     * @param cellRearrangementThreshold the minimum threshold distance for element rearrangement (defaults to 0.01)
+     * @param t2Threshold the maximum threshold distance for Type 2 swaps (defaults to 0.001)
+     */
+    ReorderableToroidal2dVertexMesh(double width,
+                                    double height,
+                                    std::vector<Node<2>*> nodes,
+                                    std::vector<VertexElement<2, 2>*> vertexElements,
+                                    double cellRearrangementThreshold=0.01,
+                                    double t2Threshold=0.001);
+
+    /**
+     * Default constructor for use by serializer.
+     */
+    ReorderableToroidal2dVertexMesh();
+
+    /**
+     * Destructor.
+     */
+    virtual ~ReorderableToroidal2dVertexMesh();
+
+    using Toroidal2dVertexMesh::ReMesh;
+
+    /**
+     * Overridden ReMesh() method, which counts the calls so that the
+     * internal intersection check is made every
+     * mIntersectionCheckInterval calls. The half-edge view is marked
+     * out of date only if the topology changed: if a T1, T2, T3 or
+     * intersection swap was performed, or if nodes or elements were
+     * removed.
+     *
+     * @param rElementMap a VertexElementMap which associates the indices of VertexElements in the old mesh
+     *                    with indices of VertexElements in the new mesh
+     */
+    virtual void ReMesh(VertexElementMap& rElementMap);
+
+    /**
+     * @return the half-edge view of the mesh, rebuilt first if the
+     *     topology has changed since it was last built
+     */
+    const HalfEdgeMeshView& rGetHalfEdges();
+
+    /**
+     * @return mIntersectionCheckInterval
+     */
+    unsigned GetIntersectionCheckInterval() const;
+
+    /**
+     * Set mIntersectionCheckInterval.
+     *
+     * @param intersectionCheckInterval the new value of mIntersectionCheckInterval (at least 1)
+     */
+    void SetIntersectionCheckInterval(unsigned intersectionCheckInterval);
+
+    /**
+     * Renumber the nodes and elements.
+     *
+     * The mesh must not contain deleted nodes or elements, i.e. this
+     * must be called after ReMesh() and before any further changes.
+     *
+     * @param rNodeOrder the current index of the node to be given each new index
+     * @param rElementOrder the current index of the element to be given each new index
+     */
+    void PermuteNodesAndElements(const std::vector<unsigned>& rNodeOrder,
+                                 const std::vector<unsigned>& rElementOrder);
+
+    /**
+     * Renumber the elements along a Hilbert curve through their
+     * centroids, and the nodes in the order in which the renumbered
+     * elements first contain them.
+     *
+     * @return the previous index of the element given each new index
+     */
+    std::vector<unsigned> ReorderAlongHilbertCurve();
+};
+
+#include "SerializationExportWrapper.hpp"
+CHASTE_CLASS_EXPORT(ReorderableToroidal2dVertexMesh)
+
+#endif /*REORDERABLETOROIDAL2DVERTEXMESH_HPP_*/
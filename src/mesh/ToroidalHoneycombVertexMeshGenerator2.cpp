@@ -55,32 +55,65 @@ ToroidalHoneycombVertexMeshGenerator2::ToroidalHoneycombVertexMeshGenerator2(uns
     assert(cellRearrangementThreshold > 0.0);
     assert(t2Threshold > 0.0);
 
+    // The mesh takes ownership of the nodes and elements and deletes
+    // them individually (including during T2 swaps), so each must be
+    // allocated on its own. Everything else is sized up front so that
+    // large meshes are not slowed down by reallocation.
+    unsigned num_nodes = 2*numElementsAcross*numElementsUp;
+    unsigned num_elements = numElementsAcross*numElementsUp;
     std::vector<Node<2>*> nodes;
     std::vector<VertexElement<2,2>*>  elements;
+    nodes.reserve(num_nodes);
+    elements.reserve(num_elements);
 
     unsigned node_index = 0;
     unsigned node_indices[6];
     unsigned element_index;
 
+    // Constants of the node coordinates, computed once (the
+    // coordinates are evaluated in the same order as before so that
+    // meshes are reproduced exactly)
+    double sqrt_two = sqrt(2.0);
+    double sqrt_three = sqrt(3.0);
+    double fourth_root_three = sqrt(sqrt_three);
+    double sqrt_cell_area = sqrt(cellArea);
+
+    // Small random noise for the mesh coordinates, drawn in one batch
+    // in the same order (x then y for each node) as node by node so
+    // that seeded meshes are unchanged
+    std::vector<double> noise;
+    if (noiseSD > 0)
+    {
+        noise.resize(2*num_nodes);
+        RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+        double noise_sd = noiseSD*sqrt_cell_area;
+        for (unsigned k=0; k<noise.size(); k++)
+        {
+            noise[k] = p_gen->NormalRandomDeviate(0.0, noise_sd);
+        }
+    }
+
     // Create the nodes
     for (unsigned j=0; j<2*numElementsUp; j++)
     {
+        double y_coord = (1.5*j - 0.5*(j%2))*0.5/sqrt_three;
+
+        // Modified to have unit cell areas (i.e. total area equal to number of cells)
+        y_coord = ( y_coord * sqrt_two / fourth_root_three ) * sqrt_cell_area;
         for (unsigned i=0; i<numElementsAcross; i++)
         {
             double x_coord = ((j%4 == 0)||(j%4 == 3)) ? i+0.5 : i;
-            double y_coord = (1.5*j - 0.5*(j%2))*0.5/sqrt(3.0);
-
-	    // Modified to have unit cell areas (i.e. total area equal to number of cells)
-	    x_coord = ( x_coord * sqrt(2.0) / sqrt(sqrt(3.0)) ) * sqrt(cellArea);
-	    y_coord = ( y_coord * sqrt(2.0) / sqrt(sqrt(3.0)) ) * sqrt(cellArea);
+            x_coord = ( x_coord * sqrt_two / fourth_root_three ) * sqrt_cell_area;
+            double node_y_coord = y_coord;
 
-	    // Add small random noise to the mesh coordinates
-	    if (noiseSD > 0) {
-	      x_coord += RandomNumberGenerator::Instance()->NormalRandomDeviate(0.0, noiseSD*sqrt(cellArea));
-	      y_coord += RandomNumberGenerator::Instance()->NormalRandomDeviate(0.0, noiseSD*sqrt(cellArea));
-	    }
+            // Add small random noise to the mesh coordinates
+            if (noiseSD > 0)
+            {
+                x_coord += noise[2*node_index];
+                node_y_coord += noise[2*node_index+1];
+            }
 
-            Node<2>* p_node = new Node<2>(node_index, false , x_coord, y_coord);
+            Node<2>* p_node = new Node<2>(node_index, false , x_coord, node_y_coord);
             nodes.push_back(p_node);
             node_index++;
         }
@@ -88,8 +121,11 @@ ToroidalHoneycombVertexMeshGenerator2::ToroidalHoneycombVertexMeshGenerator2(uns
 
     /*
      * Create the elements. The array node_indices contains the
-     * global node indices from bottom, going anticlockwise.
+     * global node indices from bottom, going anticlockwise. The
+     * element copies its nodes, so one buffer is reused for all of
+     * them.
      */
+    std::vector<Node<2>*> element_nodes(6);
     for (unsigned j=0; j<numElementsUp; j++)
     {
         for (unsigned i=0; i<numElementsAcross; i++)
@@ -117,10 +153,9 @@ ToroidalHoneycombVertexMeshGenerator2::ToroidalHoneycombVertexMeshGenerator2(uns
                 node_indices[4] -= 2*numElementsAcross*numElementsUp;
             }
 
-            std::vector<Node<2>*> element_nodes;
             for (unsigned k=0; k<6; k++)
             {
-               element_nodes.push_back(nodes[node_indices[k]]);
+               element_nodes[k] = nodes[node_indices[k]];
             }
             VertexElement<2,2>* p_element = new VertexElement<2,2>(element_index, element_nodes);
             elements.push_back(p_element);
@@ -132,7 +167,7 @@ ToroidalHoneycombVertexMeshGenerator2::ToroidalHoneycombVertexMeshGenerator2(uns
     double mesh_height = ( sqrt(sqrt(3.0)) / sqrt(2.0) ) * numElementsUp * sqrt(cellArea);
 
 
-    mpMesh = new Toroidal2dVertexMesh(mesh_width, mesh_height, nodes, elements, cellRearrangementThreshold, t2Threshold);
+    mpMesh = new ReorderableToroidal2dVertexMesh(mesh_width, mesh_height, nodes, elements, cellRearrangementThreshold, t2Threshold);
 }
 
 MutableVertexMesh<2,2>* ToroidalHoneycombVertexMeshGenerator2::GetMesh()
@@ -141,7 +176,7 @@ MutableVertexMesh<2,2>* ToroidalHoneycombVertexMeshGenerator2::GetMesh()
     return mpMesh; // Not really
 }
 
-Toroidal2dVertexMesh* ToroidalHoneycombVertexMeshGenerator2::GetToroidalMesh()
+ReorderableToroidal2dVertexMesh* ToroidalHoneycombVertexMeshGenerator2::GetToroidalMesh()
 {
-    return (Toroidal2dVertexMesh*) mpMesh;
+    return (ReorderableToroidal2dVertexMesh*) mpMesh;
 }
@@ -40,14 +40,15 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <vector>
 
 #include "HoneycombVertexMeshGenerator.hpp"
-#include "Toroidal2dVertexMesh.hpp"
+#include "ReorderableToroidal2dVertexMesh.hpp"
 
 /**
  * Honeycomb mesh generator that creates a 2D "toroidal" mesh (one in
  * which periodicity is imposed on the left and right and top and
  * bottom boundaries) for use with vertex-based simulations. Here we
  * modify the original class so that cells are regular hexagons with
- * unit area.
+ * unit area. The mesh is a ReorderableToroidal2dVertexMesh, so its
+ * nodes and elements can be renumbered for locality.
  *
  * NOTE: the user should delete the mesh after use to manage memory.
  */
@@ -77,7 +78,7 @@ public:
     /**
      * @return a 2D honeycomb mesh with periodic left/right and top/bottom boundaries
      */
-    Toroidal2dVertexMesh* GetToroidalMesh();
+    ReorderableToroidal2dVertexMesh* GetToroidalMesh();
 };
 
 #endif /*TOROIDALHONEYCOMBVERTEXMESHGENERATOR2_HPP_*/
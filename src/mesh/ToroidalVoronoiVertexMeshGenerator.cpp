@@ -0,0 +1,331 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "ToroidalVoronoiVertexMeshGenerator.hpp"
+#include "Exception.hpp"
+#include "RandomNumberGenerator.hpp"
+
+#include <boost/polygon/voronoi.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <map>
+#include <stdint.h>
+
+ToroidalVoronoiVertexMeshGenerator::ToroidalVoronoiVertexMeshGenerator(unsigned numElementsAcross,
+                                                                       unsigned numElementsUp,
+                                                                       double cellArea,
+                                                                       unsigned numRelaxationSteps,
+                                                                       double cellRearrangementThreshold,
+                                                                       double t2Threshold)
+    : mpMesh(nullptr)
+{
+    if (numElementsAcross < 4 || numElementsUp < 4)
+    {
+        EXCEPTION("A toroidal Voronoi mesh needs at least 4 cells across and up");
+    }
+    assert(cellArea > 0.0);
+    assert(cellRearrangementThreshold > 0.0);
+    assert(t2Threshold > 0.0);
+
+    // The same domain as a honeycomb of regular hexagons with this
+    // number of cells and cell area
+    mWidth = ( sqrt(2.0) / sqrt(sqrt(3.0)) ) * numElementsAcross * sqrt(cellArea);
+    mHeight = ( sqrt(sqrt(3.0)) / sqrt(2.0) ) * numElementsUp * sqrt(cellArea);
+
+    // Random seeds, one per cell
+    unsigned num_cells = numElementsAcross*numElementsUp;
+    std::vector<c_vector<double, 2> > seeds(num_cells);
+    RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+    for (unsigned i=0; i<num_cells; i++)
+    {
+        seeds[i][0] = p_gen->ranf()*mWidth;
+        seeds[i][1] = p_gen->ranf()*mHeight;
+    }
+
+    // Build the tessellation, moving the seeds to the centroids of
+    // their cells between the Lloyd relaxation steps. The margin of
+    // periodic images starts at a few cell diameters, which almost
+    // always suffices.
+    double margin = 4.0*sqrt(cellArea);
+    std::vector<c_vector<double, 2> > node_locations;
+    std::vector<std::vector<unsigned> > element_nodes;
+    std::vector<c_vector<double, 2> > centroids;
+    for (unsigned step=0; step<=numRelaxationSteps; step++)
+    {
+        while (!ComputeTessellation(seeds, margin, node_locations, element_nodes, centroids))
+        {
+            if (margin >= std::min(mWidth, mHeight))
+            {
+                EXCEPTION("Could not build a consistent periodic Voronoi tessellation; try more cells");
+            }
+            margin = std::min(2.0*margin, std::min(mWidth, mHeight));
+        }
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            seeds[i][0] = centroids[i][0] - mWidth*floor(centroids[i][0]/mWidth);
+            seeds[i][1] = centroids[i][1] - mHeight*floor(centroids[i][1]/mHeight);
+        }
+    }
+
+    // Create the nodes and elements. The mesh takes ownership of them.
+    std::vector<Node<2>*> nodes(node_locations.size());
+    for (unsigned node_index=0; node_index<nodes.size(); node_index++)
+    {
+        nodes[node_index] = new Node<2>(node_index, false, node_locations[node_index][0], node_locations[node_index][1]);
+    }
+    std::vector<VertexElement<2,2>*> elements(num_cells);
+    std::vector<Node<2>*> nodes_of_element;
+    for (unsigned elem_index=0; elem_index<num_cells; elem_index++)
+    {
+        nodes_of_element.resize(element_nodes[elem_index].size());
+        for (unsigned k=0; k<nodes_of_element.size(); k++)
+        {
+            nodes_of_element[k] = nodes[element_nodes[elem_index][k]];
+        }
+        elements[elem_index] = new VertexElement<2,2>(elem_index, nodes_of_element);
+    }
+
+    mpMesh = new ReorderableToroidal2dVertexMesh(mWidth, mHeight, nodes, elements, cellRearrangementThreshold, t2Threshold);
+}
+
+ToroidalVoronoiVertexMeshGenerator::~ToroidalVoronoiVertexMeshGenerator()
+{
+    delete mpMesh;
+}
+
+ReorderableToroidal2dVertexMesh* ToroidalVoronoiVertexMeshGenerator::GetToroidalMesh()
+{
+    return mpMesh;
+}
+
+bool ToroidalVoronoiVertexMeshGenerator::ComputeTessellation(const std::vector<c_vector<double, 2> >& rSeeds,
+                                                             double margin,
+                                                             std::vector<c_vector<double, 2> >& rNodeLocations,
+                                                             std::vector<std::vector<unsigned> >& rElementNodes,
+                                                             std::vector<c_vector<double, 2> >& rCentroids)
+{
+    typedef boost::polygon::voronoi_diagram<double> diagram_type;
+    unsigned num_seeds = rSeeds.size();
+
+    // boost::polygon needs integer coordinates. The scales are chosen
+    // so that the domain is a whole number of grid spacings across
+    // and up, so periodic images are exact translates of their seeds.
+    double grid_size = 536870912.0/(std::max(mWidth, mHeight) + margin);    // 2^29 spacings
+    int64_t width_in_grid = int64_t(mWidth*grid_size);
+    int64_t height_in_grid = int64_t(mHeight*grid_size);
+    double x_scale = width_in_grid/mWidth;
+    double y_scale = height_in_grid/mHeight;
+
+    // The seeds and their periodic images within the margin, with the
+    // seed and image offset each comes from
+    std::vector<boost::polygon::point_data<int> > points;
+    std::vector<unsigned> point_seeds;
+    std::vector<int> point_offsets_x;
+    std::vector<int> point_offsets_y;
+    points.reserve(2*num_seeds);
+    point_seeds.reserve(2*num_seeds);
+    point_offsets_x.reserve(2*num_seeds);
+    point_offsets_y.reserve(2*num_seeds);
+    for (int offset_y=-1; offset_y<=1; offset_y++)
+    {
+        for (int offset_x=-1; offset_x<=1; offset_x++)
+        {
+            for (unsigned i=0; i<num_seeds; i++)
+            {
+                double x = rSeeds[i][0] + offset_x*mWidth;
+                double y = rSeeds[i][1] + offset_y*mHeight;
+                if (x < -margin || x > mWidth + margin || y < -margin || y > mHeight + margin)
+                {
+                    continue;
+                }
+                int64_t grid_x = int64_t(rSeeds[i][0]*x_scale) + offset_x*width_in_grid;
+                int64_t grid_y = int64_t(rSeeds[i][1]*y_scale) + offset_y*height_in_grid;
+                points.push_back(boost::polygon::point_data<int>(int(grid_x), int(grid_y)));
+                point_seeds.push_back(i);
+                point_offsets_x.push_back(offset_x);
+                point_offsets_y.push_back(offset_y);
+            }
+        }
+    }
+
+    diagram_type diagram;
+    boost::polygon::construct_voronoi(points.begin(), points.end(), &diagram);
+
+    /*
+     * A Voronoi vertex next to a periodic image is identified, up to a
+     * periodic translation, by the seeds around it and their image
+     * offsets relative to the smallest of them. Each is encoded as
+     * seed*25 + (dx+2)*5 + (dy+2) with the relative offsets dx, dy in -2..2.
+     */
+    std::map<std::vector<uint64_t>, unsigned> node_indices;
+    std::vector<unsigned> num_references;
+    std::vector<unsigned> num_seeds_around;
+    rNodeLocations.clear();
+    rElementNodes.assign(num_seeds, std::vector<unsigned>());
+    rCentroids.assign(num_seeds, zero_vector<double>(2));
+    unsigned num_cells_found = 0;
+    std::vector<uint64_t> key;
+    for (diagram_type::const_cell_iterator cell_iter = diagram.cells().begin();
+         cell_iter != diagram.cells().end();
+         ++cell_iter)
+    {
+        std::size_t point_index = cell_iter->source_index();
+        if (point_offsets_x[point_index] != 0 || point_offsets_y[point_index] != 0)
+        {
+            continue;    // An image; its seed's own cell is used instead
+        }
+        unsigned seed = point_seeds[point_index];
+        num_cells_found++;
+
+        // Go anticlockwise round the cell
+        double area = 0.0;
+        c_vector<double, 2> first_moment = zero_vector<double>(2);
+        const diagram_type::edge_type* p_edge = cell_iter->incident_edge();
+        do
+        {
+            const diagram_type::vertex_type* p_vertex = p_edge->vertex0();
+            const diagram_type::vertex_type* p_next_vertex = p_edge->vertex1();
+            if (p_vertex == nullptr || p_next_vertex == nullptr)
+            {
+                return false;    // Unbounded cell: the margin is too narrow
+            }
+
+            double x = p_vertex->x()/x_scale;
+            double y = p_vertex->y()/y_scale;
+
+            // Each diagram vertex caches its node index (plus one) in its colour
+            if (p_vertex->color() == 0)
+            {
+                // The seeds around the vertex, relative to the smallest
+                key.clear();
+                bool is_interior = true;
+                const diagram_type::edge_type* p_vertex_edge = p_vertex->incident_edge();
+                std::size_t smallest = p_vertex_edge->cell()->source_index();
+                do
+                {
+                    std::size_t index = p_vertex_edge->cell()->source_index();
+                    is_interior = is_interior && point_offsets_x[index] == 0 && point_offsets_y[index] == 0;
+                    if (std::make_pair(point_seeds[index], std::make_pair(point_offsets_x[index], point_offsets_y[index]))
+                        < std::make_pair(point_seeds[smallest], std::make_pair(point_offsets_x[smallest], point_offsets_y[smallest])))
+                    {
+                        smallest = index;
+                    }
+                    key.push_back(index);
+                    p_vertex_edge = p_vertex_edge->rot_next();
+                }
+                while (p_vertex_edge != p_vertex->incident_edge());
+
+                unsigned num_around = key.size();
+                unsigned new_node_index = rNodeLocations.size();
+                if (!is_interior)
+                {
+                    // Images of the vertex are found in other cells, so
+                    // match them up by their (translation invariant) key
+                    for (unsigned k=0; k<num_around; k++)
+                    {
+                        std::size_t index = key[k];
+                        key[k] = uint64_t(point_seeds[index])*25
+                                 + (point_offsets_x[index] - point_offsets_x[smallest] + 2)*5
+                                 + (point_offsets_y[index] - point_offsets_y[smallest] + 2);
+                    }
+                    std::sort(key.begin(), key.end());
+                    for (unsigned k=1; k<num_around; k++)
+                    {
+                        if (key[k]/25 == key[k-1]/25)
+                        {
+                            EXCEPTION("A Voronoi cell borders its own periodic image; try more cells");
+                        }
+                    }
+                    new_node_index = node_indices.insert(std::make_pair(key, new_node_index)).first->second;
+                }
+
+                // Create the node, inside the domain
+                if (new_node_index == rNodeLocations.size())
+                {
+                    c_vector<double, 2> location;
+                    location[0] = x - mWidth*floor(x/mWidth);
+                    location[1] = y - mHeight*floor(y/mHeight);
+                    rNodeLocations.push_back(location);
+                    num_references.push_back(0);
+                    num_seeds_around.push_back(num_around);
+                }
+                p_vertex->color(new_node_index + 1);
+            }
+            unsigned node_index = p_vertex->color() - 1;
+            num_references[node_index]++;
+            rElementNodes[seed].push_back(node_index);
+
+            // Accumulate the area and centroid of the cell
+            double next_x = p_next_vertex->x()/x_scale;
+            double next_y = p_next_vertex->y()/y_scale;
+            if (fabs(next_x - x) >= 0.5*mWidth || fabs(next_y - y) >= 0.5*mHeight)
+            {
+                // Either the margin is too narrow or the cell is too
+                // large for the mesh to find its edges by the nearest
+                // periodic image
+                return false;
+            }
+            double cross = x*next_y - next_x*y;
+            area += 0.5*cross;
+            first_moment[0] += (x + next_x)*cross/6.0;
+            first_moment[1] += (y + next_y)*cross/6.0;
+
+            p_edge = p_edge->next();
+        }
+        while (p_edge != cell_iter->incident_edge());
+
+        if (area <= 0.0)
+        {
+            return false;
+        }
+        rCentroids[seed] = first_moment/area;
+    }
+    if (num_cells_found != num_seeds)
+    {
+        EXCEPTION("Two Voronoi seeds coincide");
+    }
+
+    // Every node must be a corner of each cell around it, otherwise
+    // some cell near the boundary missed a periodic image
+    for (unsigned node_index=0; node_index<num_references.size(); node_index++)
+    {
+        if (num_references[node_index] != num_seeds_around[node_index])
+        {
+            return false;
+        }
+    }
+    return true;
+}
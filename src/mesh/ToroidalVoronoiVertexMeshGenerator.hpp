@@ -0,0 +1,121 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef TOROIDALVORONOIVERTEXMESHGENERATOR_HPP_
+#define TOROIDALVORONOIVERTEXMESHGENERATOR_HPP_
+
+#include <vector>
+
+#include "ReorderableToroidal2dVertexMesh.hpp"
+#include "UblasVectorInclude.hpp"
+
+/**
+ * Generator of a disordered 2D "toroidal" vertex mesh (periodic on the
+ * left and right and top and bottom boundaries) from the periodic
+ * Voronoi tessellation of random seed points, optionally relaxed
+ * towards a centroidal Voronoi tessellation by Lloyd's algorithm.
+ *
+ * The domain has the same size as the honeycomb of
+ * ToroidalHoneycombVertexMeshGenerator2 with the same number of cells
+ * and cell area, so the mean cell area is cellArea, but any number of
+ * cells across and up may be used. The tessellation is built with the
+ * O(N log N) sweepline algorithm of boost::polygon, from the seeds and
+ * those of their periodic images that lie within a margin of the
+ * domain. Voronoi vertices are matched across the periodic boundaries
+ * by the seeds (and image offsets) around them, and the margin is
+ * widened and the tessellation rebuilt if any cell is not closed
+ * consistently.
+ *
+ * NOTE: the generator owns the mesh and deletes it when it is destroyed.
+ */
+class ToroidalVoronoiVertexMeshGenerator
+{
+private:
+
+    /** The mesh. */
+    ReorderableToroidal2dVertexMesh* mpMesh;
+
+    /** The width of the domain. */
+    double mWidth;
+
+    /** The height of the domain. */
+    double mHeight;
+
+    /**
+     * Compute the periodic Voronoi tessellation of the seeds.
+     *
+     * @param rSeeds the seed points, inside the domain
+     * @param margin the distance from the domain within which periodic images of seeds are included
+     * @param rNodeLocations filled with the location of each Voronoi vertex, inside the domain
+     * @param rElementNodes filled with the Voronoi vertices of each seed's cell, anticlockwise
+     * @param rCentroids filled with the centroid of each seed's cell (possibly outside the domain)
+     * @return whether the margin was wide enough for every cell to be closed consistently
+     */
+    bool ComputeTessellation(const std::vector<c_vector<double, 2> >& rSeeds,
+                             double margin,
+                             std::vector<c_vector<double, 2> >& rNodeLocations,
+                             std::vector<std::vector<unsigned> >& rElementNodes,
+                             std::vector<c_vector<double, 2> >& rCentroids);
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param numElementsAcross the number of cells across the mesh (at least 4)
+     * @param numElementsUp the number of cells up the mesh (at least 4)
+     * @param cellArea the mean cell area (defaults to 1.0)
+     * @param numRelaxationSteps the number of Lloyd relaxation steps (defaults to 0)
+     * @param cellRearrangementThreshold the minimum threshold distance for element rearrangement (defaults to 0.01)
+     * @param t2Threshold the maximum threshold distance for Type 2 swaps (defaults to 0.001)
+     */
+    ToroidalVoronoiVertexMeshGenerator(unsigned numElementsAcross,
+                                       unsigned numElementsUp,
+                                       double cellArea=1.0,
+                                       unsigned numRelaxationSteps=0,
+                                       double cellRearrangementThreshold=0.01,
+                                       double t2Threshold=0.001);
+
+    /**
+     * Destructor. Deletes the mesh.
+     */
+    virtual ~ToroidalVoronoiVertexMeshGenerator();
+
+    /**
+     * @return a 2D Voronoi mesh with periodic left/right and top/bottom boundaries
+     */
+    ReorderableToroidal2dVertexMesh* GetToroidalMesh();
+};
+
+#endif /*TOROIDALVORONOIVERTEXMESHGENERATOR_HPP_*/
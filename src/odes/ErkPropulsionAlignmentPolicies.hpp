@@ -0,0 +1,78 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef ERKPROPULSIONALIGNMENTPOLICIES_HPP_
+#define ERKPROPULSIONALIGNMENTPOLICIES_HPP_
+
+/**
+ * Alignment policies for the ErkPropulsionOdeSystem,
+ * ErkPropulsionSrnModel and ErkPropulsionModifier templates.
+ *
+ * A policy decides whether the self propulsion angle theta relaxes
+ * towards an alignment angle theta_vi, d[theta]/dt += K*sin(theta_vi - theta),
+ * and how the modifier computes theta_vi. Policies are empty tag
+ * types, so everything they switch off is removed at compile time.
+ */
+
+/**
+ * No alignment: theta performs a persistent random walk.
+ */
+struct NoAlignment
+{
+    /** Whether theta relaxes towards an alignment angle. */
+    static const bool ALIGNS = false;
+};
+
+/**
+ * Alignment with the cell's own velocity: theta_vi is the direction
+ * of the cell centroid's displacement over the last time step.
+ */
+struct VelocityAlignment
+{
+    /** Whether theta relaxes towards an alignment angle. */
+    static const bool ALIGNS = true;
+};
+
+/**
+ * Vicsek-style alignment with the neighbours: theta_vi is the
+ * direction of the mean polarity (or, optionally, velocity) of the
+ * cells sharing an edge with the cell.
+ */
+struct NeighbourAlignment
+{
+    /** Whether theta relaxes towards an alignment angle. */
+    static const bool ALIGNS = true;
+};
+
+#endif /*ERKPROPULSIONALIGNMENTPOLICIES_HPP_*/
@@ -0,0 +1,213 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "ErkPropulsionOdeSystemNoAlignment.hpp"
+#include "ErkPropulsionOdeSystemVelocityAlignment.hpp"
+#include "ErkPropulsionOdeSystemNeighbourAlignment.hpp"
+#include "CellwiseOdeSystemInformation.hpp"
+
+template<class ALIGNMENT>
+ErkPropulsionOdeSystem<ALIGNMENT>::ErkPropulsionOdeSystem(std::vector<double> stateVariables)
+  : AbstractOdeSystem(3)    // with n=3 variables
+{
+    mpSystemInfo.reset(new CellwiseOdeSystemInformation<ErkPropulsionOdeSystem<ALIGNMENT> >);
+
+    /**
+     * The state variables are as follows:
+     *
+     * 0 - Self propulsion angle theta for this cell
+     * 1 - Erk activity for this cell
+     * 2 - Rest area for this cell
+     *
+     * We store the last state variable so that it can be written
+     * to file at each time step alongside the others, and visualized.
+     */
+
+    SetDefaultInitialCondition(1, 1.0); // soon overwritten    // Theta (propulsion angle)
+    SetDefaultInitialCondition(1, 1.0); // soon overwritten    // Erk
+    SetDefaultInitialCondition(1, 1.0); // soon overwritten    // Target Area
+
+    this->mParameters.push_back(1.0);    // Default cell area. Soon overwritten
+    this->mParameters.push_back(1.0);    // Default taul. Soon overwritten
+    this->mParameters.push_back(1.0);    // Default alpha. Soon overwritten
+    this->mParameters.push_back(1.0);    // Default beta. Soon overwritten
+    this->mParameters.push_back(0.1);    // Default Eta Std. Soon overwritten
+    this->mParameters.push_back(0.01);    // Default dt_ode. Soon overwritten
+
+    if (ALIGNMENT::ALIGNS)
+    {
+        this->mParameters.push_back(0.0);    // Default alignment angle theta_vi
+        this->mParameters.push_back(0.0);    // Default strength of alignment K
+    }
+
+    if (stateVariables != std::vector<double>())
+    {
+        SetStateVariables(stateVariables);
+    }
+}
+
+template<class ALIGNMENT>
+ErkPropulsionOdeSystem<ALIGNMENT>::~ErkPropulsionOdeSystem()
+{
+}
+
+template<class ALIGNMENT>
+void ErkPropulsionOdeSystem<ALIGNMENT>::EvaluateYDerivatives(double time, const std::vector<double>& rY, std::vector<double>& rDY)
+{
+  double theta = rY[0];    // Angle of self-propulsion
+  double erk = rY[1];
+  double target_area = rY[2];
+  double area = this->mParameters[CELL_AREA];
+
+  double taul = this->mParameters[TAUL];
+  double a = this->mParameters[ALPHA];
+  double b = this->mParameters[BETA];
+  double eta_std = this->mParameters[ETA_STD];    // persistence time is equal to sqrt(1/eta_std)
+  // TODO Figure out how to access the dt of the ode/srn model and use
+  // that instead of assigning to each cell's CellData.
+  double dt_ode = this->mParameters[DT_ODE];
+
+  // Random kicks in angle. Stochastic differential equation so dtheta
+  // should scale like sqrt(dt/tp) -> dtheta/dt needs to be multiplied
+  // by 1/sqrt(tp*dt) here. The factor of sqrt(2) ensures the correct
+  // persistence time tp = 2/<eta^2> - see eq4 in Boocock et al (2023)
+  // 10.1101/2023.03.24.534111.
+  rDY[0] = eta_std*sqrt(2)*sqrt(1/dt_ode)*(RandomNumberGenerator::Instance()->StandardNormalRandomDeviate());    // d[theta]/dt
+
+  if (ALIGNMENT::ALIGNS)
+  {
+      double theta_vi = this->mParameters[ALIGNMENT_ANGLE];    // Angle to align with
+      double K = this->mParameters[ALIGNMENT_STRENGTH];    // Strength of alignment K*sin(theta_vi - theta_i)
+      rDY[0] += K*sin(theta_vi - theta);
+  }
+
+  // -E^3 stabilizing non-linearity
+  rDY[1] = -erk - pow(erk, 3.0) + b*(area-1.0);    // d[Erk]/dt
+  rDY[2] = ((1.0-target_area) - a*erk) / taul;    // d[TargetArea]/dt
+}
+
+/**
+ * Fill in the names, units and initial conditions shared by the
+ * CellwiseOdeSystemInformation of every ErkPropulsionOdeSystem.
+ *
+ * @param rVariableNames the state variable names
+ * @param rVariableUnits the state variable units
+ * @param rInitialConditions the default initial conditions
+ * @param rParameterNames the parameter names
+ * @param rParameterUnits the parameter units
+ */
+template<class ALIGNMENT>
+void InitialiseErkPropulsionOdeSystemInformation(std::vector<std::string>& rVariableNames,
+                                                 std::vector<std::string>& rVariableUnits,
+                                                 std::vector<double>& rInitialConditions,
+                                                 std::vector<std::string>& rParameterNames,
+                                                 std::vector<std::string>& rParameterUnits)
+{
+    rVariableNames.push_back("Theta");
+    rVariableUnits.push_back("non-dim");
+    rInitialConditions.push_back(0.0); // will be filled in later
+
+    rVariableNames.push_back("Erk");
+    rVariableUnits.push_back("non-dim");
+    rInitialConditions.push_back(0.0); // will be filled in later
+
+    rVariableNames.push_back("Target Area");
+    rVariableUnits.push_back("non-dim");
+    rInitialConditions.push_back(0.0); // will be filled in later
+
+    // If this is ever not the first parameter change the line
+    rParameterNames.push_back("Cell Area");
+    rParameterUnits.push_back("non-dim");
+
+    rParameterNames.push_back("taul");
+    rParameterUnits.push_back("non-dim");
+
+    rParameterNames.push_back("alpha");
+    rParameterUnits.push_back("non-dim");
+
+    rParameterNames.push_back("beta");
+    rParameterUnits.push_back("non-dim");
+
+    rParameterNames.push_back("Eta Std");
+    rParameterUnits.push_back("non-dim");
+
+    rParameterNames.push_back("dt_ode");
+    rParameterUnits.push_back("non-dim");
+
+    if (ALIGNMENT::ALIGNS)
+    {
+        // Angle to align with
+        rParameterNames.push_back("theta_vi");
+        rParameterUnits.push_back("non-dim");
+
+        // Strength of alignment K*sin(theta_vi - theta_i)
+        rParameterNames.push_back("K");
+        rParameterUnits.push_back("non-dim");
+    }
+}
+
+template<>
+void CellwiseOdeSystemInformation<ErkPropulsionOdeSystemNoAlignment>::Initialise()
+{
+    InitialiseErkPropulsionOdeSystemInformation<NoAlignment>(this->mVariableNames, this->mVariableUnits, this->mInitialConditions,
+                                                             this->mParameterNames, this->mParameterUnits);
+    this->mInitialised = true;
+}
+
+template<>
+void CellwiseOdeSystemInformation<ErkPropulsionOdeSystemVelocityAlignment>::Initialise()
+{
+    InitialiseErkPropulsionOdeSystemInformation<VelocityAlignment>(this->mVariableNames, this->mVariableUnits, this->mInitialConditions,
+                                                                   this->mParameterNames, this->mParameterUnits);
+    this->mInitialised = true;
+}
+
+template<>
+void CellwiseOdeSystemInformation<ErkPropulsionOdeSystemNeighbourAlignment>::Initialise()
+{
+    InitialiseErkPropulsionOdeSystemInformation<NeighbourAlignment>(this->mVariableNames, this->mVariableUnits, this->mInitialConditions,
+                                                                    this->mParameterNames, this->mParameterUnits);
+    this->mInitialised = true;
+}
+
+// Explicit instantiation
+template class ErkPropulsionOdeSystem<NoAlignment>;
+template class ErkPropulsionOdeSystem<VelocityAlignment>;
+template class ErkPropulsionOdeSystem<NeighbourAlignment>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+CHASTE_CLASS_EXPORT(ErkPropulsionOdeSystemNoAlignment)
+CHASTE_CLASS_EXPORT(ErkPropulsionOdeSystemVelocityAlignment)
+CHASTE_CLASS_EXPORT(ErkPropulsionOdeSystemNeighbourAlignment)
@@ -0,0 +1,148 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef ERKPROPULSIONODESYSTEM_HPP_
+#define ERKPROPULSIONODESYSTEM_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include <cmath>
+#include <iostream>
+
+#include "AbstractOdeSystem.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "ErkPropulsionAlignmentPolicies.hpp"
+
+/**
+ * ODE system for mechanochemical ERK-area coupling and a persistent
+ * random walk in the self propulsion angle, with the alignment of
+ * the self propulsion angle selected at compile time by the ALIGNMENT
+ * policy (see ErkPropulsionAlignmentPolicies.hpp).
+ *
+ * The parameters are Cell Area, taul, alpha, beta, Eta Std and
+ * dt_ode, followed by theta_vi and K for aligning policies only.
+ */
+template<class ALIGNMENT>
+class ErkPropulsionOdeSystem : public AbstractOdeSystem
+{
+private:
+
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractOdeSystem>(*this);
+    }
+
+public:
+
+    /** Indices of the parameters, for lookups that avoid searching by name. */
+    enum ParameterIndex
+    {
+        CELL_AREA = 0,
+        TAUL,
+        ALPHA,
+        BETA,
+        ETA_STD,
+        DT_ODE,
+        ALIGNMENT_ANGLE,    // Aligning policies only
+        ALIGNMENT_STRENGTH    // Aligning policies only
+    };
+
+    /**
+     * Default constructor.
+     *
+     * @param stateVariables optional initial conditions for state variables (only used in archiving)
+     */
+    ErkPropulsionOdeSystem(std::vector<double> stateVariables=std::vector<double>());
+
+    /**
+     * Destructor.
+     */
+    ~ErkPropulsionOdeSystem();
+
+    /**
+     * Compute the RHS of the system for mechanochemical ERK-area
+     * coupling and persistent random walk. See Boocock et al (2023)
+     * DOI: 10.1101/2023.03.24.534111.
+     *
+     * Returns a vector representing the RHS of the ODEs at each time step, y' = [y1' ... yn'].
+     * An ODE solver will call this function repeatedly to solve for y = [y1 ... yn].
+     *
+     * @param time used to evaluate the RHS.
+     * @param rY value of the solution vector used to evaluate the RHS.
+     * @param rDY filled in with the resulting derivatives (using Boocock et al. system of equations).
+     */
+    void EvaluateYDerivatives(double time, const std::vector<double>& rY, std::vector<double>& rDY);
+};
+
+namespace boost
+{
+namespace serialization
+{
+/**
+ * Serialize information required to construct a ErkPropulsionOdeSystem.
+ */
+template<class Archive, class ALIGNMENT>
+inline void save_construct_data(
+    Archive & ar, const ErkPropulsionOdeSystem<ALIGNMENT> * t, const unsigned int file_version)
+{
+    const std::vector<double>& state_variables = t->rGetConstStateVariables();
+    ar & state_variables;
+}
+
+/**
+ * De-serialize constructor parameters and initialise a ErkPropulsionOdeSystem.
+ */
+template<class Archive, class ALIGNMENT>
+inline void load_construct_data(
+    Archive & ar, ErkPropulsionOdeSystem<ALIGNMENT> * t, const unsigned int file_version)
+{
+    std::vector<double> state_variables;
+    ar & state_variables;
+
+    // Invoke inplace constructor to initialise instance
+    ::new(t)ErkPropulsionOdeSystem<ALIGNMENT>(state_variables);
+}
+}
+}
+
+#endif /*ERKPROPULSIONODESYSTEM_HPP_*/
@@ -36,94 +36,16 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef ERKPROPULSIONODESYSTEMNOALIGNMENT_HPP_
 #define ERKPROPULSIONODESYSTEMNOALIGNMENT_HPP_
 
-#include "ChasteSerialization.hpp"
-#include <boost/serialization/base_object.hpp>
+#include "ErkPropulsionOdeSystem.hpp"
 
-#include <cmath>
-#include <iostream>
-
-#include "AbstractOdeSystem.hpp"
-#include "RandomNumberGenerator.hpp"
-
-class ErkPropulsionOdeSystemNoAlignment : public AbstractOdeSystem
-{
-private:
-
-    friend class boost::serialization::access;
-    /**
-     * Serialize the object and its member variables.
-     *
-     * @param archive the archive
-     * @param version the current version of this class
-     */
-    template<class Archive>
-    void serialize(Archive & archive, const unsigned int version)
-    {
-        archive & boost::serialization::base_object<AbstractOdeSystem>(*this);
-    }
-
-public:
-
-    /**
-     * Default constructor.
-     *
-     * @param stateVariables optional initial conditions for state variables (only used in archiving)
-     */
-    ErkPropulsionOdeSystemNoAlignment(std::vector<double> stateVariables=std::vector<double>());
-
-    /**
-     * Destructor.
-     */
-    ~ErkPropulsionOdeSystemNoAlignment();
-
-    /**
-     * Compute the RHS of the system for mechanochemical ERK-area
-     * coupling and persistent random walk. See Boocock et al (2023)
-     * DOI: 10.1101/2023.03.24.534111.
-     *
-     * Returns a vector representing the RHS of the ODEs at each time step, y' = [y1' ... yn'].
-     * An ODE solver will call this function repeatedly to solve for y = [y1 ... yn].
-     *
-     * @param time used to evaluate the RHS.
-     * @param rY value of the solution vector used to evaluate the RHS.
-     * @param rDY filled in with the resulting derivatives (using Boocock et al. system of equations).
-     */
-    void EvaluateYDerivatives(double time, const std::vector<double>& rY, std::vector<double>& rDY);
-};
+/**
+ * The ErkPropulsionOdeSystem without alignment: the self propulsion
+ * angle performs a persistent random walk.
+ */
+typedef ErkPropulsionOdeSystem<NoAlignment> ErkPropulsionOdeSystemNoAlignment;
 
 // Declare identifier for the serializer
 #include "SerializationExportWrapper.hpp"
 CHASTE_CLASS_EXPORT(ErkPropulsionOdeSystemNoAlignment)
 
-namespace boost
-{
-namespace serialization
-{
-/**
- * Serialize information required to construct a ErkPropulsionOdeSystemNoAlignment.
- */
-template<class Archive>
-inline void save_construct_data(
-    Archive & ar, const ErkPropulsionOdeSystemNoAlignment * t, const unsigned int file_version)
-{
-    const std::vector<double>& state_variables = t->rGetConstStateVariables();
-    ar & state_variables;
-}
-
-/**
- * De-serialize constructor parameters and initialise a ErkPropulsionOdeSystemNoAlignment.
- */
-template<class Archive>
-inline void load_construct_data(
-    Archive & ar, ErkPropulsionOdeSystemNoAlignment * t, const unsigned int file_version)
-{
-    std::vector<double> state_variables;
-    ar & state_variables;
-
-    // Invoke inplace constructor to initialise instance
-    ::new(t)ErkPropulsionOdeSystemNoAlignment(state_variables);
-}
-}
-}
-
 #endif /*ERKPROPULSIONODESYSTEMNOALIGNMENT_HPP_*/
@@ -0,0 +1,278 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "OutputCadenceVertexBasedCellPopulation.hpp"
+#include "ReorderableToroidal2dVertexMesh.hpp"
+#include "SimulationTime.hpp"
+
+template<unsigned DIM>
+OutputCadenceVertexBasedCellPopulation<DIM>::OutputCadenceVertexBasedCellPopulation(MutableVertexMesh<DIM, DIM>& rMesh,
+                                                                                    std::vector<CellPtr>& rCells,
+                                                                                    bool deleteMesh,
+                                                                                    bool validate,
+                                                                                    const std::vector<unsigned> locationIndices)
+    : VertexBasedCellPopulation<DIM>(rMesh, rCells, deleteMesh, validate, locationIndices),
+      mVtkTimestepMultiple(1),
+      mLogRearrangements(false),
+      mRenumberingTimestepMultiple(0)
+{
+}
+
+template<unsigned DIM>
+OutputCadenceVertexBasedCellPopulation<DIM>::OutputCadenceVertexBasedCellPopulation(MutableVertexMesh<DIM, DIM>& rMesh)
+    : VertexBasedCellPopulation<DIM>(rMesh),
+      mVtkTimestepMultiple(1),
+      mLogRearrangements(false),
+      mRenumberingTimestepMultiple(0)
+{
+}
+
+template<unsigned DIM>
+OutputCadenceVertexBasedCellPopulation<DIM>::~OutputCadenceVertexBasedCellPopulation()
+{
+}
+
+template<unsigned DIM>
+bool OutputCadenceVertexBasedCellPopulation<DIM>::IsDue(unsigned timestepMultiple)
+{
+    // This includes the initial output at the start of each Solve(),
+    // when no time steps have elapsed
+    return (timestepMultiple > 0) && (SimulationTime::Instance()->GetTimeStepsElapsed()%timestepMultiple == 0);
+}
+
+template<unsigned DIM>
+unsigned OutputCadenceVertexBasedCellPopulation<DIM>::GetVtkTimestepMultiple()
+{
+    return mVtkTimestepMultiple;
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::SetVtkTimestepMultiple(unsigned vtkTimestepMultiple)
+{
+    mVtkTimestepMultiple = vtkTimestepMultiple;
+}
+
+template<unsigned DIM>
+unsigned OutputCadenceVertexBasedCellPopulation<DIM>::GetWriterTimestepMultiple(const std::string& rFileName)
+{
+    std::map<std::string, unsigned>::const_iterator it = mWriterTimestepMultiples.find(rFileName);
+    return (it == mWriterTimestepMultiples.end()) ? 1 : it->second;
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::SetWriterTimestepMultiple(const std::string& rFileName, unsigned timestepMultiple)
+{
+    mWriterTimestepMultiples[rFileName] = timestepMultiple;
+}
+
+template<unsigned DIM>
+bool OutputCadenceVertexBasedCellPopulation<DIM>::GetLogRearrangements()
+{
+    return mLogRearrangements;
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::SetLogRearrangements(bool logRearrangements)
+{
+    mLogRearrangements = logRearrangements;
+}
+
+template<unsigned DIM>
+boost::shared_ptr<RearrangementLog<DIM> > OutputCadenceVertexBasedCellPopulation<DIM>::GetRearrangementLog()
+{
+    return mpRearrangementLog;
+}
+
+template<unsigned DIM>
+unsigned OutputCadenceVertexBasedCellPopulation<DIM>::GetRenumberingTimestepMultiple()
+{
+    return mRenumberingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::SetRenumberingTimestepMultiple(unsigned renumberingTimestepMultiple)
+{
+    mRenumberingTimestepMultiple = renumberingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::RenumberForLocality()
+{
+    ReorderableToroidal2dVertexMesh* p_mesh = dynamic_cast<ReorderableToroidal2dVertexMesh*>(&(this->rGetMesh()));
+    if (p_mesh == nullptr)
+    {
+        EXCEPTION("Renumbering for locality needs a ReorderableToroidal2dVertexMesh");
+    }
+    std::vector<unsigned> element_order = p_mesh->ReorderAlongHilbertCurve();
+
+    // Move each cell to the new index of its element
+    std::vector<unsigned> new_element_indices(element_order.size());
+    for (unsigned new_index=0; new_index<element_order.size(); new_index++)
+    {
+        new_element_indices[element_order[new_index]] = new_index;
+    }
+    std::map<Cell*, unsigned> old_cell_locations;
+    old_cell_locations.swap(this->mCellLocationMap);
+    this->mLocationCellMap.clear();
+    for (std::list<CellPtr>::iterator cell_iter = this->mCells.begin();
+         cell_iter != this->mCells.end();
+         ++cell_iter)
+    {
+        unsigned new_index = new_element_indices[old_cell_locations[cell_iter->get()]];
+        this->mLocationCellMap[new_index].insert(*cell_iter);
+        this->mCellLocationMap[cell_iter->get()] = new_index;
+    }
+}
+
+template<unsigned DIM>
+unsigned OutputCadenceVertexBasedCellPopulation<DIM>::RemoveDeadCells()
+{
+    unsigned num_removed = VertexBasedCellPopulation<DIM>::RemoveDeadCells();
+
+    // Removed cells leave deleted elements in the mesh until the next
+    // ReMesh(), so renumbering waits for a time step without deaths
+    if (num_removed == 0 && IsDue(mRenumberingTimestepMultiple))
+    {
+        RenumberForLocality();
+    }
+    return num_removed;
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::Update(bool hasHadBirthsOrDeaths)
+{
+    if (mpRearrangementLog)
+    {
+        mpRearrangementLog->BeginUpdate(*this);
+    }
+    VertexBasedCellPopulation<DIM>::Update(hasHadBirthsOrDeaths);
+    if (mpRearrangementLog)
+    {
+        mpRearrangementLog->EndUpdate(*this);
+    }
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::OpenWritersFiles(OutputFileHandler& rOutputFileHandler)
+{
+    VertexBasedCellPopulation<DIM>::OpenWritersFiles(rOutputFileHandler);
+    mpRearrangementLog.reset();
+    if (mLogRearrangements)
+    {
+        mpRearrangementLog.reset(new RearrangementLog<DIM>(rOutputFileHandler));
+    }
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::CloseWritersFiles()
+{
+    if (mpRearrangementLog)
+    {
+        mpRearrangementLog->Close(this->GetNumRealCells());
+    }
+    VertexBasedCellPopulation<DIM>::CloseWritersFiles();
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::WriteResultsToFiles(const std::string& rDirectory)
+{
+    // Temporarily hide the writers that are not due, so that the
+    // parent class writes only the others
+    std::vector<boost::shared_ptr<AbstractCellWriter<DIM, DIM> > > all_cell_writers;
+    std::vector<boost::shared_ptr<AbstractCellPopulationWriter<DIM, DIM> > > all_population_writers;
+    all_cell_writers.swap(this->mCellWriters);
+    all_population_writers.swap(this->mCellPopulationWriters);
+    for (unsigned i=0; i<all_cell_writers.size(); i++)
+    {
+        if (IsDue(GetWriterTimestepMultiple(all_cell_writers[i]->GetFileName())))
+        {
+            this->mCellWriters.push_back(all_cell_writers[i]);
+        }
+    }
+    for (unsigned i=0; i<all_population_writers.size(); i++)
+    {
+        if (IsDue(GetWriterTimestepMultiple(all_population_writers[i]->GetFileName())))
+        {
+            this->mCellPopulationWriters.push_back(all_population_writers[i]);
+        }
+    }
+
+    try
+    {
+        VertexBasedCellPopulation<DIM>::WriteResultsToFiles(rDirectory);
+    }
+    catch (...)
+    {
+        all_cell_writers.swap(this->mCellWriters);
+        all_population_writers.swap(this->mCellPopulationWriters);
+        throw;
+    }
+    all_cell_writers.swap(this->mCellWriters);
+    all_population_writers.swap(this->mCellPopulationWriters);
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::WriteVtkResultsToFile(const std::string& rDirectory)
+{
+    if (IsDue(mVtkTimestepMultiple))
+    {
+        VertexBasedCellPopulation<DIM>::WriteVtkResultsToFile(rDirectory);
+    }
+}
+
+template<unsigned DIM>
+void OutputCadenceVertexBasedCellPopulation<DIM>::OutputCellPopulationParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t<VtkTimestepMultiple>" << mVtkTimestepMultiple << "</VtkTimestepMultiple>\n";
+    *rParamsFile << "\t\t<LogRearrangements>" << mLogRearrangements << "</LogRearrangements>\n";
+    *rParamsFile << "\t\t<RenumberingTimestepMultiple>" << mRenumberingTimestepMultiple << "</RenumberingTimestepMultiple>\n";
+    for (std::map<std::string, unsigned>::const_iterator it = mWriterTimestepMultiples.begin();
+         it != mWriterTimestepMultiples.end();
+         ++it)
+    {
+        *rParamsFile << "\t\t<WriterTimestepMultiple file=\"" << it->first << "\">" << it->second << "</WriterTimestepMultiple>\n";
+    }
+
+    // Call method on direct parent class
+    VertexBasedCellPopulation<DIM>::OutputCellPopulationParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class OutputCadenceVertexBasedCellPopulation<1>;
+template class OutputCadenceVertexBasedCellPopulation<2>;
+template class OutputCadenceVertexBasedCellPopulation<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(OutputCadenceVertexBasedCellPopulation)
@@ -0,0 +1,321 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef OUTPUTCADENCEVERTEXBASEDCELLPOPULATION_HPP_
+#define OUTPUTCADENCEVERTEXBASEDCELLPOPULATION_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+
+#include "VertexBasedCellPopulation.hpp"
+#include "RearrangementLog.hpp"
+
+#include <map>
+#include <string>
+
+/**
+ * A VertexBasedCellPopulation whose VTK output and individual writers
+ * can be written at different cadences.
+ *
+ * The simulation calls WriteResultsToFiles() every
+ * SetSamplingTimestepMultiple() time steps, which normally writes every
+ * cell and population writer as well as results.pvd and a VTU file.
+ * Here each of these is only written if the number of elapsed time
+ * steps is also a multiple of its own timestep multiple, so dense
+ * numeric cell data need not come with equally dense VTU meshes. The
+ * simulation's sampling timestep multiple should divide all of the
+ * multiples used (e.g. be their greatest common divisor).
+ *
+ * Writers are identified by their output file name. A multiple of 0
+ * switches VTK output or a writer off entirely; writers without a
+ * multiple set are written at every sample.
+ *
+ * If SetLogRearrangements() is called, every T1 and T2 swap is also
+ * recorded as it happens, with the cells involved, in
+ * rearrangements.bin and rearrangement rates are written to
+ * rearrangements.dat at the end of each Solve() (see
+ * RearrangementLog). This needs no snapshot output.
+ *
+ * If the mesh is a ReorderableToroidal2dVertexMesh, its nodes and
+ * elements can also be renumbered along a Hilbert curve every
+ * SetRenumberingTimestepMultiple() time steps, so that neighbouring
+ * cells stay close together in memory as T1 swaps rearrange them. The
+ * location index of each cell is updated to match. Renumbering is
+ * done when the simulation removes dead cells, at the start of a time
+ * step and before the forces are computed, so that no data indexed by
+ * node or element (e.g. cached by the forces) is held over it.
+ */
+template<unsigned DIM>
+class OutputCadenceVertexBasedCellPopulation : public VertexBasedCellPopulation<DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<VertexBasedCellPopulation<DIM> >(*this);
+        archive & mVtkTimestepMultiple;
+        archive & mWriterTimestepMultiples;
+        archive & mLogRearrangements;
+        archive & mRenumberingTimestepMultiple;
+    }
+
+    /** The number of time steps between VTK outputs, or 0 for none. Defaults to 1. */
+    unsigned mVtkTimestepMultiple;
+
+    /** The number of time steps between outputs of each writer, by file name. */
+    std::map<std::string, unsigned> mWriterTimestepMultiples;
+
+    /** Whether to log T1 and T2 swaps. Defaults to false. */
+    bool mLogRearrangements;
+
+    /**
+     * The number of time steps between renumberings of the nodes and
+     * elements, or 0 for none. Defaults to 0.
+     */
+    unsigned mRenumberingTimestepMultiple;
+
+    /** The log of swaps in the current Solve(), if any. */
+    boost::shared_ptr<RearrangementLog<DIM> > mpRearrangementLog;
+
+    /**
+     * @param timestepMultiple a timestep multiple
+     * @return whether output at this multiple is due at the current time step
+     */
+    bool IsDue(unsigned timestepMultiple);
+
+public:
+
+    /**
+     * Create a new cell population facade from a mesh and collection
+     * of cells. See VertexBasedCellPopulation for details.
+     *
+     * @param rMesh reference to a MutableVertexMesh
+     * @param rCells reference to a vector of CellPtrs
+     * @param deleteMesh set to true if you want the cell population to free the mesh memory on destruction
+     * @param validate whether to validate the cell population when we create it (defaults to true)
+     * @param locationIndices an optional vector of location indices that correspond to real cells
+     */
+    OutputCadenceVertexBasedCellPopulation(MutableVertexMesh<DIM, DIM>& rMesh,
+                                           std::vector<CellPtr>& rCells,
+                                           bool deleteMesh=false,
+                                           bool validate=true,
+                                           const std::vector<unsigned> locationIndices=std::vector<unsigned>());
+
+    /**
+     * Constructor for use by the de-serializer.
+     *
+     * @param rMesh a vertex mesh.
+     */
+    OutputCadenceVertexBasedCellPopulation(MutableVertexMesh<DIM, DIM>& rMesh);
+
+    /**
+     * Destructor.
+     */
+    virtual ~OutputCadenceVertexBasedCellPopulation();
+
+    /**
+     * @return mVtkTimestepMultiple
+     */
+    unsigned GetVtkTimestepMultiple();
+
+    /**
+     * Set mVtkTimestepMultiple.
+     *
+     * @param vtkTimestepMultiple the number of time steps between VTK outputs, or 0 for none
+     */
+    void SetVtkTimestepMultiple(unsigned vtkTimestepMultiple);
+
+    /**
+     * @param rFileName the output file name of a cell or population writer
+     * @return the number of time steps between outputs of that writer
+     *     (1 if none has been set)
+     */
+    unsigned GetWriterTimestepMultiple(const std::string& rFileName);
+
+    /**
+     * Set the cadence of a cell or population writer.
+     *
+     * @param rFileName the output file name of the writer, e.g. "celldata.bin"
+     * @param timestepMultiple the number of time steps between outputs, or 0 for none
+     */
+    void SetWriterTimestepMultiple(const std::string& rFileName, unsigned timestepMultiple);
+
+    /**
+     * @return mLogRearrangements
+     */
+    bool GetLogRearrangements();
+
+    /**
+     * Set mLogRearrangements.
+     *
+     * @param logRearrangements whether to log T1 and T2 swaps
+     */
+    void SetLogRearrangements(bool logRearrangements=true);
+
+    /**
+     * @return the log of swaps in the current or last Solve(), or an
+     *     empty pointer if swaps are not logged
+     */
+    boost::shared_ptr<RearrangementLog<DIM> > GetRearrangementLog();
+
+    /**
+     * @return mRenumberingTimestepMultiple
+     */
+    unsigned GetRenumberingTimestepMultiple();
+
+    /**
+     * Set mRenumberingTimestepMultiple.
+     *
+     * @param renumberingTimestepMultiple the number of time steps between renumberings, or 0 for none
+     */
+    void SetRenumberingTimestepMultiple(unsigned renumberingTimestepMultiple);
+
+    /**
+     * Renumber the nodes and elements of the mesh along a Hilbert
+     * curve and move each cell to the new index of its element. The
+     * mesh must be a ReorderableToroidal2dVertexMesh without deleted
+     * nodes or elements.
+     */
+    void RenumberForLocality();
+
+    /**
+     * Overridden RemoveDeadCells() method.
+     *
+     * Also renumber the nodes and elements if due and no cells were removed.
+     *
+     * @return the number of dead cells removed
+     */
+    virtual unsigned RemoveDeadCells();
+
+    /**
+     * Overridden Update() method.
+     *
+     * Log any swaps made while remeshing.
+     *
+     * @param hasHadBirthsOrDeaths whether there have been any births or deaths in the population
+     */
+    virtual void Update(bool hasHadBirthsOrDeaths=true);
+
+    /**
+     * Overridden OpenWritersFiles() method.
+     *
+     * Also start a new rearrangement log.
+     *
+     * @param rOutputFileHandler handler for the directory in which to open this file
+     */
+    virtual void OpenWritersFiles(OutputFileHandler& rOutputFileHandler);
+
+    /**
+     * Overridden CloseWritersFiles() method.
+     *
+     * Also write the rearrangement statistics.
+     */
+    virtual void CloseWritersFiles();
+
+    /**
+     * Overridden WriteResultsToFiles() method.
+     *
+     * Only write the writers that are due at this time step.
+     *
+     * @param rDirectory pathname of the output directory, relative to where Chaste output is stored
+     */
+    virtual void WriteResultsToFiles(const std::string& rDirectory);
+
+    /**
+     * Overridden WriteVtkResultsToFile() method.
+     *
+     * Only write VTK output if it is due at this time step.
+     *
+     * @param rDirectory pathname of the output directory, relative to where Chaste output is stored
+     */
+    virtual void WriteVtkResultsToFile(const std::string& rDirectory);
+
+    /**
+     * Overridden OutputCellPopulationParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    virtual void OutputCellPopulationParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(OutputCadenceVertexBasedCellPopulation)
+
+namespace boost
+{
+namespace serialization
+{
+/**
+ * Serialize information required to construct an OutputCadenceVertexBasedCellPopulation.
+ */
+template<class Archive, unsigned DIM>
+inline void save_construct_data(
+    Archive & ar, const OutputCadenceVertexBasedCellPopulation<DIM> * t, const unsigned int file_version)
+{
+    // Save data required to construct instance
+    const MutableVertexMesh<DIM,DIM>* p_mesh = &(t->rGetMesh());
+    ar & p_mesh;
+}
+
+/**
+ * De-serialize constructor parameters and initialise an
+ * OutputCadenceVertexBasedCellPopulation. Loads the mesh from the
+ * archive and passes it to the constructor.
+ */
+template<class Archive, unsigned DIM>
+inline void load_construct_data(
+    Archive & ar, OutputCadenceVertexBasedCellPopulation<DIM> * t, const unsigned int file_version)
+{
+    // Retrieve data from archive required to construct new instance
+    MutableVertexMesh<DIM,DIM>* p_mesh;
+    ar >> p_mesh;
+
+    // Invoke inplace constructor to initialise instance
+    ::new(t)OutputCadenceVertexBasedCellPopulation<DIM>(*p_mesh);
+}
+}
+} // namespace ...
+
+#endif /*OUTPUTCADENCEVERTEXBASEDCELLPOPULATION_HPP_*/
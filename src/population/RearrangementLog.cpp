@@ -0,0 +1,437 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "RearrangementLog.hpp"
+#include "Histogram.hpp"
+#include "SimulationTime.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <limits>
+#include <set>
+
+template<unsigned DIM>
+RearrangementLog<DIM>::RearrangementLog(OutputFileHandler& rOutputFileHandler)
+    : mStartTime(SimulationTime::Instance()->GetTime()),
+      mNumT1LocationsBefore(0),
+      mNumT2LocationsLogged(0),
+      mNumT1Swaps(0),
+      mNumT2Swaps(0)
+{
+    mpEventFile = rOutputFileHandler.OpenOutputFile("rearrangements.bin", std::ios::out | std::ios::trunc | std::ios::binary);
+    mpSummaryFile = rOutputFileHandler.OpenOutputFile("rearrangements.dat");
+
+    // Records are written in native byte order, which is recorded in
+    // the magic string
+    const uint16_t byte_order_test = 1;
+    char byte_order = (*reinterpret_cast<const char*>(&byte_order_test) == 1) ? '<' : '>';
+    char magic[8] = {'E', 'R', 'K', 'R', 'E', 'A', 'R', byte_order};
+    uint32_t version = 1;
+    uint32_t record_size = sizeof(EventRecord);
+    mpEventFile->write(magic, 8);
+    mpEventFile->write(reinterpret_cast<const char*>(&version), sizeof(version));
+    mpEventFile->write(reinterpret_cast<const char*>(&record_size), sizeof(record_size));
+}
+
+template<unsigned DIM>
+RearrangementLog<DIM>::~RearrangementLog()
+{
+}
+
+template<unsigned DIM>
+void RearrangementLog<DIM>::ComputeNeighbours(VertexBasedCellPopulation<DIM>& rCellPopulation,
+                                              unsigned elementIndex,
+                                              std::vector<unsigned>& rNeighbours)
+{
+    rNeighbours.clear();
+    std::set<unsigned> neighbour_indices = rCellPopulation.rGetMesh().GetNeighbouringElementIndices(elementIndex);
+    for (std::set<unsigned>::const_iterator it = neighbour_indices.begin(); it != neighbour_indices.end(); ++it)
+    {
+        rNeighbours.push_back(rCellPopulation.GetCellUsingLocationIndex(*it)->GetCellId());
+    }
+    std::sort(rNeighbours.begin(), rNeighbours.end());
+}
+
+template<unsigned DIM>
+void RearrangementLog<DIM>::AddElementsNearLocation(MutableVertexMesh<DIM, DIM>& rMesh,
+                                                    const c_vector<double, DIM>& rLocation,
+                                                    unsigned numNodes,
+                                                    std::vector<unsigned>& rElementIndices)
+{
+    assert(numNodes == 1 || numNodes == 2);
+    double nearest_distances[2] = {std::numeric_limits<double>::max(), std::numeric_limits<double>::max()};
+    unsigned nearest_nodes[2] = {UNSET, UNSET};
+    for (typename AbstractMesh<DIM, DIM>::NodeIterator node_iter = rMesh.GetNodeIteratorBegin();
+         node_iter != rMesh.GetNodeIteratorEnd();
+         ++node_iter)
+    {
+        double distance = norm_2(rMesh.GetVectorFromAtoB(rLocation, node_iter->rGetLocation()));
+        if (distance < nearest_distances[0])
+        {
+            nearest_distances[1] = nearest_distances[0];
+            nearest_nodes[1] = nearest_nodes[0];
+            nearest_distances[0] = distance;
+            nearest_nodes[0] = node_iter->GetIndex();
+        }
+        else if (distance < nearest_distances[1])
+        {
+            nearest_distances[1] = distance;
+            nearest_nodes[1] = node_iter->GetIndex();
+        }
+    }
+    for (unsigned k=0; k<numNodes; k++)
+    {
+        if (nearest_nodes[k] != UNSET)
+        {
+            const std::set<unsigned>& r_elements = rMesh.GetNode(nearest_nodes[k])->rGetContainingElementIndices();
+            rElementIndices.insert(rElementIndices.end(), r_elements.begin(), r_elements.end());
+        }
+    }
+}
+
+template<unsigned DIM>
+void RearrangementLog<DIM>::WriteEvent(const EventRecord& rEvent)
+{
+    mpEventFile->write(reinterpret_cast<const char*>(&rEvent), sizeof(EventRecord));
+}
+
+template<unsigned DIM>
+void RearrangementLog<DIM>::BeginUpdate(VertexBasedCellPopulation<DIM>& rCellPopulation)
+{
+    mNumT1LocationsBefore = rCellPopulation.rGetMesh().GetLocationsOfT1Swaps().size();
+    if (mNeighbours.empty())
+    {
+        for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+             cell_iter != rCellPopulation.End();
+             ++cell_iter)
+        {
+            unsigned cell_id = cell_iter->GetCellId();
+            if (cell_id >= mNeighbours.size())
+            {
+                mNeighbours.resize(cell_id + 1);
+            }
+            ComputeNeighbours(rCellPopulation, rCellPopulation.GetLocationIndexUsingCell(*cell_iter), mNeighbours[cell_id]);
+        }
+    }
+}
+
+template<unsigned DIM>
+void RearrangementLog<DIM>::EndUpdate(VertexBasedCellPopulation<DIM>& rCellPopulation)
+{
+    MutableVertexMesh<DIM, DIM>& r_mesh = rCellPopulation.rGetMesh();
+    const std::vector<c_vector<double, DIM> >& r_t1_locations = r_mesh.GetLocationsOfT1Swaps();
+    const std::vector<c_vector<double, DIM> >& r_t2_locations = rCellPopulation.GetLocationsOfT2Swaps();
+    const std::vector<unsigned>& r_t2_cell_ids = rCellPopulation.GetCellIdsOfT2Swaps();
+
+    // The locations may have been cleared by a writer since we last looked
+    if (r_t1_locations.size() < mNumT1LocationsBefore)
+    {
+        mNumT1LocationsBefore = 0;
+    }
+    if (r_t2_locations.size() < mNumT2LocationsLogged)
+    {
+        mNumT2LocationsLogged = 0;
+    }
+    if (r_t1_locations.size() == mNumT1LocationsBefore && r_t2_locations.size() == mNumT2LocationsLogged)
+    {
+        return;
+    }
+
+    // Only the cells around the swaps can have changed neighbours.
+    // Removed cells have none.
+    std::vector<unsigned> changed_elements;
+    for (unsigned i=mNumT1LocationsBefore; i<r_t1_locations.size(); i++)
+    {
+        AddElementsNearLocation(r_mesh, r_t1_locations[i], 2, changed_elements);
+    }
+    for (unsigned i=mNumT2LocationsLogged; i<r_t2_locations.size(); i++)
+    {
+        AddElementsNearLocation(r_mesh, r_t2_locations[i], 1, changed_elements);
+        if (i < r_t2_cell_ids.size() && r_t2_cell_ids[i] < mNeighbours.size())
+        {
+            mNeighbours[r_t2_cell_ids[i]].clear();
+        }
+    }
+    std::sort(changed_elements.begin(), changed_elements.end());
+    changed_elements.erase(std::unique(changed_elements.begin(), changed_elements.end()), changed_elements.end());
+
+    // Find the pairs of cells that have gained or lost contact, and
+    // bring the neighbours of the changed cells up to date
+    std::map<unsigned, unsigned> element_indices;
+    for (unsigned k=0; k<changed_elements.size(); k++)
+    {
+        element_indices[rCellPopulation.GetCellUsingLocationIndex(changed_elements[k])->GetCellId()] = changed_elements[k];
+    }
+    std::vector<std::pair<unsigned, unsigned> > gained_pairs;
+    std::vector<std::pair<unsigned, unsigned> > lost_pairs;
+    std::vector<unsigned> neighbours;
+    for (std::map<unsigned, unsigned>::const_iterator it = element_indices.begin(); it != element_indices.end(); ++it)
+    {
+        unsigned cell_id = it->first;
+        ComputeNeighbours(rCellPopulation, it->second, neighbours);
+        if (cell_id >= mNeighbours.size())
+        {
+            mNeighbours.resize(cell_id + 1);
+        }
+        const std::vector<unsigned>& r_old_neighbours = mNeighbours[cell_id];
+
+        // Each pair is found from its lower cell id, or from the only
+        // changed cell of the pair
+        for (unsigned j=0; j<neighbours.size(); j++)
+        {
+            unsigned other_id = neighbours[j];
+            if (!std::binary_search(r_old_neighbours.begin(), r_old_neighbours.end(), other_id)
+                && (cell_id < other_id || element_indices.count(other_id) == 0))
+            {
+                gained_pairs.push_back(std::make_pair(std::min(cell_id, other_id), std::max(cell_id, other_id)));
+            }
+        }
+        for (unsigned j=0; j<r_old_neighbours.size(); j++)
+        {
+            // Contacts with removed cells are not neighbour changes
+            unsigned other_id = r_old_neighbours[j];
+            if (!std::binary_search(neighbours.begin(), neighbours.end(), other_id)
+                && other_id < mNeighbours.size() && !mNeighbours[other_id].empty()
+                && (cell_id < other_id || element_indices.count(other_id) == 0))
+            {
+                lost_pairs.push_back(std::make_pair(std::min(cell_id, other_id), std::max(cell_id, other_id)));
+            }
+        }
+        mNeighbours[cell_id].swap(neighbours);
+    }
+
+    // Keep the neighbours of any unchanged cell of a pair consistent
+    for (unsigned p=0; p<gained_pairs.size(); p++)
+    {
+        for (unsigned k=0; k<2; k++)
+        {
+            unsigned cell_id = (k == 0) ? gained_pairs[p].first : gained_pairs[p].second;
+            unsigned other_id = (k == 0) ? gained_pairs[p].second : gained_pairs[p].first;
+            if (element_indices.count(cell_id) == 0 && cell_id < mNeighbours.size())
+            {
+                std::vector<unsigned>& r_neighbours = mNeighbours[cell_id];
+                std::vector<unsigned>::iterator position = std::lower_bound(r_neighbours.begin(), r_neighbours.end(), other_id);
+                if (position == r_neighbours.end() || *position != other_id)
+                {
+                    r_neighbours.insert(position, other_id);
+                }
+            }
+        }
+        mCellNeighbourChanges[gained_pairs[p].first]++;
+        mCellNeighbourChanges[gained_pairs[p].second]++;
+    }
+    for (unsigned p=0; p<lost_pairs.size(); p++)
+    {
+        for (unsigned k=0; k<2; k++)
+        {
+            unsigned cell_id = (k == 0) ? lost_pairs[p].first : lost_pairs[p].second;
+            unsigned other_id = (k == 0) ? lost_pairs[p].second : lost_pairs[p].first;
+            if (element_indices.count(cell_id) == 0 && cell_id < mNeighbours.size())
+            {
+                std::vector<unsigned>& r_neighbours = mNeighbours[cell_id];
+                std::vector<unsigned>::iterator position = std::lower_bound(r_neighbours.begin(), r_neighbours.end(), other_id);
+                if (position != r_neighbours.end() && *position == other_id)
+                {
+                    r_neighbours.erase(position);
+                }
+            }
+        }
+        mCellNeighbourChanges[lost_pairs[p].first]++;
+        mCellNeighbourChanges[lost_pairs[p].second]++;
+    }
+
+    double time = SimulationTime::Instance()->GetTime();
+    std::vector<bool> gained_pair_used(gained_pairs.size(), false);
+    std::vector<bool> lost_pair_used(lost_pairs.size(), false);
+    for (unsigned i=mNumT1LocationsBefore; i<r_t1_locations.size(); i++)
+    {
+        EventRecord event = {time, {r_t1_locations[i][0], r_t1_locations[i][DIM-1]}, 1,
+                             {UNSET, UNSET}, {UNSET, UNSET, UNSET, UNSET}, 0};
+
+        // The new edge is the one shared by a newly adjacent pair of
+        // cells whose midpoint lies nearest the swap location
+        double best_distance = std::numeric_limits<double>::max();
+        unsigned best_pair = UNSET;
+        for (unsigned p=0; p<gained_pairs.size(); p++)
+        {
+            if (gained_pair_used[p]
+                || element_indices.count(gained_pairs[p].first) == 0
+                || element_indices.count(gained_pairs[p].second) == 0)
+            {
+                continue;
+            }
+            VertexElement<DIM, DIM>* p_element_a = r_mesh.GetElement(element_indices[gained_pairs[p].first]);
+            VertexElement<DIM, DIM>* p_element_b = r_mesh.GetElement(element_indices[gained_pairs[p].second]);
+            std::vector<unsigned> shared_nodes;
+            for (unsigned local_index=0; local_index<p_element_a->GetNumNodes(); local_index++)
+            {
+                unsigned node_index = p_element_a->GetNodeGlobalIndex(local_index);
+                if (p_element_b->GetNodeLocalIndex(node_index) != UINT_MAX)
+                {
+                    shared_nodes.push_back(node_index);
+                }
+            }
+            if (shared_nodes.size() != 2)
+            {
+                continue;
+            }
+            const c_vector<double, DIM>& r_location_a = r_mesh.GetNode(shared_nodes[0])->rGetLocation();
+            c_vector<double, DIM> midpoint = r_location_a + 0.5*r_mesh.GetVectorFromAtoB(r_location_a, r_mesh.GetNode(shared_nodes[1])->rGetLocation());
+            double distance = norm_2(r_mesh.GetVectorFromAtoB(r_t1_locations[i], midpoint));
+            if (distance < best_distance)
+            {
+                best_distance = distance;
+                best_pair = p;
+                event.mNodes[0] = shared_nodes[0];
+                event.mNodes[1] = shared_nodes[1];
+            }
+        }
+
+        if (best_pair != UNSET)
+        {
+            gained_pair_used[best_pair] = true;
+            unsigned cell_a = gained_pairs[best_pair].first;
+            unsigned cell_b = gained_pairs[best_pair].second;
+            event.mCells[0] = cell_a;
+            event.mCells[1] = cell_b;
+
+            // The cells that separated are common neighbours of the
+            // pair that came into contact
+            const std::vector<unsigned>& r_neighbours_a = mNeighbours[cell_a];
+            const std::vector<unsigned>& r_neighbours_b = mNeighbours[cell_b];
+            for (unsigned p=0; p<lost_pairs.size(); p++)
+            {
+                unsigned cell_c = lost_pairs[p].first;
+                unsigned cell_d = lost_pairs[p].second;
+                if (!lost_pair_used[p]
+                    && std::binary_search(r_neighbours_a.begin(), r_neighbours_a.end(), cell_c)
+                    && std::binary_search(r_neighbours_a.begin(), r_neighbours_a.end(), cell_d)
+                    && std::binary_search(r_neighbours_b.begin(), r_neighbours_b.end(), cell_c)
+                    && std::binary_search(r_neighbours_b.begin(), r_neighbours_b.end(), cell_d))
+                {
+                    lost_pair_used[p] = true;
+                    event.mCells[2] = cell_c;
+                    event.mCells[3] = cell_d;
+                    break;
+                }
+            }
+            for (unsigned k=0; k<4; k++)
+            {
+                if (event.mCells[k] != UNSET)
+                {
+                    mCellT1Swaps[event.mCells[k]]++;
+                }
+            }
+        }
+        WriteEvent(event);
+        mNumT1Swaps++;
+    }
+
+    for (unsigned i=mNumT2LocationsLogged; i<r_t2_locations.size(); i++)
+    {
+        EventRecord event = {time, {r_t2_locations[i][0], r_t2_locations[i][DIM-1]}, 2,
+                             {UNSET, UNSET}, {UNSET, UNSET, UNSET, UNSET}, 0};
+        if (i < r_t2_cell_ids.size())
+        {
+            event.mCells[0] = r_t2_cell_ids[i];
+        }
+        WriteEvent(event);
+        mNumT2Swaps++;
+    }
+    mNumT2LocationsLogged = r_t2_locations.size();
+
+    mpEventFile->flush();
+}
+
+template<unsigned DIM>
+void RearrangementLog<DIM>::Close(unsigned numCells)
+{
+    double observation_time = SimulationTime::Instance()->GetTime() - mStartTime;
+    double t1_rate = (numCells > 0 && observation_time > 0.0) ? mNumT1Swaps/(numCells*observation_time) : 0.0;
+
+    *mpSummaryFile << "# Cell rearrangements (see RearrangementLog)\n"
+                   << "observation_time " << observation_time << "\n"
+                   << "num_cells " << numCells << "\n"
+                   << "num_t1_swaps " << mNumT1Swaps << "\n"
+                   << "num_t2_swaps " << mNumT2Swaps << "\n"
+                   << "t1_rate_per_cell " << t1_rate << "\n";
+
+    // Cells without any neighbour change count as zero
+    std::vector<double> neighbour_changes;
+    std::vector<double> t1_swaps;
+    for (unsigned cell_id=0; cell_id<mNeighbours.size(); cell_id++)
+    {
+        if (mNeighbours[cell_id].empty())
+        {
+            continue;
+        }
+        std::map<unsigned, unsigned>::const_iterator jt = mCellNeighbourChanges.find(cell_id);
+        neighbour_changes.push_back((jt == mCellNeighbourChanges.end()) ? 0.0 : jt->second);
+        jt = mCellT1Swaps.find(cell_id);
+        t1_swaps.push_back((jt == mCellT1Swaps.end()) ? 0.0 : jt->second);
+    }
+    if (!neighbour_changes.empty())
+    {
+        Histogram::FromValues(neighbour_changes, 20).Write(*mpSummaryFile, "neighbour_changes");
+        Histogram::FromValues(t1_swaps, 20).Write(*mpSummaryFile, "t1_swaps");
+    }
+
+    mpEventFile->close();
+    mpSummaryFile->close();
+}
+
+template<unsigned DIM>
+unsigned RearrangementLog<DIM>::GetNumT1Swaps() const
+{
+    return mNumT1Swaps;
+}
+
+template<unsigned DIM>
+unsigned RearrangementLog<DIM>::GetNumT2Swaps() const
+{
+    return mNumT2Swaps;
+}
+
+template<unsigned DIM>
+unsigned RearrangementLog<DIM>::GetNumT1Swaps(unsigned cellId) const
+{
+    std::map<unsigned, unsigned>::const_iterator it = mCellT1Swaps.find(cellId);
+    return (it == mCellT1Swaps.end()) ? 0 : it->second;
+}
+
+// Explicit instantiation
+template class RearrangementLog<1>;
+template class RearrangementLog<2>;
+template class RearrangementLog<3>;
@@ -0,0 +1,232 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef REARRANGEMENTLOG_HPP_
+#define REARRANGEMENTLOG_HPP_
+
+#include "OutputFileHandler.hpp"
+#include "VertexBasedCellPopulation.hpp"
+
+#include <map>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * A log of the T1 (neighbour exchange) and T2 (cell extrusion) events
+ * of a VertexBasedCellPopulation, with running rearrangement
+ * statistics, used by OutputCadenceVertexBasedCellPopulation.
+ *
+ * The mesh records the location of each T1 swap and the population
+ * the location and cell id of each T2 swap, but not which cells change
+ * neighbours. Whenever a population Update() adds swap locations, the
+ * neighbours of the cells around each swap are recomputed and
+ * compared with those before the update. These are the cells of the
+ * elements containing the nodes nearest the swap location: the two
+ * nodes of the new edge of a T1 swap (placed either side of its
+ * location), or the node replacing the element removed by a T2 swap
+ * (placed at its location). Each T1 is matched to the newly adjacent pair of
+ * cells whose shared edge is nearest its location, and to the pair of
+ * their common neighbours that are no longer adjacent.
+ *
+ * Every event is appended to a binary file, rearrangements.bin, with
+ * the layout
+ *
+ *   file header:
+ *     char[8]   magic "ERKREARR" followed by '<' or '>' (byte order)
+ *     uint32    format version (1)
+ *     uint32    size of each event record in bytes (56)
+ *
+ *   per event:
+ *     float64   simulation time
+ *     float64   x, y of the swap location
+ *     uint32    type (1 for T1, 2 for T2)
+ *     uint32    indices of the two nodes of the new edge (T1 only)
+ *     uint32    ids of the two cells gaining contact (T1) or the removed cell (T2)
+ *     uint32    ids of the two cells losing contact (T1 only)
+ *     uint32    padding
+ *
+ * with UNSET for any unused or unmatched index. When the log is closed
+ * the T1 rate per cell and a histogram of the number of neighbour
+ * changes of each cell are written to rearrangements.dat.
+ */
+template<unsigned DIM>
+class RearrangementLog
+{
+public:
+
+    /** Marks an unused node index or cell id in an event record. */
+    static const uint32_t UNSET = 0xFFFFFFFF;
+
+    /** The layout of one event in rearrangements.bin. */
+    struct EventRecord
+    {
+        /** Simulation time. */
+        double mTime;
+
+        /** Location of the swap. */
+        double mLocation[2];
+
+        /** 1 for a T1 swap, 2 for a T2 swap. */
+        uint32_t mType;
+
+        /** Indices of the nodes of the new edge. */
+        uint32_t mNodes[2];
+
+        /** Ids of the cells gaining contact, then of those losing it. */
+        uint32_t mCells[4];
+
+        /** Padding to a multiple of 8 bytes. */
+        uint32_t mPadding;
+    };
+
+private:
+
+    /** The event file. */
+    out_stream mpEventFile;
+
+    /** The summary file, written when the log is closed. */
+    out_stream mpSummaryFile;
+
+    /** Simulation time when the log was opened. */
+    double mStartTime;
+
+    /** The number of T1 swap locations held by the mesh before the current update. */
+    unsigned mNumT1LocationsBefore;
+
+    /** The number of T2 swap locations of the population already logged. */
+    unsigned mNumT2LocationsLogged;
+
+    /**
+     * The sorted neighbour cell ids of each cell, indexed by cell id,
+     * after the last event. Empty for ids without a cell.
+     */
+    std::vector<std::vector<unsigned> > mNeighbours;
+
+    /** The number of T1 swaps logged. */
+    unsigned mNumT1Swaps;
+
+    /** The number of T2 swaps logged. */
+    unsigned mNumT2Swaps;
+
+    /** The number of T1 swaps each cell has taken part in, by cell id. */
+    std::map<unsigned, unsigned> mCellT1Swaps;
+
+    /** The number of neighbours each cell has gained or lost, by cell id. */
+    std::map<unsigned, unsigned> mCellNeighbourChanges;
+
+    /**
+     * Compute the neighbours of one cell.
+     *
+     * @param rCellPopulation the cell population
+     * @param elementIndex the element index of the cell
+     * @param rNeighbours filled with the sorted neighbour cell ids of the cell
+     */
+    void ComputeNeighbours(VertexBasedCellPopulation<DIM>& rCellPopulation,
+                           unsigned elementIndex,
+                           std::vector<unsigned>& rNeighbours);
+
+    /**
+     * Add the elements containing the nodes nearest a location.
+     *
+     * @param rMesh the mesh
+     * @param rLocation the location
+     * @param numNodes the number of nearest nodes (1 or 2)
+     * @param rElementIndices the element indices to add to
+     */
+    void AddElementsNearLocation(MutableVertexMesh<DIM, DIM>& rMesh,
+                                 const c_vector<double, DIM>& rLocation,
+                                 unsigned numNodes,
+                                 std::vector<unsigned>& rElementIndices);
+
+    /**
+     * Append an event to the event file.
+     *
+     * @param rEvent the event
+     */
+    void WriteEvent(const EventRecord& rEvent);
+
+public:
+
+    /**
+     * Constructor. Opens rearrangements.bin and rearrangements.dat,
+     * overwriting any previous log.
+     *
+     * @param rOutputFileHandler handler for the output directory
+     */
+    RearrangementLog(OutputFileHandler& rOutputFileHandler);
+
+    /**
+     * Destructor.
+     */
+    ~RearrangementLog();
+
+    /**
+     * Note the swaps already recorded, before the population is updated.
+     *
+     * @param rCellPopulation the cell population
+     */
+    void BeginUpdate(VertexBasedCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Log the swaps made by the update.
+     *
+     * @param rCellPopulation the cell population
+     */
+    void EndUpdate(VertexBasedCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Write the summary statistics and close the event file.
+     *
+     * @param numCells the number of cells in the population
+     */
+    void Close(unsigned numCells);
+
+    /**
+     * @return the number of T1 swaps logged
+     */
+    unsigned GetNumT1Swaps() const;
+
+    /**
+     * @return the number of T2 swaps logged
+     */
+    unsigned GetNumT2Swaps() const;
+
+    /**
+     * @param cellId the id of a cell
+     * @return the number of logged T1 swaps that cell took part in
+     */
+    unsigned GetNumT1Swaps(unsigned cellId) const;
+};
+
+#endif /*REARRANGEMENTLOG_HPP_*/
@@ -36,6 +36,14 @@ void SelfPropulsionForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>&
       EXCEPTION("SelfPropulsionForce is to be used with a VertexBasedCellPopulation only");
     }
 
+  // A term with zero amplitude adds nothing, so skip it altogether
+  // (rGetNodeForces() is then empty)
+  if (GetF0() == 0.0)
+    {
+      mNodeForces.clear();
+      return;
+    }
+
   // Define some helper variables
   VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
   unsigned num_nodes = p_cell_population->GetNumNodes();
@@ -65,6 +73,7 @@ void SelfPropulsionForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>&
     }
 
   // Iterate over vertices in the cell population
+  mNodeForces.resize(num_nodes);
   for (unsigned node_index=0; node_index<num_nodes; node_index++)
     {
 
@@ -89,10 +98,17 @@ void SelfPropulsionForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>&
 	}
       // Multiply the unit vector by the force magnitude
       propulsion_contribution = GetF0()*propulsion_contribution;
+      mNodeForces[node_index] = propulsion_contribution;
       p_cell_population->GetNode(node_index)->AddAppliedForceContribution(propulsion_contribution);
     }
 }
 
+template<unsigned DIM>
+const std::vector<c_vector<double, DIM> >& SelfPropulsionForce<DIM>::rGetNodeForces() const
+{
+    return mNodeForces;
+}
+
 template<unsigned DIM>
 void SelfPropulsionForce<DIM>::OutputForceParameters(out_stream& rParamsFile)
 {
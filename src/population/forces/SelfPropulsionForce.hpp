@@ -32,6 +32,13 @@ private :
    */
   double mF0;
 
+  /**
+   * The propulsion force on each node, indexed by node index, as
+   * added during the last call to AddForceContribution(). Empty if
+   * mF0 is zero. Not archived.
+   */
+  std::vector<c_vector<double, DIM> > mNodeForces;
+
   /**
    * Archiving.
    */
@@ -83,6 +90,12 @@ public :
    */
   void AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation);
 
+  /**
+   * @return the propulsion force on each node from the last call to
+   * AddForceContribution(), indexed by node index
+   */
+  const std::vector<c_vector<double, DIM> >& rGetNodeForces() const;
+
   /**
    * Overridden OutputForceParameters() method.
    *
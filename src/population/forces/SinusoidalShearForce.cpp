@@ -35,12 +35,21 @@ void SinusoidalShearForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>
       EXCEPTION("SinusoidalShearForce is to be used with a VertexBasedCellPopulation only");
     }
 
+  // A term with zero amplitude adds nothing, so skip it altogether
+  // (rGetNodeForces() is then empty)
+  if (GetF1() == 0.0)
+    {
+      mNodeForces.clear();
+      return;
+    }
+
   // Define some helper variables
   VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
   unsigned num_nodes = p_cell_population->GetNumNodes();
 
   // Should equal N*(3/4)**(1/4) for periodic bcs (toroidal) with unit cell area
   double width = p_cell_population->GetWidth(1);    // Height
+  mNodeForces.resize(num_nodes);
 
   // Iterate over vertices in the cell population
   for (unsigned node_index=0; node_index<num_nodes; node_index++)
@@ -56,11 +65,18 @@ void SinusoidalShearForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>
       location_node = p_cell_population->GetNode(node_index)->rGetLocation();
 
       force[0] = GetF1() * sin(2 * M_PI * location_node[1] / width);
+      mNodeForces[node_index] = force;
 
       p_cell_population->GetNode(node_index)->AddAppliedForceContribution(force);
     }
 }
 
+template<unsigned DIM>
+const std::vector<c_vector<double, DIM> >& SinusoidalShearForce<DIM>::rGetNodeForces() const
+{
+    return mNodeForces;
+}
+
 template<unsigned DIM>
 void SinusoidalShearForce<DIM>::OutputForceParameters(out_stream& rParamsFile)
 {
@@ -16,6 +16,13 @@ private:
 
   double mF1;
 
+  /**
+   * The shear force on each node, indexed by node index, as added
+   * during the last call to AddForceContribution(). Empty if mF1 is
+   * zero. Not archived.
+   */
+  std::vector<c_vector<double, DIM> > mNodeForces;
+
     friend class boost::serialization::access;
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
@@ -39,6 +46,12 @@ public:
 
     void AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation);
 
+    /**
+     * @return the shear force on each node from the last call to
+     * AddForceContribution(), indexed by node index
+     */
+    const std::vector<c_vector<double, DIM> >& rGetNodeForces() const;
+
     void OutputForceParameters(out_stream& rParamsFile);
 
 };
@@ -33,6 +33,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 */
 #include "TargetAreaAndNematicPerimeterForce.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "ReorderableToroidal2dVertexMesh.hpp"
+
+#include <cfloat>
 
 template<unsigned DIM>
 TargetAreaAndNematicPerimeterForce<DIM>::TargetAreaAndNematicPerimeterForce()
@@ -40,7 +44,12 @@ TargetAreaAndNematicPerimeterForce<DIM>::TargetAreaAndNematicPerimeterForce()
      mKA(0.0),
      mKP(0.0),
      mP0(1.0),
-     mLambda(0.0)    // Strength of coupling between cell elongation and line tension
+     mLambda(0.0),    // Strength of coupling between cell elongation and line tension
+     mUseEdgeAssembly(false),
+     mElementShapesCurrent(false),
+     mLocalNodeLocationsCurrent(false),
+     mAreaEnergy(0.0),
+     mPerimeterEnergy(0.0)
 {
 }
 
@@ -60,21 +69,41 @@ void TargetAreaAndNematicPerimeterForce<DIM>::AddForceContribution(AbstractCellP
 
     // Define some helper variables
     VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
-    unsigned num_nodes = p_cell_population->GetNumNodes();
     unsigned num_elements = p_cell_population->GetNumElements();
 
+    // Unwrap the nodes of each element across the periodic
+    // boundaries once, so that all the geometry below is computed
+    // from plain coordinates
+    UpdateLocalNodeLocations(*p_cell_population);
+
     // Begin by computing the area and perimeter of each element in
-    // the mesh, to avoid having to do this multiple times
+    // the mesh, to avoid having to do this multiple times. The
+    // elastic energies are summed on the way for monitoring.
+    mAreaEnergy = 0.0;
+    mPerimeterEnergy = 0.0;
     std::vector<double> element_areas(num_elements);
     std::vector<double> element_perimeters(num_elements);
     std::vector<double> target_areas(num_elements);
+    mSignedElementAreas.resize(num_elements);
     for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = p_cell_population->rGetMesh().GetElementIteratorBegin();
          elem_iter != p_cell_population->rGetMesh().GetElementIteratorEnd();
          ++elem_iter)
     {
         unsigned elem_index = elem_iter->GetIndex();
-        element_areas[elem_index] = p_cell_population->rGetMesh().GetVolumeOfElement(elem_index);
-        element_perimeters[elem_index] = p_cell_population->rGetMesh().GetSurfaceAreaOfElement(elem_index);
+        const c_vector<double, DIM>* p_local = &mLocalNodeLocations[mLocalNodeOffsets[elem_index]];
+        unsigned num_nodes_elem = mLocalNodeOffsets[elem_index+1] - mLocalNodeOffsets[elem_index];
+        double area = 0.0;
+        double perimeter = 0.0;
+        for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+        {
+            const c_vector<double, DIM>& r_this = p_local[local_index];
+            const c_vector<double, DIM>& r_next = p_local[(local_index+1)%num_nodes_elem];
+            area += 0.5*(r_this[0]*r_next[1] - r_next[0]*r_this[1]);
+            perimeter += norm_2(r_next - r_this);
+        }
+        mSignedElementAreas[elem_index] = area;
+        element_areas[elem_index] = fabs(area);
+        element_perimeters[elem_index] = perimeter;
 
 	//TODO: Currently a bit of a hack to save perimeters to
 	//CellData here. Should be performed inside
@@ -99,46 +128,59 @@ void TargetAreaAndNematicPerimeterForce<DIM>::AddForceContribution(AbstractCellP
             EXCEPTION("In order to use TargetAreaAndNematicPerimeterForce you need to assign each cell a 'Traget Area', e.g. by adding a ErkPropulsionModifierNoAlignment to the simulation");
         }
 
+        double area_deviation = element_areas[elem_index] - target_areas[elem_index];
+        double perimeter_deviation = element_perimeters[elem_index] - GetP0();
+        mAreaEnergy += GetKA()*area_deviation*area_deviation;
+        mPerimeterEnergy += GetKP()*perimeter_deviation*perimeter_deviation;
 
     }
 
-    // std::vector<c_vector<double, DIM>> short_axis(num_elements);    // Angle of major axis
-    std::vector<double> orientation(num_elements);    // Angle of short axis
-    std::vector<double> elongation_factor(num_elements);    // Ratio of eigenvalues for major and minor axes
-
-    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = p_cell_population->rGetMesh().GetElementIteratorBegin();
-         elem_iter != p_cell_population->rGetMesh().GetElementIteratorEnd();
-         ++elem_iter)
+    // Compute the elongation factor and orientation of each element
+    // in a single pass over the shape tensors, cached so that they
+    // can be reused by the output modifiers. This is done even
+    // without the nematic term: isotropic elements draw a random
+    // axis, and skipping those draws would change seeded trajectories.
+    ComputeElementShapes(*p_cell_population, true);
+    mElementShapesCurrent = true;
+
+    // Pick the force kernel with only the terms that are present
+    bool has_nematic_term = (GetLambda() != 0.0);
+    mLocalNodeLocationsCurrent = true;
+
+    // Assemble the forces edge by edge if the mesh provides the edges
+    ReorderableToroidal2dVertexMesh* p_half_edge_mesh = dynamic_cast<ReorderableToroidal2dVertexMesh*>(&(p_cell_population->rGetMesh()));
+    if (mUseEdgeAssembly && p_half_edge_mesh != nullptr)
     {
-      unsigned elem_index = elem_iter->GetIndex();
-      elongation_factor[elem_index] = p_cell_population->rGetMesh().GetElongationShapeFactorOfElement(elem_index);
-      c_vector<double, DIM> s_ax = p_cell_population->rGetMesh().GetShortAxisOfElement(elem_index);
-      orientation[elem_index] = atan2(s_ax[1], s_ax[0]);
-      // short_axis[elem_index] = p_cell_population->rGetMesh().GetShortAxisOfElement(elem_index);
+        const HalfEdgeMeshView& r_half_edges = p_half_edge_mesh->rGetHalfEdges();
+        if (has_nematic_term)
+        {
+            AddForceContributionOverEdges<true>(*p_cell_population, r_half_edges, element_areas, element_perimeters, target_areas);
+        }
+        else
+        {
+            AddForceContributionOverEdges<false>(*p_cell_population, r_half_edges, element_areas, element_perimeters, target_areas);
+        }
     }
+    else if (has_nematic_term)
+    {
+        AddForceContributionOverNodes<true>(*p_cell_population, element_areas, element_perimeters, target_areas);
+    }
+    else
+    {
+        AddForceContributionOverNodes<false>(*p_cell_population, element_areas, element_perimeters, target_areas);
+    }
+}
 
-    // TODO: Redo the above by iterating over cells and then finding
-    // the element so that we can add orientation and
-    // elongation_factor to CellData here rather than in
-    // the CellTensionModifier
-    // for (typename VertexBasedCellPopulation<DIM>::Iterator cell_iter = p_cell_population->Begin();
-    //      cell_iter != p_cell_population->End();
-    //      ++cell_iter)
-    //   {
-    // 	VertexElement<DIM,DIM>* elem = p_cell_population->GetElementCorrespondingToCell(cell_iter);
-    // 	unsigned elem_index = elem->GetIndex();
-    // 	// unsigned elem_index = p_cell_population->GetElementCorrespondingToCell(cell_iter)->GetIndex();
-    // 	elongation_factor[elem_index] = p_cell_population->rGetMesh().GetElongationShapeFactorOfElement(elem_index);
-    // 	c_vector<double,DIM> s_ax = p_cell_population->rGetMesh().GetShortAxisOfElement(elem_index);
-    // 	orientation[elem_index] = atan2(s_ax[1], s_ax[0]);
-
-    // 	cell_iter->GetCellData()->SetItem("elongation", elongation_factor[elem_index]);
-    // 	cell_iter->GetCellData()->SetItem("orientation", orientation[elem_index]);
-    //   }
-
-
-
+template<unsigned DIM>
+template<bool NEMATIC>
+void TargetAreaAndNematicPerimeterForce<DIM>::AddForceContributionOverNodes(VertexBasedCellPopulation<DIM>& rCellPopulation,
+                                                                           const std::vector<double>& rElementAreas,
+                                                                           const std::vector<double>& rElementPerimeters,
+                                                                           const std::vector<double>& rTargetAreas)
+{
     // Iterate over vertices in the cell population
+    unsigned num_nodes = rCellPopulation.GetNumNodes();
+    mNematicNodeForces.resize(NEMATIC ? num_nodes : 0);
     for (unsigned node_index=0; node_index<num_nodes; node_index++)
     {
         /*
@@ -161,7 +203,7 @@ void TargetAreaAndNematicPerimeterForce<DIM>::AddForceContribution(AbstractCellP
 	c_vector<double, DIM> nematic_contribution = zero_vector<double>(DIM);
 
         // Find the indices of the elements owned by this node
-        std::set<unsigned> containing_elem_indices = p_cell_population->GetNode(node_index)->rGetContainingElementIndices();
+        std::set<unsigned> containing_elem_indices = rCellPopulation.GetNode(node_index)->rGetContainingElementIndices();
 
         // Iterate over these elements
         for (std::set<unsigned>::iterator iter = containing_elem_indices.begin();
@@ -169,38 +211,49 @@ void TargetAreaAndNematicPerimeterForce<DIM>::AddForceContribution(AbstractCellP
              ++iter)
         {
             // Get this element, its index and its number of nodes
-            VertexElement<DIM, DIM>* p_element = p_cell_population->GetElement(*iter);
+            VertexElement<DIM, DIM>* p_element = rCellPopulation.GetElement(*iter);
             unsigned elem_index = p_element->GetIndex();
             unsigned num_nodes_elem = p_element->GetNumNodes();
+            const c_vector<double, DIM>* p_local = &mLocalNodeLocations[mLocalNodeOffsets[elem_index]];
 
             // Find the local index of this node in this element
             unsigned local_index = p_element->GetNodeLocalIndex(node_index);
 
-            // Add the force contribution from this cell's perferred area term
-            c_vector<double, DIM> element_area_gradient = p_cell_population->rGetMesh().GetAreaGradientOfElementAtNode(p_element, local_index);
-            area_contribution -= 2*GetKA()*(element_areas[elem_index] - target_areas[elem_index])*element_area_gradient;
-
             // Local index of the previous node connected to this node
             // (previous in index order) within this element
             unsigned previous_node_local_index = (num_nodes_elem+local_index-1)%num_nodes_elem;
 	    // Local index of the next node (next in index order)
 	    unsigned next_node_local_index = (local_index+1)%num_nodes_elem;
 
-            // Compute the gradient of each these edges, computed at the present node
-            c_vector<double, DIM> previous_edge_gradient = -p_cell_population->rGetMesh().GetNextEdgeGradientOfElementAtNode(p_element, previous_node_local_index);
-            c_vector<double, DIM> next_edge_gradient = p_cell_population->rGetMesh().GetNextEdgeGradientOfElementAtNode(p_element, local_index);
+	    // Get vectors along the two edges connecting this node
+	    // within this element
+	    c_vector<double, DIM> previous_vec = p_local[previous_node_local_index] - p_local[local_index];
+	    c_vector<double, DIM> next_vec = p_local[next_node_local_index] - p_local[local_index];
+
+            // Add the force contribution from this cell's perferred
+            // area term (as VertexMesh::GetAreaGradientOfElementAtNode())
+            c_vector<double, DIM> element_area_gradient = zero_vector<double>(DIM);
+            element_area_gradient[0] = 0.5*(next_vec[1] - previous_vec[1]);
+            element_area_gradient[1] = -0.5*(next_vec[0] - previous_vec[0]);
+            area_contribution -= 2*GetKA()*(rElementAreas[elem_index] - rTargetAreas[elem_index])*element_area_gradient;
+
+            // Compute the gradient of each these edges, computed at
+            // the present node (unit vectors from the neighbours)
+            c_vector<double, DIM> previous_edge_gradient = -previous_vec/norm_2(previous_vec);
+            c_vector<double, DIM> next_edge_gradient = -next_vec/norm_2(next_vec);
 
 	    // Get a vector for the short axis of the element
 	    // Get the elongation factor of the element
 
             // Add the force contribution from this cell's perferred perimeter term
             c_vector<double, DIM> element_perimeter_gradient = previous_edge_gradient + next_edge_gradient;
-	    perimeter_contribution -= 2*GetKP()*(element_perimeters[elem_index] - GetP0())*element_perimeter_gradient;
+	    perimeter_contribution -= 2*GetKP()*(rElementPerimeters[elem_index] - GetP0())*element_perimeter_gradient;
 
-	    // Get vectors along the two edges connecting this node
-	    // within this element
-	    c_vector<double, DIM> previous_vec = p_cell_population->rGetMesh().GetVectorFromAtoB(p_element->GetNodeLocation(local_index), p_element->GetNodeLocation(previous_node_local_index));
-	    c_vector<double, DIM> next_vec = p_cell_population->rGetMesh().GetVectorFromAtoB(p_element->GetNodeLocation(local_index), p_element->GetNodeLocation(next_node_local_index));
+	    // The rest is the nematic term, compiled out when Lambda is zero
+	    if (!NEMATIC)
+	    {
+	        continue;
+	    }
 
 	    // The angle of orientation of the edges connected to the
 	    // vertex
@@ -221,14 +274,339 @@ void TargetAreaAndNematicPerimeterForce<DIM>::AddForceContribution(AbstractCellP
 	    // hexagon has elongation factor 1, whereas a 2x1
 	    // rectangle has elongation factor 2 so that there is only
 	    // non-zero nematic contribution for regular polygons
-	    nematic_contribution += GetLambda()*(elongation_factor[elem_index]-1)*cos(2*(orientation[elem_index] - previous_edge_orientation))*previous_edge_gradient;
-	    nematic_contribution += GetLambda()*(elongation_factor[elem_index]-1)*cos(2*(orientation[elem_index] - next_edge_orientation))*next_edge_gradient;
+	    nematic_contribution += GetLambda()*(mElongationFactors[elem_index]-1)*cos(2*(mOrientations[elem_index] - previous_edge_orientation))*previous_edge_gradient;
+	    nematic_contribution += GetLambda()*(mElongationFactors[elem_index]-1)*cos(2*(mOrientations[elem_index] - next_edge_orientation))*next_edge_gradient;
 	}
         c_vector<double, DIM> force_on_node = area_contribution + perimeter_contribution + nematic_contribution;
-        p_cell_population->GetNode(node_index)->AddAppliedForceContribution(force_on_node);
+        if (NEMATIC)
+        {
+            mNematicNodeForces[node_index] = nematic_contribution;
+        }
+        rCellPopulation.GetNode(node_index)->AddAppliedForceContribution(force_on_node);
+    }
+}
+
+template<unsigned DIM>
+template<bool NEMATIC>
+void TargetAreaAndNematicPerimeterForce<DIM>::AddForceContributionOverEdges(VertexBasedCellPopulation<DIM>& rCellPopulation,
+                                                                           const HalfEdgeMeshView& rHalfEdges,
+                                                                           const std::vector<double>& rElementAreas,
+                                                                           const std::vector<double>& rElementPerimeters,
+                                                                           const std::vector<double>& rTargetAreas)
+{
+    // The half-edges are numbered element by element in node order,
+    // exactly as mLocalNodeLocations, so the unwrapped location of the
+    // origin of half-edge h is mLocalNodeLocations[h]
+    if (rHalfEdges.GetNumHalfEdges() != mLocalNodeLocations.size())
+    {
+        EXCEPTION("The half-edges of the mesh do not match its elements");
+    }
+
+    // The forces are accumulated in plain (x, y) pairs
+    unsigned num_nodes = rCellPopulation.GetNumNodes();
+    std::vector<double> node_forces(2*num_nodes, 0.0);
+    std::vector<double> nematic_node_forces(NEMATIC ? 2*num_nodes : 0, 0.0);
+
+    // The area term acts at each corner of each element
+    for (unsigned half_edge=0; half_edge<rHalfEdges.GetNumHalfEdges(); half_edge++)
+    {
+        unsigned elem_index = rHalfEdges.GetFace(half_edge);
+        const c_vector<double, DIM>& r_next = mLocalNodeLocations[rHalfEdges.GetNext(half_edge)];
+        const c_vector<double, DIM>& r_previous = mLocalNodeLocations[rHalfEdges.GetPrevious(half_edge)];
+        double coefficient = -2*GetKA()*(rElementAreas[elem_index] - rTargetAreas[elem_index]);
+        unsigned origin = rHalfEdges.GetOrigin(half_edge);
+        node_forces[2*origin] += coefficient*0.5*(r_next[1] - r_previous[1]);
+        node_forces[2*origin+1] -= coefficient*0.5*(r_next[0] - r_previous[0]);
+    }
+
+    /*
+     * The perimeter and nematic terms are line tensions: an edge of
+     * length L and direction u (from its origin to its destination)
+     * with tension T pulls its origin by T*u and its destination by
+     * -T*u. The tension is the sum over the (one or two) elements on
+     * either side of 2*KP*(P - P0) - Lambda*(elongation - 1)*cos(2*(orientation - edge angle)),
+     * so each edge's direction and angle are computed once.
+     */
+    const std::vector<unsigned>& r_edges = rHalfEdges.rGetEdges();
+    for (unsigned edge_index=0; edge_index<r_edges.size(); edge_index++)
+    {
+        unsigned half_edge = r_edges[edge_index];
+        const c_vector<double, DIM>& r_origin = mLocalNodeLocations[half_edge];
+        const c_vector<double, DIM>& r_destination = mLocalNodeLocations[rHalfEdges.GetNext(half_edge)];
+        double edge_x = r_destination[0] - r_origin[0];
+        double edge_y = r_destination[1] - r_origin[1];
+        double length = sqrt(edge_x*edge_x + edge_y*edge_y);
+        double direction_x = edge_x/length;
+        double direction_y = edge_y/length;
+        double edge_orientation = NEMATIC ? atan2(edge_y, edge_x) : 0.0;
+
+        double perimeter_tension = 0.0;
+        double nematic_tension = 0.0;
+        for (unsigned side=0; side<2; side++)
+        {
+            unsigned side_half_edge = (side == 0) ? half_edge : rHalfEdges.GetTwin(half_edge);
+            if (side_half_edge == HalfEdgeMeshView::NONE)
+            {
+                continue;
+            }
+            unsigned elem_index = rHalfEdges.GetFace(side_half_edge);
+            perimeter_tension += 2*GetKP()*(rElementPerimeters[elem_index] - GetP0());
+            if (NEMATIC)
+            {
+                nematic_tension -= GetLambda()*(mElongationFactors[elem_index]-1)*cos(2*(mOrientations[elem_index] - edge_orientation));
+            }
+        }
+
+        unsigned origin = rHalfEdges.GetOrigin(half_edge);
+        unsigned destination = rHalfEdges.GetDestination(half_edge);
+        double tension = perimeter_tension + nematic_tension;
+        node_forces[2*origin] += tension*direction_x;
+        node_forces[2*origin+1] += tension*direction_y;
+        node_forces[2*destination] -= tension*direction_x;
+        node_forces[2*destination+1] -= tension*direction_y;
+        if (NEMATIC)
+        {
+            nematic_node_forces[2*origin] += nematic_tension*direction_x;
+            nematic_node_forces[2*origin+1] += nematic_tension*direction_y;
+            nematic_node_forces[2*destination] -= nematic_tension*direction_x;
+            nematic_node_forces[2*destination+1] -= nematic_tension*direction_y;
+        }
+    }
+
+    mNematicNodeForces.resize(NEMATIC ? num_nodes : 0);
+    for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+        c_vector<double, DIM> force = zero_vector<double>(DIM);
+        force[0] = node_forces[2*node_index];
+        force[1] = node_forces[2*node_index+1];
+        rCellPopulation.GetNode(node_index)->AddAppliedForceContribution(force);
+        if (NEMATIC)
+        {
+            mNematicNodeForces[node_index] = zero_vector<double>(DIM);
+            mNematicNodeForces[node_index][0] = nematic_node_forces[2*node_index];
+            mNematicNodeForces[node_index][1] = nematic_node_forces[2*node_index+1];
+        }
+    }
+}
+
+template<unsigned DIM>
+void TargetAreaAndNematicPerimeterForce<DIM>::UpdateLocalNodeLocations(VertexBasedCellPopulation<DIM>& rCellPopulation)
+{
+    unsigned num_elements = rCellPopulation.GetNumElements();
+    mLocalNodeOffsets.resize(num_elements + 1);
+    mLocalNodeOffsets[0] = 0;
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        mLocalNodeOffsets[elem_index+1] = mLocalNodeOffsets[elem_index] + rCellPopulation.GetElement(elem_index)->GetNumNodes();
+    }
+    mLocalNodeLocations.resize(mLocalNodeOffsets[num_elements]);
+
+    // The only periodic corrections: each node relative to the first
+    // node of the element
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+        VertexElement<DIM, DIM>* p_element = rCellPopulation.GetElement(elem_index);
+        const c_vector<double, DIM>& r_first_location = p_element->GetNodeLocation(0);
+        c_vector<double, DIM>* p_local = &mLocalNodeLocations[mLocalNodeOffsets[elem_index]];
+        p_local[0] = zero_vector<double>(DIM);
+        for (unsigned local_index=1; local_index<p_element->GetNumNodes(); local_index++)
+        {
+            p_local[local_index] = rCellPopulation.rGetMesh().GetVectorFromAtoB(r_first_location, p_element->GetNodeLocation(local_index));
+        }
+    }
+}
+
+template<unsigned DIM>
+void TargetAreaAndNematicPerimeterForce<DIM>::UpdateElementShapesForOutput(VertexBasedCellPopulation<DIM>& rCellPopulation)
+{
+    // A swap in ReMesh() since the force was evaluated (the
+    // ErkPropulsionModifier updates the population at the end of the
+    // time step) changes the elements, so the cached locations and
+    // shapes no longer apply
+    unsigned num_elements = rCellPopulation.GetNumElements();
+    bool elements_unchanged = (mLocalNodeOffsets.size() == num_elements + 1);
+    for (unsigned elem_index=0; elements_unchanged && elem_index<num_elements; elem_index++)
+    {
+        elements_unchanged = (mLocalNodeOffsets[elem_index+1] - mLocalNodeOffsets[elem_index] == rCellPopulation.GetElement(elem_index)->GetNumNodes());
+    }
+
+    if (mElementShapesCurrent && elements_unchanged && mElongationFactors.size() == num_elements)
+    {
+        return;
+    }
+    if (!mLocalNodeLocationsCurrent || !elements_unchanged)
+    {
+        UpdateLocalNodeLocations(rCellPopulation);
+    }
+    ComputeElementShapes(rCellPopulation, false);
+    mElementShapesCurrent = true;
+}
+
+template<unsigned DIM>
+void TargetAreaAndNematicPerimeterForce<DIM>::ComputeElementShapes(VertexBasedCellPopulation<DIM>& rCellPopulation, bool drawIsotropicAxes)
+{
+    unsigned num_elements = rCellPopulation.GetNumElements();
+    mElongationFactors.resize(num_elements);
+    mOrientations.resize(num_elements);
+
+    for (typename VertexMesh<DIM,DIM>::VertexElementIterator elem_iter = rCellPopulation.rGetMesh().GetElementIteratorBegin();
+         elem_iter != rCellPopulation.rGetMesh().GetElementIteratorEnd();
+         ++elem_iter)
+    {
+      unsigned elem_index = elem_iter->GetIndex();
+
+      // Second moments of area of the element about its centroid
+      // (I_xx, I_yy, I_xy). GetElongationShapeFactorOfElement() and
+      // GetShortAxisOfElement() each recompute these so we compute
+      // them once, from the unwrapped node locations, and follow
+      // both methods from here.
+      c_vector<double, 3> moments = CalculateMomentsOfElement(elem_index);
+
+      // Elongation factor from the eigenvalues of the shape tensor
+      double discriminant = sqrt((moments(0) - moments(1))*(moments(0) - moments(1)) + 4.0*moments(2)*moments(2));
+      double largest_eigenvalue = (moments(0) + moments(1) + discriminant)*0.5;
+      double smallest_eigenvalue = (moments(0) + moments(1) - discriminant)*0.5;
+      mElongationFactors[elem_index] = sqrt(largest_eigenvalue/smallest_eigenvalue);
+
+      // Short axis from the normalised moments exactly as in
+      // GetShortAxisOfElement(). The force includes its random draw
+      // for isotropic elements, so that seeded runs are unchanged.
+      c_vector<double, 2> s_ax = zero_vector<double>(2);
+      moments /= norm_2(moments);
+      double normalised_discriminant = (moments(0) - moments(1))*(moments(0) - moments(1)) + 4.0*moments(2)*moments(2);
+      if (fabs(normalised_discriminant) < DBL_EPSILON)
+      {
+        // Every axis through the centroid is a principal axis
+        if (drawIsotropicAxes)
+        {
+          s_ax(0) = RandomNumberGenerator::Instance()->ranf();
+          s_ax(1) = sqrt(1.0 - s_ax(0)*s_ax(0));
+        }
+        else
+        {
+          s_ax(0) = 1.0;
+          s_ax(1) = 0.0;
+        }
+      }
+      else if (fabs(moments(2)) < DBL_EPSILON)
+      {
+        // The coordinate axes are the principal axes
+        if (moments(0) < moments(1))
+        {
+          s_ax(0) = 0.0;
+          s_ax(1) = 1.0;
+        }
+        else
+        {
+          s_ax(0) = 1.0;
+          s_ax(1) = 0.0;
+        }
+      }
+      else
+      {
+        // Eigenvector of the largest eigenvalue of the inertia matrix
+        double lambda = 0.5*(moments(0) + moments(1) + sqrt(normalised_discriminant));
+        s_ax(0) = 1.0;
+        s_ax(1) = (moments(0) - lambda)/moments(2);
+        s_ax /= norm_2(s_ax);
+      }
+      mOrientations[elem_index] = atan2(s_ax(1), s_ax(0));
     }
 }
 
+template<unsigned DIM>
+c_vector<double, 3> TargetAreaAndNematicPerimeterForce<DIM>::CalculateMomentsOfElement(unsigned elemIndex) const
+{
+    const c_vector<double, DIM>* p_local = &mLocalNodeLocations[mLocalNodeOffsets[elemIndex]];
+    unsigned num_nodes_elem = mLocalNodeOffsets[elemIndex+1] - mLocalNodeOffsets[elemIndex];
+
+    // Centroid, as in VertexMesh::GetCentroidOfElement()
+    double area = 0.0;
+    c_vector<double, DIM> centroid = zero_vector<double>(DIM);
+    for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+    {
+        const c_vector<double, DIM>& r_this = p_local[local_index];
+        const c_vector<double, DIM>& r_next = p_local[(local_index+1)%num_nodes_elem];
+        double signed_area_term = r_this[0]*r_next[1] - r_this[1]*r_next[0];
+        centroid[0] += (r_this[0] + r_next[0])*signed_area_term;
+        centroid[1] += (r_this[1] + r_next[1])*signed_area_term;
+        area += 0.5*signed_area_term;
+    }
+    assert(area != 0.0);
+    centroid /= 6.0*area;
+
+    // Moments about the centroid, as in VertexMesh::CalculateMomentsOfElement()
+    c_vector<double, 3> moments = zero_vector<double>(3);
+    c_vector<double, DIM> pos_1 = p_local[0] - centroid;
+    for (unsigned local_index=0; local_index<num_nodes_elem; local_index++)
+    {
+        c_vector<double, DIM> pos_2 = p_local[(local_index+1)%num_nodes_elem] - centroid;
+        double signed_area_term = pos_1(0)*pos_2(1) - pos_2(0)*pos_1(1);
+        moments(0) += (pos_1(1)*pos_1(1) + pos_1(1)*pos_2(1) + pos_2(1)*pos_2(1))*signed_area_term;
+        moments(1) += (pos_1(0)*pos_1(0) + pos_1(0)*pos_2(0) + pos_2(0)*pos_2(0))*signed_area_term;
+        moments(2) += (pos_1(0)*pos_2(1) + 2*pos_1(0)*pos_1(1) + 2*pos_2(0)*pos_2(1) + pos_2(0)*pos_1(1))*signed_area_term;
+        pos_1 = pos_2;
+    }
+    moments(0) /= 12;
+    moments(1) /= 12;
+    moments(2) /= 24;
+
+    // Make the moments independent of the orientation of the nodes
+    if (moments(0) < 0.0)
+    {
+        moments = -moments;
+    }
+    return moments;
+}
+
+template<unsigned DIM>
+const std::vector<c_vector<double, DIM> >& TargetAreaAndNematicPerimeterForce<DIM>::rGetLocalNodeLocations() const
+{
+    return mLocalNodeLocations;
+}
+
+template<unsigned DIM>
+const std::vector<unsigned>& TargetAreaAndNematicPerimeterForce<DIM>::rGetLocalNodeOffsets() const
+{
+    return mLocalNodeOffsets;
+}
+
+template<unsigned DIM>
+const std::vector<double>& TargetAreaAndNematicPerimeterForce<DIM>::rGetElongationFactors() const
+{
+    return mElongationFactors;
+}
+
+template<unsigned DIM>
+const std::vector<double>& TargetAreaAndNematicPerimeterForce<DIM>::rGetOrientations() const
+{
+    return mOrientations;
+}
+
+template<unsigned DIM>
+double TargetAreaAndNematicPerimeterForce<DIM>::GetAreaEnergy() const
+{
+    return mAreaEnergy;
+}
+
+template<unsigned DIM>
+double TargetAreaAndNematicPerimeterForce<DIM>::GetPerimeterEnergy() const
+{
+    return mPerimeterEnergy;
+}
+
+template<unsigned DIM>
+const std::vector<double>& TargetAreaAndNematicPerimeterForce<DIM>::rGetSignedElementAreas() const
+{
+    return mSignedElementAreas;
+}
+
+template<unsigned DIM>
+const std::vector<c_vector<double, DIM> >& TargetAreaAndNematicPerimeterForce<DIM>::rGetNematicNodeForces() const
+{
+    return mNematicNodeForces;
+}
+
 template<unsigned DIM>
 double TargetAreaAndNematicPerimeterForce<DIM>::GetKA()
 {
@@ -253,6 +631,18 @@ double TargetAreaAndNematicPerimeterForce<DIM>::GetLambda()
     return mLambda;
 }
 
+template<unsigned DIM>
+bool TargetAreaAndNematicPerimeterForce<DIM>::GetUseEdgeAssembly()
+{
+    return mUseEdgeAssembly;
+}
+
+template<unsigned DIM>
+void TargetAreaAndNematicPerimeterForce<DIM>::SetUseEdgeAssembly(bool useEdgeAssembly)
+{
+    mUseEdgeAssembly = useEdgeAssembly;
+}
+
 template<unsigned DIM>
 void TargetAreaAndNematicPerimeterForce<DIM>::SetKA(double KA)
 {
@@ -283,16 +673,15 @@ void TargetAreaAndNematicPerimeterForce<DIM>::OutputForceParameters(out_stream&
     *rParamsFile << "\t\t\t<KA>" << mKA << "</KA>\n";
     *rParamsFile << "\t\t\t<KP>" << mKP << "</KP>\n";
     *rParamsFile << "\t\t\t<P0>" << mP0 << "</P0>\n";
+    *rParamsFile << "\t\t\t<UseEdgeAssembly>" << mUseEdgeAssembly << "</UseEdgeAssembly>\n";
 
     // Call method on direct parent class
     AbstractForce<DIM>::OutputForceParameters(rParamsFile);
 }
 
 // Explicit instantiation
-template class TargetAreaAndNematicPerimeterForce<1>;
 template class TargetAreaAndNematicPerimeterForce<2>;
-template class TargetAreaAndNematicPerimeterForce<3>;
 
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
-EXPORT_TEMPLATE_CLASS_SAME_DIMS(TargetAreaAndNematicPerimeterForce)
+EXPORT_TEMPLATE_CLASS1(TargetAreaAndNematicPerimeterForce, 2)
@@ -42,6 +42,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "AbstractForce.hpp"
 #include "VertexBasedCellPopulation.hpp"
+#include "HalfEdgeMeshView.hpp"
 
 #include <iostream>
 
@@ -76,6 +77,9 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * response to cell elongation. For positive mLambda line tensions
  * oppose elongation; for negative mLambda line tensions act to
  * encourage cell elongatation.
+ *
+ * The shape tensors and the assembly kernels use the x and y
+ * components explicitly, so the class is only instantiated for DIM=2.
  */
 template<unsigned DIM>
 class TargetAreaAndNematicPerimeterForce  : public AbstractForce<DIM>
@@ -100,6 +104,7 @@ private:
         archive & mKP;
         archive & mP0;
 	archive & mLambda;
+        archive & mUseEdgeAssembly;
     }
 
 protected:
@@ -126,6 +131,158 @@ protected:
     */
     double mLambda;
 
+    /**
+     * Whether to assemble the perimeter and nematic forces edge by
+     * edge, using the half-edges of a ReorderableToroidal2dVertexMesh,
+     * rather than node by node. Defaults to false.
+     */
+    bool mUseEdgeAssembly;
+
+    /**
+     * The elongation factor of each element, indexed by element
+     * index, as computed during the last call to
+     * AddForceContribution() or UpdateElementShapesForOutput(). Not
+     * archived.
+     */
+    std::vector<double> mElongationFactors;
+
+    /**
+     * The orientation (angle of the short axis) of each element,
+     * indexed by element index, as computed during the last call to
+     * AddForceContribution() or UpdateElementShapesForOutput(). Not
+     * archived.
+     */
+    std::vector<double> mOrientations;
+
+    /**
+     * Whether mElongationFactors and mOrientations hold the shapes
+     * for the node locations seen by the last call to
+     * AddForceContribution(), either computed there or since then by
+     * UpdateElementShapesForOutput(). Not archived.
+     */
+    bool mElementShapesCurrent;
+
+    /**
+     * Whether mLocalNodeLocations has been refreshed by a call to
+     * AddForceContribution(), so that UpdateElementShapesForOutput()
+     * can compute the shapes without unwrapping the elements again.
+     * Not archived.
+     */
+    bool mLocalNodeLocationsCurrent;
+
+    /**
+     * The total area energy sum KA(A-A0)^2 over cells, accumulated
+     * during the last call to AddForceContribution(). Not archived.
+     */
+    double mAreaEnergy;
+
+    /**
+     * The total perimeter energy sum KP(P-P0)^2 over cells,
+     * accumulated during the last call to AddForceContribution(). Not
+     * archived.
+     */
+    double mPerimeterEnergy;
+
+    /**
+     * The signed area of each element, indexed by element index,
+     * positive for elements whose nodes are ordered anticlockwise, as
+     * computed during the last call to AddForceContribution(). Not
+     * archived.
+     */
+    std::vector<double> mSignedElementAreas;
+
+    /**
+     * The nematic (active line tension) contribution to the force on
+     * each node, indexed by node index, as computed during the last
+     * call to AddForceContribution(). This term is not the gradient
+     * of an energy, so its work is measured from the power it
+     * delivers. Empty if mLambda is zero. Not archived.
+     */
+    std::vector<c_vector<double, DIM> > mNematicNodeForces;
+
+    /**
+     * The location of each node of each element relative to the
+     * first node of the element, unwrapped across any periodic
+     * boundaries, stored element by element (see mLocalNodeOffsets).
+     * Refreshed once at the start of AddForceContribution() so that
+     * the areas, perimeters, shapes and gradients are all computed
+     * from plain coordinates. Not archived.
+     */
+    std::vector<c_vector<double, DIM> > mLocalNodeLocations;
+
+    /**
+     * The position in mLocalNodeLocations of the first node of each
+     * element, indexed by element index, followed by the total number
+     * of entries. Not archived.
+     */
+    std::vector<unsigned> mLocalNodeOffsets;
+
+    /**
+     * Compute the elongation factor and orientation of every element
+     * from mLocalNodeLocations, and store them in mElongationFactors
+     * and mOrientations.
+     *
+     * Every axis of an isotropic element is a principal axis. The
+     * force draws a random one, as GetShortAxisOfElement() does;
+     * otherwise the x axis is used, so that no random numbers are
+     * drawn.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param drawIsotropicAxes whether to draw the axes of isotropic elements at random
+     */
+    void ComputeElementShapes(VertexBasedCellPopulation<DIM>& rCellPopulation, bool drawIsotropicAxes);
+
+    /**
+     * Compute the second moments of area of an element about its
+     * centroid from mLocalNodeLocations, as in
+     * VertexMesh::CalculateMomentsOfElement().
+     *
+     * @param elemIndex the index of the element
+     * @return (I_xx, I_yy, I_xy)
+     */
+    c_vector<double, 3> CalculateMomentsOfElement(unsigned elemIndex) const;
+
+    /**
+     * Add the forces to the nodes by a loop over the nodes and their
+     * containing elements. Called by AddForceContribution() once the
+     * element geometry is known.
+     *
+     * The template parameter selects the nematic term at compile
+     * time, so that runs with Lambda zero do not compute it.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param rElementAreas the area of each element
+     * @param rElementPerimeters the perimeter of each element
+     * @param rTargetAreas the target area of each element
+     */
+    template<bool NEMATIC>
+    void AddForceContributionOverNodes(VertexBasedCellPopulation<DIM>& rCellPopulation,
+                                       const std::vector<double>& rElementAreas,
+                                       const std::vector<double>& rElementPerimeters,
+                                       const std::vector<double>& rTargetAreas);
+
+    /**
+     * Add the forces to the nodes by a loop over the edges, which
+     * computes the line tension of each edge once, rather than over
+     * the nodes, which visits each edge four times. Called by
+     * AddForceContribution() once the element geometry is known.
+     *
+     * As for AddForceContributionOverNodes(), the template parameter
+     * selects the nematic term.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param rHalfEdges the half-edges of the mesh
+     * @param rElementAreas the area of each element
+     * @param rElementPerimeters the perimeter of each element
+     * @param rTargetAreas the target area of each element
+     */
+    template<bool NEMATIC>
+    void AddForceContributionOverEdges(VertexBasedCellPopulation<DIM>& rCellPopulation,
+                                       const HalfEdgeMeshView& rHalfEdges,
+                                       const std::vector<double>& rElementAreas,
+                                       const std::vector<double>& rElementPerimeters,
+                                       const std::vector<double>& rTargetAreas);
+
 public:
 
     /**
@@ -148,6 +305,71 @@ public:
      */
     virtual void AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation);
 
+    /**
+     * Refresh mLocalNodeLocations from the current node locations.
+     * This is the only place the force applies periodic corrections.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void UpdateLocalNodeLocations(VertexBasedCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Make mElongationFactors and mOrientations available to output
+     * and analysis modifiers, without drawing random numbers, so that
+     * they do not change seeded trajectories.
+     *
+     * The shapes computed by the last call to AddForceContribution()
+     * are reused: these are the shapes at the start of the time step,
+     * before the nodes moved. Before the first force evaluation (e.g.
+     * in SetupSolve() or after loading from an archive), or if
+     * ReMesh() has changed the elements since, they are computed from
+     * the current node locations, once, and reused by later calls.
+     * The x axis is then used for isotropic elements.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void UpdateElementShapesForOutput(VertexBasedCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * @return mLocalNodeLocations
+     */
+    const std::vector<c_vector<double, DIM> >& rGetLocalNodeLocations() const;
+
+    /**
+     * @return mLocalNodeOffsets
+     */
+    const std::vector<unsigned>& rGetLocalNodeOffsets() const;
+
+    /**
+     * @return mElongationFactors
+     */
+    const std::vector<double>& rGetElongationFactors() const;
+
+    /**
+     * @return mOrientations
+     */
+    const std::vector<double>& rGetOrientations() const;
+
+    /**
+     * @return mAreaEnergy
+     */
+    double GetAreaEnergy() const;
+
+    /**
+     * @return mPerimeterEnergy
+     */
+    double GetPerimeterEnergy() const;
+
+    /**
+     * @return mSignedElementAreas
+     */
+    const std::vector<double>& rGetSignedElementAreas() const;
+
+    /**
+     * @return mNematicNodeForces
+     */
+    const std::vector<c_vector<double, DIM> >& rGetNematicNodeForces() const;
+
     /**
      * @return mKA
      */
@@ -168,6 +390,18 @@ public:
      */
     double GetLambda();
 
+    /**
+     * @return mUseEdgeAssembly
+     */
+    bool GetUseEdgeAssembly();
+
+    /**
+     * Set mUseEdgeAssembly.
+     *
+     * @param useEdgeAssembly whether to assemble the forces edge by edge
+     */
+    void SetUseEdgeAssembly(bool useEdgeAssembly);
+
      /**
      * Set mKA.
      *
@@ -205,6 +439,6 @@ public:
 };
 
 #include "SerializationExportWrapper.hpp"
-EXPORT_TEMPLATE_CLASS_SAME_DIMS(TargetAreaAndNematicPerimeterForce)
+EXPORT_TEMPLATE_CLASS1(TargetAreaAndNematicPerimeterForce, 2)
 
 #endif /*TARGETAREAANDNEMATICPERIMETERFORCE_HPP_*/
@@ -0,0 +1,103 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "AbstractOutputOnlyModifier.hpp"
+#include "SimulationTime.hpp"
+
+template<unsigned DIM>
+AbstractOutputOnlyModifier<DIM>::AbstractOutputOnlyModifier()
+  : AbstractCellBasedSimulationModifier<DIM>(),
+    mSamplingTimestepMultiple(1)
+{
+}
+
+template<unsigned DIM>
+AbstractOutputOnlyModifier<DIM>::~AbstractOutputOnlyModifier()
+{
+}
+
+template<unsigned DIM>
+void AbstractOutputOnlyModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  // Time has already been incremented at this point so this is the
+  // same test the simulation uses to decide whether to write results
+  if (IsOutputTimeStep())
+  {
+    UpdateCellData(rCellPopulation);
+  }
+}
+
+template<unsigned DIM>
+void AbstractOutputOnlyModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+  /*
+   * Update CellData in SetupSolve(), to assure that it has been
+   * fully initialised before the initial results are written.
+   */
+  UpdateCellData(rCellPopulation);
+}
+
+template<unsigned DIM>
+bool AbstractOutputOnlyModifier<DIM>::IsOutputTimeStep()
+{
+  return SimulationTime::Instance()->GetTimeStepsElapsed()%mSamplingTimestepMultiple == 0;
+}
+
+template<unsigned DIM>
+unsigned AbstractOutputOnlyModifier<DIM>::GetSamplingTimestepMultiple()
+{
+  return mSamplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void AbstractOutputOnlyModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+  assert(samplingTimestepMultiple > 0);
+  mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void AbstractOutputOnlyModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+
+    // Call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+// template class AbstractOutputOnlyModifier<1>;
+template class AbstractOutputOnlyModifier<2>;
+// template class AbstractOutputOnlyModifier<3>;
@@ -0,0 +1,162 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ABSTRACTOUTPUTONLYMODIFIER_HPP_
+#define ABSTRACTOUTPUTONLYMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include "ClassIsAbstract.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+
+/**
+ * An abstract modifier class for diagnostic quantities that are only
+ * written to file and never fed back into the forces or the ODE
+ * solver (e.g. cell tension, elongation and orientation).
+ *
+ * Such modifiers declare themselves output-only: UpdateCellData() is
+ * called in SetupSolve() (so the initial output is complete) and then
+ * only at the end of time steps on which the simulation writes its
+ * results, i.e. when the number of elapsed time steps is a multiple
+ * of mSamplingTimestepMultiple. Since UpdateAtEndOfTimeStep() is
+ * called just before the cell writers fire, the written values are
+ * always current.
+ *
+ * The sampling multiple must match the one passed to
+ * SetSamplingTimestepMultiple() on the simulation, otherwise stale
+ * CellData is written. Rather than setting both by hand, a simulation
+ * can set it on each output-only modifier in its own SetupSolve(), as
+ * the StoppingOffLatticeSimulation in the driver does. The default of
+ * 1 recovers the old behaviour of updating every time step.
+ */
+template<unsigned DIM>
+class AbstractOutputOnlyModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mSamplingTimestepMultiple;
+    }
+
+protected:
+
+    /**
+     * The number of time steps between outputs of the simulation
+     * this modifier is attached to. Defaults to 1.
+     */
+    unsigned mSamplingTimestepMultiple;
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    AbstractOutputOnlyModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~AbstractOutputOnlyModifier();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Calls UpdateCellData() only if results are about to be written
+     * to file at the end of this time step.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Calls UpdateCellData() so that the CellData is fully
+     * initialised before the initial results are written.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Compute the diagnostic quantities and store them in CellData.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateCellData(AbstractCellPopulation<DIM,DIM>& rCellPopulation)=0;
+
+    /**
+     * @return whether the simulation writes results at the end of the
+     * current time step.
+     */
+    bool IsOutputTimeStep();
+
+    /**
+     * @return mSamplingTimestepMultiple
+     */
+    unsigned GetSamplingTimestepMultiple();
+
+    /**
+     * Set mSamplingTimestepMultiple. Should be set to the same value
+     * as the simulation's sampling timestep multiple.
+     *
+     * @param samplingTimestepMultiple the new value of mSamplingTimestepMultiple
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    virtual void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+TEMPLATED_CLASS_IS_ABSTRACT_1_UNSIGNED(AbstractOutputOnlyModifier)
+
+#endif /*ABSTRACTOUTPUTONLYMODIFIER_HPP_*/
@@ -34,10 +34,11 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "CellElongationModifier.hpp"
+#include "VertexBasedCellPopulation.hpp"
 
 template<unsigned DIM>
 CellElongationModifier<DIM>::CellElongationModifier()
-  : AbstractCellBasedSimulationModifier<DIM>()
+  : AbstractOutputOnlyModifier<DIM>()
 {
 }
 
@@ -47,57 +48,55 @@ CellElongationModifier<DIM>::~CellElongationModifier()
 }
 
 template<unsigned DIM>
-void CellElongationModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
-// void CellElongationModifier<DIM>::UpdateAtEndOfTimeStep(VertexBasedCellPopulation<DIM>& rCellPopulation)
+boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > CellElongationModifier<DIM>::GetNematicForce()
 {
-  UpdateCellData(rCellPopulation);
+  return mpNematicForce;
 }
 
 template<unsigned DIM>
-void CellElongationModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
-// void CellElongationModifier<DIM>::SetupSolve(VertexBasedCellPopulation<DIM>& rCellPopulation, std::string outputDirectory)
+void CellElongationModifier<DIM>::SetNematicForce(boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > pNematicForce)
 {
-  /*
-   * Update CellData in SetupSolve(), to assure that it has been
-   * fully initialised before we enter the main time loop.
-   */
-  UpdateCellData(rCellPopulation);
+  mpNematicForce = pNematicForce;
 }
 
-
 template<unsigned DIM>
 void CellElongationModifier<DIM>::UpdateCellData(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
-// void CellElongationModifier<DIM>::UpdateCellData(VertexBasedCellPopulation<DIM>& rCellPopulation)
 {
-  // rCellPopulation.Update();
-
-    // // Iterate over the cell population and update the tension in
-    // // CellData. Nothing gets used by the ODE solver but this allows
-    // // us to visualize the variable "tension" in ParaView.
-    // for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
-    //      cell_iter != rCellPopulation.End();
-    //      ++cell_iter)
-    // // for (typename VertexBasedCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
-    // //      cell_iter != rCellPopulation.End();
-    // //      ++cell_iter)
-    // {
-    //   VertexElement<DIM,DIM>* elem = rCellPopulation.GetElementCorrespondingToCell(cell_iter);
-    //   unsigned elem_index = elem->GetIndex();
-    //   // unsigned elem_index = rCellPopulation.GetElementCorrespondingToCell(cell_iter);
-    //   c_vector<double,DIM> short_axis = rCellPopulation.rGetMesh().GetShortAxisOfElement(elem_index);
-    //   // Nematic
-    //   double orientation = atan2(short_axis[1], short_axis[0]) % M_PI;
-    //   cell_iter->GetCellData()->SetItem("orientation", orientation);
-    //   double elongation_factor = rCellPopulation->rGetMesh().GetElongationShapeFactorOfElement(elem_index);
-    //   cell_iter->GetCellData()->SetItem("elongation", elongation_factor);
-    // }
+  // Throw an exception message if not using a VertexBasedCellPopulation
+  if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == nullptr)
+    {
+      EXCEPTION("CellElongationModifier is to be used with a VertexBasedCellPopulation only");
+    }
+  if (!mpNematicForce)
+    {
+      EXCEPTION("CellElongationModifier needs a TargetAreaAndNematicPerimeterForce, set using SetNematicForce()");
+    }
+  VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+
+  // The element shapes at the start of the time step (computed
+  // without random draws if the force did not need them)
+  mpNematicForce->UpdateElementShapesForOutput(*p_cell_population);
+  const std::vector<double>& r_elongation_factors = mpNematicForce->rGetElongationFactors();
+  const std::vector<double>& r_orientations = mpNematicForce->rGetOrientations();
+
+  // Iterate over the cell population and update the elongation and
+  // orientation in CellData. Nothing gets used by the ODE solver but
+  // this allows us to visualize and record the variables.
+  for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+       cell_iter != rCellPopulation.End();
+       ++cell_iter)
+    {
+      unsigned elem_index = p_cell_population->GetLocationIndexUsingCell(*cell_iter);
+      cell_iter->GetCellData()->SetItem("elongation", r_elongation_factors[elem_index]);
+      cell_iter->GetCellData()->SetItem("orientation", r_orientations[elem_index]);
+    }
 }
 
 template<unsigned DIM>
 void CellElongationModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
 {
     // No parameters to output, so just call method on direct parent class
-    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+    AbstractOutputOnlyModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
 }
 
 // Explicit instantiation
@@ -107,4 +106,4 @@ template class CellElongationModifier<2>;
 
 // Serialization for Boost >= 1.36
 #include "SerializationExportWrapperForCpp.hpp"
-EXPORT_TEMPLATE_CLASS_SAME_DIMS(CellElongationModifier)
+EXPORT_TEMPLATE_CLASS1(CellElongationModifier, 2)
@@ -38,16 +38,29 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
 
-#include "AbstractCellBasedSimulationModifier.hpp"
-// #include "VertexElement.hpp"
+#include "AbstractOutputOnlyModifier.hpp"
+#include "TargetAreaAndNematicPerimeterForce.hpp"
 
 /**
- * A modifier class in which the average self propulstion angle in
- * neighbouring cells are computed and stored in CellData.
+ * A modifier class in which the elongation factor and nematic
+ * orientation (angle of the short axis) of each cell are stored in
+ * CellData as "elongation" and "orientation".
+ *
+ * Rather than recomputing the shape tensor of each element, the
+ * values cached by the TargetAreaAndNematicPerimeterForce during its
+ * last call to AddForceContribution() are reused, so enabling this
+ * modifier costs one CellData write per cell on output time steps.
+ * The published shapes are therefore those at the start of the time
+ * step, whereas cell areas and positions written at the same time
+ * are from the end of the step. Shapes the force has not computed
+ * (before the first time step, or after a swap has changed the
+ * elements) are computed without random draws, so this modifier
+ * never changes a seeded trajectory.
  */
 template<unsigned DIM>
-class CellElongationModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+class CellElongationModifier : public AbstractOutputOnlyModifier<DIM>
 {
     /** Needed for serialization. */
     friend class boost::serialization::access;
@@ -61,11 +74,17 @@ class CellElongationModifier : public AbstractCellBasedSimulationModifier<DIM,DI
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractOutputOnlyModifier<DIM> >(*this);
+        archive & mpNematicForce;
     }
 
 protected:
 
+    /**
+     * The force whose cached element shapes are published.
+     */
+    boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > mpNematicForce;
+
 public:
 
     /**
@@ -79,37 +98,27 @@ public:
     virtual ~CellElongationModifier();
 
     /**
-     * Overridden UpdateAtEndOfTimeStep() method.
-     *
-     * Specifies what to do in the simulation at the end of each time step.
-     *
-     * @param rCellPopulation reference to the cell population
+     * @return mpNematicForce
      */
-    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
-    // virtual void UpdateAtEndOfTimeStep(VertexBasedCellPopulation<DIM>& rCellPopulation);
+    boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > GetNematicForce();
 
     /**
-     * Overridden SetupSolve() method.
+     * Set mpNematicForce.
      *
-     * Specifies what to do in the simulation before the start of the time loop.
-     *
-     * @param rCellPopulation reference to the cell population
-     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     * @param pNematicForce the force added to the simulation whose element shapes are published
      */
-    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
-  // virtual void SetupSolve(VertexBasedCellPopulation<DIM>& rCellPopulation, std::string outputDirectory);
+    void SetNematicForce(boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > pNematicForce);
 
     /**
-     * Helper method to compute the average self propulsion angle in each cell's neighbours and store these in the CellData.
+     * Overridden UpdateCellData() method.
      *
-     * Note: If using a CaBasedCellPopulation, we assume a Moore neighbourhood and unit carrying capacity.
-     * If a cell has no neighbours (such as an isolated cell in a CaBasedCellPopulation), we store the
-     * value -1 in the CellData.
+     * Copy the elongation factor and orientation of each cell from
+     * the nematic force into the CellData (see
+     * TargetAreaAndNematicPerimeterForce::UpdateElementShapesForOutput()).
      *
      * @param rCellPopulation reference to the cell population
      */
     void UpdateCellData(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
-    // void UpdateCellData(VertexBasedCellPopulation<DIM>& rCellPopulation);
 
     /**
      * Overridden OutputSimulationModifierParameters() method.
@@ -121,6 +130,6 @@ public:
 };
 
 #include "SerializationExportWrapper.hpp"
-EXPORT_TEMPLATE_CLASS_SAME_DIMS(CellElongationModifier)
+EXPORT_TEMPLATE_CLASS1(CellElongationModifier, 2)
 
 #endif /*CELLELONGATIONMODIFIER_HPP_*/
@@ -0,0 +1,202 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "CellMotilityCorrelationModifier.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+
+template<unsigned DIM>
+CellMotilityCorrelationModifier<DIM>::CellMotilityCorrelationModifier()
+  : AbstractCellBasedSimulationModifier<DIM>(),
+    mSamplingTimestepMultiple(1),
+    mNumLevels(16),
+    mPointsPerLevel(16),
+    mAveragingFactor(2),
+    mDisplacements(DIM, MultipleTauCorrelator::SQUARED_DIFFERENCE),
+    mVelocities(DIM, MultipleTauCorrelator::PRODUCT)
+{
+}
+
+template<unsigned DIM>
+CellMotilityCorrelationModifier<DIM>::~CellMotilityCorrelationModifier()
+{
+}
+
+template<unsigned DIM>
+void CellMotilityCorrelationModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+  assert(samplingTimestepMultiple > 0);
+  mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void CellMotilityCorrelationModifier<DIM>::SetLagGrid(unsigned numLevels, unsigned pointsPerLevel, unsigned averagingFactor)
+{
+  if (numLevels == 0 || averagingFactor < 2 || pointsPerLevel < averagingFactor || pointsPerLevel%averagingFactor != 0)
+    {
+      EXCEPTION("The lag grid needs at least one level and a number of points per level that is a multiple of an averaging factor of at least 2");
+    }
+  mNumLevels = numLevels;
+  mPointsPerLevel = pointsPerLevel;
+  mAveragingFactor = averagingFactor;
+}
+
+template<unsigned DIM>
+void CellMotilityCorrelationModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  if (SimulationTime::Instance()->GetTimeStepsElapsed()%mSamplingTimestepMultiple == 0)
+    {
+      RecordSample(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void CellMotilityCorrelationModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+  mOutputDirectory = outputDirectory;
+  mTrajectories.clear();
+  mDisplacements = MultipleTauCorrelator(DIM, MultipleTauCorrelator::SQUARED_DIFFERENCE, mNumLevels, mPointsPerLevel, mAveragingFactor);
+  mVelocities = MultipleTauCorrelator(DIM, MultipleTauCorrelator::PRODUCT, mNumLevels, mPointsPerLevel, mAveragingFactor);
+  RecordSample(rCellPopulation);
+}
+
+template<unsigned DIM>
+void CellMotilityCorrelationModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  WriteCorrelations();
+}
+
+template<unsigned DIM>
+void CellMotilityCorrelationModifier<DIM>::RecordSample(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  double sampling_interval = mSamplingTimestepMultiple*SimulationTime::Instance()->GetTimeStep();
+
+  for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+       cell_iter != rCellPopulation.End();
+       ++cell_iter)
+    {
+      unsigned cell_id = cell_iter->GetCellId();
+      c_vector<double, DIM> location = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+
+      if (cell_id >= mTrajectories.size())
+        {
+          mTrajectories.resize(cell_id + 1);
+        }
+      CellTrajectory& r_trajectory = mTrajectories[cell_id];
+
+      if (r_trajectory.mNumSamples > 0)
+        {
+          // The minimum image displacement, valid as long as no cell
+          // moves half the domain between samples
+          c_vector<double, DIM> displacement = rCellPopulation.rGetMesh().GetVectorFromAtoB(r_trajectory.mLastLocation, location);
+          for (unsigned d=0; d<DIM; d++)
+            {
+              r_trajectory.mUnwrappedLocation[d] += displacement[d];
+              r_trajectory.mVelocity[d] = displacement[d]/sampling_interval;
+            }
+          mVelocities.Add(r_trajectory.mVelocities, r_trajectory.mVelocity);
+        }
+      else
+        {
+          mDisplacements.ResetShiftRegister(r_trajectory.mDisplacements);
+          mVelocities.ResetShiftRegister(r_trajectory.mVelocities);
+          for (unsigned d=0; d<DIM; d++)
+            {
+              r_trajectory.mUnwrappedLocation[d] = location[d];
+            }
+        }
+      mDisplacements.Add(r_trajectory.mDisplacements, r_trajectory.mUnwrappedLocation);
+      r_trajectory.mLastLocation = location;
+      r_trajectory.mNumSamples++;
+    }
+}
+
+template<unsigned DIM>
+void CellMotilityCorrelationModifier<DIM>::WriteCorrelations()
+{
+  double sampling_interval = mSamplingTimestepMultiple*SimulationTime::Instance()->GetTimeStep();
+
+  unsigned num_cells = 0;
+  for (unsigned cell_id=0; cell_id<mTrajectories.size(); cell_id++)
+    {
+      if (mTrajectories[cell_id].mNumSamples > 0)
+        {
+          num_cells++;
+        }
+    }
+
+  OutputFileHandler output_file_handler(mOutputDirectory, false);
+  out_stream p_file = output_file_handler.OpenOutputFile("motility_correlations.dat");
+  *p_file << "# Cell centre MSD and VACF (see CellMotilityCorrelationModifier)\n"
+          << "sampling_interval " << sampling_interval << "\n"
+          << "num_cells " << num_cells << "\n"
+          << "# lag_time msd msd_count vacf vacf_count\n";
+
+  for (unsigned i=0; i<mDisplacements.GetNumLags(); i++)
+    {
+      double msd_sum = mDisplacements.GetSum(i);
+      double vacf_sum = mVelocities.GetSum(i);
+      unsigned long msd_count = mDisplacements.GetCount(i);
+      unsigned long vacf_count = mVelocities.GetCount(i);
+      if (msd_count == 0 && vacf_count == 0)
+        {
+          continue;
+        }
+      *p_file << mDisplacements.GetLag(i)*sampling_interval << " "
+              << ((msd_count > 0) ? msd_sum/msd_count : 0.0) << " " << msd_count << " "
+              << ((vacf_count > 0) ? vacf_sum/vacf_count : 0.0) << " " << vacf_count << "\n";
+    }
+  p_file->close();
+}
+
+template<unsigned DIM>
+void CellMotilityCorrelationModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+  *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+  *rParamsFile << "\t\t\t<NumLevels>" << mNumLevels << "</NumLevels>\n";
+  *rParamsFile << "\t\t\t<PointsPerLevel>" << mPointsPerLevel << "</PointsPerLevel>\n";
+  *rParamsFile << "\t\t\t<AveragingFactor>" << mAveragingFactor << "</AveragingFactor>\n";
+
+  // Call method on direct parent class
+  AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+// template class CellMotilityCorrelationModifier<1>;
+template class CellMotilityCorrelationModifier<2>;
+// template class CellMotilityCorrelationModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(CellMotilityCorrelationModifier)
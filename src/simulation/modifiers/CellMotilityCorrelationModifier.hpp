@@ -0,0 +1,227 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef CELLMOTILITYCORRELATIONMODIFIER_HPP_
+#define CELLMOTILITYCORRELATIONMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "MultipleTauCorrelator.hpp"
+
+#include <vector>
+
+/**
+ * A modifier class that measures the mean squared displacement (MSD)
+ * and velocity autocorrelation function (VACF) of cell centres while
+ * the simulation runs, for calibrating the persistent random walk.
+ *
+ * Every mSamplingTimestepMultiple time steps each cell's centre is
+ * unwrapped across the periodic boundaries by adding its minimum image
+ * displacement since the previous sample, and its velocity is that
+ * displacement divided by the time between samples. A pair of
+ * multiple-tau correlators accumulates the displacement and velocity
+ * pairs of all cells, each cell keeping only its own shift registers,
+ * so the curves are estimated on a logarithmic grid of lags from one
+ * sample to about mPointsPerLevel*mAveragingFactor^(mNumLevels-1)
+ * samples with a fixed amount of memory per cell.
+ *
+ * At the end of Solve() the MSD and VACF, averaged over cells and time
+ * origins, are written to motility_correlations.dat in the simulation
+ * output directory. Cells that are removed keep contributing the pairs
+ * they have already seen.
+ *
+ * Only the parameters are archived; the statistics are accumulated
+ * afresh in each call to Solve().
+ */
+template<unsigned DIM>
+class CellMotilityCorrelationModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mSamplingTimestepMultiple;
+        archive & mNumLevels;
+        archive & mPointsPerLevel;
+        archive & mAveragingFactor;
+    }
+
+    /** The trajectory of one cell. */
+    struct CellTrajectory
+    {
+        /** Constructor. */
+        CellTrajectory()
+            : mNumSamples(0),
+              mUnwrappedLocation(DIM, 0.0),
+              mVelocity(DIM, 0.0)
+        {
+        }
+
+        /** The number of samples seen, zero for ids without a cell. */
+        unsigned mNumSamples;
+
+        /** The cell centre at the previous sample, as stored by the mesh. */
+        c_vector<double, DIM> mLastLocation;
+
+        /** The cell centre unwrapped across the periodic boundaries. */
+        std::vector<double> mUnwrappedLocation;
+
+        /** The velocity over the last sampling interval. */
+        std::vector<double> mVelocity;
+
+        /** The recent unwrapped locations, for mDisplacements. */
+        MultipleTauCorrelator::ShiftRegister mDisplacements;
+
+        /** The recent velocities, for mVelocities. */
+        MultipleTauCorrelator::ShiftRegister mVelocities;
+    };
+
+    /** Number of time steps between samples. Defaults to 1. */
+    unsigned mSamplingTimestepMultiple;
+
+    /** Number of correlator levels. Defaults to 16. */
+    unsigned mNumLevels;
+
+    /** Number of lags at each correlator level. Defaults to 16. */
+    unsigned mPointsPerLevel;
+
+    /** Ratio of the lag spacing of successive correlator levels. Defaults to 2. */
+    unsigned mAveragingFactor;
+
+    /** The trajectory of each cell, indexed by cell id. */
+    std::vector<CellTrajectory> mTrajectories;
+
+    /** Correlator of the unwrapped locations of all cells, giving the MSD. */
+    MultipleTauCorrelator mDisplacements;
+
+    /** Correlator of the velocities of all cells, giving the VACF. */
+    MultipleTauCorrelator mVelocities;
+
+    /** The output directory of the simulation. */
+    std::string mOutputDirectory;
+
+    /**
+     * Unwrap every cell centre and add it and the cell's velocity to
+     * the correlators.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void RecordSample(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Write the MSD and VACF to file.
+     */
+    void WriteCorrelations();
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    CellMotilityCorrelationModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~CellMotilityCorrelationModifier();
+
+    /**
+     * Set mSamplingTimestepMultiple.
+     *
+     * @param samplingTimestepMultiple the number of time steps between samples
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * Set the lag grid of the correlators.
+     *
+     * @param numLevels the number of levels
+     * @param pointsPerLevel the number of lags at each level (a multiple of averagingFactor)
+     * @param averagingFactor the ratio of the lag spacing of successive levels (at least 2)
+     */
+    void SetLagGrid(unsigned numLevels, unsigned pointsPerLevel, unsigned averagingFactor=2);
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Sample every mSamplingTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Reset the trajectories and correlators and take the initial
+     * sample.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Write the correlations to file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(CellMotilityCorrelationModifier)
+
+#endif /*CELLMOTILITYCORRELATIONMODIFIER_HPP_*/
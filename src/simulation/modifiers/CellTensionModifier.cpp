@@ -39,7 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 template<unsigned DIM>
 CellTensionModifier<DIM>::CellTensionModifier()
-  : AbstractCellBasedSimulationModifier<DIM>(),
+  : AbstractOutputOnlyModifier<DIM>(),
     mKA(1.0),
     mKP(1.0),
     mP0(3.8)
@@ -51,24 +51,6 @@ CellTensionModifier<DIM>::~CellTensionModifier()
 {
 }
 
-template<unsigned DIM>
-void CellTensionModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
-// void CellTensionModifier<DIM>::UpdateAtEndOfTimeStep(VertexBasedCellPopulation<DIM>& rCellPopulation)
-{
-  UpdateCellData(rCellPopulation);
-}
-
-template<unsigned DIM>
-void CellTensionModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
-// void CellTensionModifier<DIM>::SetupSolve(VertexBasedCellPopulation<DIM>& rCellPopulation, std::string outputDirectory)
-{
-  /*
-   * Update CellData in SetupSolve(), to assure that it has been
-   * fully initialised before we enter the main time loop.
-   */
-  UpdateCellData(rCellPopulation);
-}
-
 template<unsigned DIM>
 double CellTensionModifier<DIM>::GetKA()
 {
@@ -109,7 +91,11 @@ template<unsigned DIM>
 void CellTensionModifier<DIM>::UpdateCellData(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 // void CellTensionModifier<DIM>::UpdateCellData(VertexBasedCellPopulation<DIM>& rCellPopulation)
 {
-    rCellPopulation.Update();
+    // The population is not updated here: this is only called on
+    // output steps and a ReMesh would make the dynamics depend on how
+    // often results are written. The "volume" and "perimeter" items
+    // were already set earlier in the step by the ERK propulsion
+    // modifier and the nematic force.
 
     // Iterate over the cell population and update the tension in
     // CellData. Nothing gets used by the ODE solver but this allows
@@ -150,7 +136,7 @@ template<unsigned DIM>
 void CellTensionModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
 {
     // No parameters to output, so just call method on direct parent class
-    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+    AbstractOutputOnlyModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
 }
 
 // Explicit instantiation
@@ -39,7 +39,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 
-#include "AbstractCellBasedSimulationModifier.hpp"
+#include "AbstractOutputOnlyModifier.hpp"
 // #include "VertexBasedCellPopulation.hpp"
 
 /**
@@ -47,7 +47,7 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * neighbouring cells are computed and stored in CellData.
  */
 template<unsigned DIM>
-class CellTensionModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+class CellTensionModifier : public AbstractOutputOnlyModifier<DIM>
 {
     /** Needed for serialization. */
     friend class boost::serialization::access;
@@ -61,7 +61,7 @@ class CellTensionModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractOutputOnlyModifier<DIM> >(*this);
 	archive & mKA;
         archive & mKP;
         archive & mP0;
@@ -97,27 +97,6 @@ public:
      */
     virtual ~CellTensionModifier();
 
-    /**
-     * Overridden UpdateAtEndOfTimeStep() method.
-     *
-     * Specifies what to do in the simulation at the end of each time step.
-     *
-     * @param rCellPopulation reference to the cell population
-     */
-    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
-    // virtual void UpdateAtEndOfTimeStep(VertexBasedCellPopulation<DIM>& rCellPopulation);
-
-    /**
-     * Overridden SetupSolve() method.
-     *
-     * Specifies what to do in the simulation before the start of the time loop.
-     *
-     * @param rCellPopulation reference to the cell population
-     * @param outputDirectory the output directory, relative to where Chaste output is stored
-     */
-    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
-  // virtual void SetupSolve(VertexBasedCellPopulation<DIM>& rCellPopulation, std::string outputDirectory);
-
     /**
      * @return mKA
      */
@@ -155,11 +134,10 @@ public:
     void SetP0(double P0);
 
     /**
-     * Helper method to compute the average self propulsion angle in each cell's neighbours and store these in the CellData.
+     * Overridden UpdateCellData() method.
      *
-     * Note: If using a CaBasedCellPopulation, we assume a Moore neighbourhood and unit carrying capacity.
-     * If a cell has no neighbours (such as an isolated cell in a CaBasedCellPopulation), we store the
-     * value -1 in the CellData.
+     * Compute the "tension" KA(A-A0)^2 + KP(P-P0)^2 of each cell and
+     * store it in the CellData. Only called on output time steps.
      *
      * @param rCellPopulation reference to the cell population
      */
@@ -0,0 +1,277 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "CoarseGrainedFieldsModifier.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+
+#include <cmath>
+
+template<unsigned DIM>
+CoarseGrainedFieldsModifier<DIM>::CoarseGrainedFieldsModifier()
+  : AbstractCellBasedSimulationModifier<DIM>(),
+    mNumGridPointsX(32),
+    mNumGridPointsY(32),
+    mKernel(PeriodicGrid::CLOUD_IN_CELL),
+    mKernelWidth(1.0),
+    mSamplingTimestepMultiple(1),
+    mNumSamples(0)
+{
+  mDomainSize[0] = 0.0;
+  mDomainSize[1] = 0.0;
+}
+
+template<unsigned DIM>
+CoarseGrainedFieldsModifier<DIM>::~CoarseGrainedFieldsModifier()
+{
+}
+
+template<unsigned DIM>
+void CoarseGrainedFieldsModifier<DIM>::SetNematicForce(boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > pNematicForce)
+{
+  mpNematicForce = pNematicForce;
+}
+
+template<unsigned DIM>
+void CoarseGrainedFieldsModifier<DIM>::SetGridSize(unsigned numGridPointsX, unsigned numGridPointsY)
+{
+  assert(numGridPointsX > 0 && numGridPointsY > 0);
+  mNumGridPointsX = numGridPointsX;
+  mNumGridPointsY = numGridPointsY;
+}
+
+template<unsigned DIM>
+void CoarseGrainedFieldsModifier<DIM>::SetKernel(PeriodicGrid::Kernel kernel, double kernelWidth)
+{
+  mKernel = kernel;
+  mKernelWidth = kernelWidth;
+}
+
+template<unsigned DIM>
+void CoarseGrainedFieldsModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+  assert(samplingTimestepMultiple > 0);
+  mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+double CoarseGrainedFieldsModifier<DIM>::GetAverage(unsigned gridIndex, unsigned field)
+{
+  assert(gridIndex < mWeightSums.size() && field < NUM_FIELDS);
+  return (mWeightSums[gridIndex] > 0.0) ? mFieldSums[gridIndex*NUM_FIELDS + field]/mWeightSums[gridIndex] : 0.0;
+}
+
+template<unsigned DIM>
+void CoarseGrainedFieldsModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  if (SimulationTime::Instance()->GetTimeStepsElapsed()%mSamplingTimestepMultiple == 0)
+    {
+      RecordSample(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void CoarseGrainedFieldsModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+  // Throw an exception message if not using a VertexBasedCellPopulation
+  if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == nullptr)
+    {
+      EXCEPTION("CoarseGrainedFieldsModifier is to be used with a VertexBasedCellPopulation only");
+    }
+  if (!mpNematicForce)
+    {
+      EXCEPTION("CoarseGrainedFieldsModifier needs a TargetAreaAndNematicPerimeterForce, set using SetNematicForce()");
+    }
+
+  mOutputDirectory = outputDirectory;
+  mDomainSize[0] = rCellPopulation.rGetMesh().GetWidth(0);
+  mDomainSize[1] = rCellPopulation.rGetMesh().GetWidth(1);
+  mFieldSums.assign(mNumGridPointsX*mNumGridPointsY*NUM_FIELDS, 0.0);
+  mWeightSums.assign(mNumGridPointsX*mNumGridPointsY, 0.0);
+  mNumSamples = 0;
+}
+
+template<unsigned DIM>
+void CoarseGrainedFieldsModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  WriteFields();
+}
+
+template<unsigned DIM>
+void CoarseGrainedFieldsModifier<DIM>::RecordSample(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+  MutableVertexMesh<DIM,DIM>& r_mesh = p_cell_population->rGetMesh();
+
+  // The element shapes at the start of the time step (computed
+  // without random draws if the force did not need them)
+  mpNematicForce->UpdateElementShapesForOutput(*p_cell_population);
+  const std::vector<double>& r_elongation_factors = mpNematicForce->rGetElongationFactors();
+  const std::vector<double>& r_orientations = mpNematicForce->rGetOrientations();
+  double KA = mpNematicForce->GetKA();
+  double KP = mpNematicForce->GetKP();
+  double P0 = mpNematicForce->GetP0();
+  double lambda = mpNematicForce->GetLambda();
+
+  PeriodicGrid grid(mNumGridPointsX, mNumGridPointsY, mDomainSize[0], mDomainSize[1], mKernel, mKernelWidth);
+  std::vector<std::pair<unsigned, double> > stencil;
+  double fields[NUM_FIELDS];
+
+  for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+       cell_iter != rCellPopulation.End();
+       ++cell_iter)
+    {
+      VertexElement<DIM,DIM>* p_element = p_cell_population->GetElementCorrespondingToCell(*cell_iter);
+      unsigned elem_index = p_element->GetIndex();
+      unsigned num_nodes = p_element->GetNumNodes();
+
+      // Mean vertex velocity
+      c_vector<double, DIM> velocity = zero_vector<double>(DIM);
+      for (unsigned i=0; i<num_nodes; i++)
+        {
+          unsigned node_index = p_element->GetNodeGlobalIndex(i);
+          velocity += p_element->GetNode(i)->rGetAppliedForce()/p_cell_population->GetDampingConstant(node_index);
+        }
+      velocity /= num_nodes;
+
+      // Shape tensor along the long axis, which is perpendicular to
+      // the short axis angle theta
+      double elongation = r_elongation_factors[elem_index];
+      double theta = r_orientations[elem_index];
+      double log_elongation = log(elongation);
+
+      // Virial stress of the cell's area, perimeter and nematic terms
+      double area = r_mesh.GetVolumeOfElement(elem_index);
+      double perimeter = r_mesh.GetSurfaceAreaOfElement(elem_index);
+      double target_area = cell_iter->GetCellData()->GetItem("Target Area");
+      double perimeter_tension = 2.0*KP*(perimeter - P0);
+      double pressure_term = 2.0*KA*(area - target_area);
+      double stress_xx = pressure_term;
+      double stress_xy = 0.0;
+      double stress_yy = pressure_term;
+      for (unsigned i=0; i<num_nodes; i++)
+        {
+          c_vector<double, DIM> edge = r_mesh.GetVectorFromAtoB(p_element->GetNodeLocation(i),
+                                                                p_element->GetNodeLocation((i+1)%num_nodes));
+          double length = norm_2(edge);
+          if (length == 0.0)
+            {
+              continue;
+            }
+          double edge_angle = atan2(edge[1], edge[0]);
+          double tension = perimeter_tension - lambda*(elongation - 1.0)*cos(2.0*(theta - edge_angle));
+          stress_xx += tension*edge[0]*edge[0]/(length*area);
+          stress_xy += tension*edge[0]*edge[1]/(length*area);
+          stress_yy += tension*edge[1]*edge[1]/(length*area);
+        }
+
+      fields[0] = velocity[0];
+      fields[1] = velocity[1];
+      fields[2] = -log_elongation*cos(2.0*theta);
+      fields[3] = -log_elongation*sin(2.0*theta);
+      fields[4] = stress_xx;
+      fields[5] = stress_xy;
+      fields[6] = stress_yy;
+
+      c_vector<double, DIM> centroid = p_cell_population->GetLocationOfCellCentre(*cell_iter);
+      grid.GetStencil(centroid[0], centroid[1], stencil);
+      for (unsigned k=0; k<stencil.size(); k++)
+        {
+          unsigned grid_index = stencil[k].first;
+          double weight = stencil[k].second;
+          mWeightSums[grid_index] += weight;
+          for (unsigned f=0; f<NUM_FIELDS; f++)
+            {
+              mFieldSums[grid_index*NUM_FIELDS + f] += weight*fields[f];
+            }
+        }
+    }
+  mNumSamples++;
+}
+
+template<unsigned DIM>
+void CoarseGrainedFieldsModifier<DIM>::WriteFields()
+{
+  double spacing_x = mDomainSize[0]/mNumGridPointsX;
+  double spacing_y = mDomainSize[1]/mNumGridPointsY;
+
+  OutputFileHandler output_file_handler(mOutputDirectory, false);
+  out_stream p_file = output_file_handler.OpenOutputFile("coarse_grained_fields.dat");
+  *p_file << "# Time-averaged coarse-grained fields (see CoarseGrainedFieldsModifier)\n"
+          << "grid " << mNumGridPointsX << " " << mNumGridPointsY << "\n"
+          << "domain " << mDomainSize[0] << " " << mDomainSize[1] << "\n"
+          << "kernel " << (mKernel == PeriodicGrid::NEAREST_GRID_POINT ? "nearest_grid_point" :
+                           mKernel == PeriodicGrid::CLOUD_IN_CELL ? "cloud_in_cell" : "gaussian") << "\n"
+          << "kernel_width " << mKernelWidth << "\n"
+          << "num_samples " << mNumSamples << "\n"
+          << "# i j x y density vx vy Qxx Qxy sigma_xx sigma_xy sigma_yy\n";
+  for (unsigned j=0; j<mNumGridPointsY; j++)
+    {
+      for (unsigned i=0; i<mNumGridPointsX; i++)
+        {
+          unsigned grid_index = j*mNumGridPointsX + i;
+          double density = (mNumSamples > 0) ? mWeightSums[grid_index]/(mNumSamples*spacing_x*spacing_y) : 0.0;
+          *p_file << i << " " << j << " " << i*spacing_x << " " << j*spacing_y << " " << density;
+          for (unsigned f=0; f<NUM_FIELDS; f++)
+            {
+              *p_file << " " << GetAverage(grid_index, f);
+            }
+          *p_file << "\n";
+        }
+    }
+  p_file->close();
+}
+
+template<unsigned DIM>
+void CoarseGrainedFieldsModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+  *rParamsFile << "\t\t\t<NumGridPointsX>" << mNumGridPointsX << "</NumGridPointsX>\n";
+  *rParamsFile << "\t\t\t<NumGridPointsY>" << mNumGridPointsY << "</NumGridPointsY>\n";
+  *rParamsFile << "\t\t\t<Kernel>" << mKernel << "</Kernel>\n";
+  *rParamsFile << "\t\t\t<KernelWidth>" << mKernelWidth << "</KernelWidth>\n";
+  *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+
+  // Call method on direct parent class
+  AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+// template class CoarseGrainedFieldsModifier<1>;
+template class CoarseGrainedFieldsModifier<2>;
+// template class CoarseGrainedFieldsModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS1(CoarseGrainedFieldsModifier, 2)
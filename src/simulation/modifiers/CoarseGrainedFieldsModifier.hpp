@@ -0,0 +1,245 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef COARSEGRAINEDFIELDSMODIFIER_HPP_
+#define COARSEGRAINEDFIELDSMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "PeriodicGrid.hpp"
+#include "TargetAreaAndNematicPerimeterForce.hpp"
+
+#include <vector>
+
+/**
+ * A modifier class that coarse-grains cell velocities, cell shape and
+ * cell stresses onto a fixed grid covering the periodic domain and
+ * averages them in time, so that only the grid fields need be written.
+ *
+ * Every mSamplingTimestepMultiple time steps, for each cell of a
+ * VertexBasedCellPopulation:
+ *  - the velocity is the mean over its vertices of applied force
+ *    divided by damping constant (the vertex velocities of the
+ *    overdamped dynamics in the last time step);
+ *  - the shape tensor Q has components
+ *    (Qxx, Qxy) = log(s) (cos 2 phi, sin 2 phi), where s is the
+ *    elongation factor and phi the angle of the long axis;
+ *  - the stress (positive in tension) is the virial stress of the
+ *    cell's own energy in TargetAreaAndNematicPerimeterForce,
+ *      sigma = 2 KA (A - A0) I + (1/A) sum_edges gamma_e l_e l_e^T / |l_e|,
+ *    where gamma_e = 2 KP (P - P0) - lambda (s - 1) cos 2 (theta - phi_e)
+ *    is the line tension of edge e of length l_e and angle phi_e, and
+ *    theta is the angle of the short axis.
+ * The element shapes are those cached by the force at the start of
+ * the time step, while centroids and areas are from its end (see
+ * TargetAreaAndNematicPerimeterForce::UpdateElementShapesForOutput()).
+ *
+ * Each quantity is assigned to grid points around the cell centroid
+ * with the chosen kernel (see PeriodicGrid), using the periodic width
+ * and height of the mesh, and kernel-weighted sums over cells and
+ * samples are accumulated. At the end of Solve() the time-averaged
+ * fields, and the mean cell number density, are written to
+ * coarse_grained_fields.dat in the simulation output directory with
+ * one row per grid point.
+ *
+ * Only the parameters are archived; the averages are accumulated
+ * afresh in each call to Solve().
+ */
+template<unsigned DIM>
+class CoarseGrainedFieldsModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mpNematicForce;
+        archive & mNumGridPointsX;
+        archive & mNumGridPointsY;
+        archive & mKernel;
+        archive & mKernelWidth;
+        archive & mSamplingTimestepMultiple;
+    }
+
+    /** The force providing the mechanical parameters and element shapes. */
+    boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > mpNematicForce;
+
+    /** Number of grid points in x. Defaults to 32. */
+    unsigned mNumGridPointsX;
+
+    /** Number of grid points in y. Defaults to 32. */
+    unsigned mNumGridPointsY;
+
+    /** The kernel used to assign cell quantities to the grid. Defaults to CLOUD_IN_CELL. */
+    PeriodicGrid::Kernel mKernel;
+
+    /** Standard deviation of a GAUSSIAN kernel. Defaults to 1. */
+    double mKernelWidth;
+
+    /** Number of time steps between samples. Defaults to 1. */
+    unsigned mSamplingTimestepMultiple;
+
+    /** Width and height of the periodic domain. */
+    double mDomainSize[2];
+
+    /** Kernel-weighted sums of each field, indexed [grid point][field]. */
+    std::vector<double> mFieldSums;
+
+    /** Sum of kernel weights at each grid point. */
+    std::vector<double> mWeightSums;
+
+    /** The number of samples accumulated. */
+    unsigned mNumSamples;
+
+    /** The output directory of the simulation. */
+    std::string mOutputDirectory;
+
+    /**
+     * Add the current state of the population to the sums.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void RecordSample(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Write the time-averaged fields to file.
+     */
+    void WriteFields();
+
+public:
+
+    /** The number of fields: vx, vy, Qxx, Qxy, sigma_xx, sigma_xy, sigma_yy. */
+    static const unsigned NUM_FIELDS = 7;
+
+    /**
+     * Default constructor.
+     */
+    CoarseGrainedFieldsModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~CoarseGrainedFieldsModifier();
+
+    /**
+     * Set mpNematicForce.
+     *
+     * @param pNematicForce the force acting on the cell population
+     */
+    void SetNematicForce(boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > pNematicForce);
+
+    /**
+     * Set the grid size.
+     *
+     * @param numGridPointsX number of grid points in x
+     * @param numGridPointsY number of grid points in y
+     */
+    void SetGridSize(unsigned numGridPointsX, unsigned numGridPointsY);
+
+    /**
+     * Set the coarse-graining kernel.
+     *
+     * @param kernel the kernel
+     * @param kernelWidth standard deviation of a GAUSSIAN kernel
+     */
+    void SetKernel(PeriodicGrid::Kernel kernel, double kernelWidth=1.0);
+
+    /**
+     * Set mSamplingTimestepMultiple.
+     *
+     * @param samplingTimestepMultiple the number of time steps between samples
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * @param gridIndex the index of a grid point
+     * @param field the index of a field (0 to NUM_FIELDS-1)
+     * @return the time average of the field at the grid point so far in
+     *     this Solve(), or 0 if no cell has contributed to it
+     */
+    double GetAverage(unsigned gridIndex, unsigned field);
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Sample every mSamplingTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Reset the averages. The initial state is not sampled since no
+     * forces have been computed yet.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Write the fields to file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS1(CoarseGrainedFieldsModifier, 2)
+
+#endif /*COARSEGRAINEDFIELDSMODIFIER_HPP_*/
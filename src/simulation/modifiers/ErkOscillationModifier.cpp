@@ -0,0 +1,343 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "ErkOscillationModifier.hpp"
+#include "Histogram.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+
+#include <cmath>
+
+/**
+ * Update a running mean and sum of squared deviations with a new value
+ * (Welford's algorithm).
+ *
+ * @param value the new value
+ * @param count the number of values including this one
+ * @param rMean the running mean
+ * @param rSumSquares the running sum of squared deviations from the mean
+ */
+static void UpdateMoments(double value, unsigned count, double& rMean, double& rSumSquares)
+{
+  double delta = value - rMean;
+  rMean += delta/count;
+  rSumSquares += delta*(value - rMean);
+}
+
+/**
+ * Detect an upward crossing of a signal through its mean, with
+ * hysteresis: the signal must have been more than threshold below the
+ * mean since the last crossing.
+ *
+ * @param lastValue the value at the previous sample
+ * @param value the current value
+ * @param mean the mean
+ * @param threshold the hysteresis threshold
+ * @param lastTime the time of the previous sample
+ * @param time the current time
+ * @param rArmed whether the detector is armed, updated
+ * @param rCrossingTime set to the interpolated crossing time if a crossing is detected
+ * @return whether an upward crossing occurred between the two samples
+ */
+static bool DetectUpwardCrossing(double lastValue, double value, double mean, double threshold,
+                                 double lastTime, double time, bool& rArmed, double& rCrossingTime)
+{
+  if (value < mean - threshold)
+    {
+      rArmed = true;
+    }
+  if (rArmed && lastValue < mean && value >= mean)
+    {
+      rArmed = false;
+      rCrossingTime = lastTime + (time - lastTime)*(mean - lastValue)/(value - lastValue);
+      return true;
+    }
+  return false;
+}
+
+template<unsigned DIM>
+ErkOscillationModifier<DIM>::ErkOscillationModifier()
+  : AbstractCellBasedSimulationModifier<DIM>(),
+    mSamplingTimestepMultiple(1),
+    mHysteresis(0.5),
+    mNumBins(20)
+{
+}
+
+template<unsigned DIM>
+ErkOscillationModifier<DIM>::~ErkOscillationModifier()
+{
+}
+
+template<unsigned DIM>
+void ErkOscillationModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+  assert(samplingTimestepMultiple > 0);
+  mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void ErkOscillationModifier<DIM>::SetHysteresis(double hysteresis)
+{
+  assert(hysteresis >= 0.0);
+  mHysteresis = hysteresis;
+}
+
+template<unsigned DIM>
+void ErkOscillationModifier<DIM>::SetNumBins(unsigned numBins)
+{
+  assert(numBins > 0);
+  mNumBins = numBins;
+}
+
+template<unsigned DIM>
+unsigned ErkOscillationModifier<DIM>::GetNumCycles(unsigned cellId)
+{
+  typename std::map<unsigned, CellOscillationState>::const_iterator it = mCellStates.find(cellId);
+  return (it == mCellStates.end()) ? 0 : it->second.mNumCycles;
+}
+
+template<unsigned DIM>
+double ErkOscillationModifier<DIM>::GetMeanPeriod(unsigned cellId)
+{
+  typename std::map<unsigned, CellOscillationState>::const_iterator it = mCellStates.find(cellId);
+  return (it == mCellStates.end()) ? 0.0 : it->second.mPeriodMean;
+}
+
+template<unsigned DIM>
+void ErkOscillationModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  if (SimulationTime::Instance()->GetTimeStepsElapsed()%mSamplingTimestepMultiple == 0)
+    {
+      RecordSample(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void ErkOscillationModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+  mOutputDirectory = outputDirectory;
+  mCellStates.clear();
+  RecordSample(rCellPopulation);
+}
+
+template<unsigned DIM>
+void ErkOscillationModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  WriteStatistics();
+}
+
+template<unsigned DIM>
+void ErkOscillationModifier<DIM>::RecordSample(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  double time = SimulationTime::Instance()->GetTime();
+
+  for (typename AbstractCellPopulation<DIM,DIM>::Iterator cell_iter = rCellPopulation.Begin();
+       cell_iter != rCellPopulation.End();
+       ++cell_iter)
+    {
+      double erk = cell_iter->GetCellData()->GetItem("Erk");
+      double area = cell_iter->GetCellData()->GetItem("volume");
+
+      std::pair<typename std::map<unsigned, CellOscillationState>::iterator, bool> inserted =
+        mCellStates.insert(std::make_pair(cell_iter->GetCellId(), CellOscillationState()));
+      CellOscillationState& r_state = inserted.first->second;
+      if (inserted.second)
+        {
+          // First sample of this cell
+          r_state.mNumSamples = 1;
+          r_state.mLastTime = time;
+          r_state.mErkMean = erk;
+          r_state.mErkSumSquares = 0.0;
+          r_state.mLastErk = erk;
+          r_state.mErkArmed = false;
+          r_state.mLastErkCrossing = -1.0;
+          r_state.mCycleMax = erk;
+          r_state.mCycleMin = erk;
+          r_state.mAreaMean = area;
+          r_state.mAreaSumSquares = 0.0;
+          r_state.mLastArea = area;
+          r_state.mAreaArmed = false;
+          r_state.mNumCycles = 0;
+          r_state.mPeriodMean = 0.0;
+          r_state.mPeriodSumSquares = 0.0;
+          r_state.mAmplitudeMean = 0.0;
+          r_state.mNumLags = 0;
+          r_state.mLagCosSum = 0.0;
+          r_state.mLagSinSum = 0.0;
+          continue;
+        }
+
+      r_state.mNumSamples++;
+      UpdateMoments(erk, r_state.mNumSamples, r_state.mErkMean, r_state.mErkSumSquares);
+      UpdateMoments(area, r_state.mNumSamples, r_state.mAreaMean, r_state.mAreaSumSquares);
+      double erk_threshold = mHysteresis*sqrt(r_state.mErkSumSquares/(r_state.mNumSamples - 1));
+      double area_threshold = mHysteresis*sqrt(r_state.mAreaSumSquares/(r_state.mNumSamples - 1));
+
+      // A new ERK cycle starts at each upward crossing
+      double crossing_time;
+      if (DetectUpwardCrossing(r_state.mLastErk, erk, r_state.mErkMean, erk_threshold,
+                               r_state.mLastTime, time, r_state.mErkArmed, crossing_time))
+        {
+          if (r_state.mLastErkCrossing >= 0.0)
+            {
+              r_state.mNumCycles++;
+              UpdateMoments(crossing_time - r_state.mLastErkCrossing, r_state.mNumCycles,
+                            r_state.mPeriodMean, r_state.mPeriodSumSquares);
+              r_state.mAmplitudeMean += (0.5*(r_state.mCycleMax - r_state.mCycleMin) - r_state.mAmplitudeMean)/r_state.mNumCycles;
+            }
+          r_state.mLastErkCrossing = crossing_time;
+          r_state.mCycleMax = erk;
+          r_state.mCycleMin = erk;
+        }
+      else
+        {
+          r_state.mCycleMax = std::max(r_state.mCycleMax, erk);
+          r_state.mCycleMin = std::min(r_state.mCycleMin, erk);
+        }
+
+      // Phase of area relative to the latest ERK cycle
+      if (DetectUpwardCrossing(r_state.mLastArea, area, r_state.mAreaMean, area_threshold,
+                               r_state.mLastTime, time, r_state.mAreaArmed, crossing_time)
+          && r_state.mNumCycles > 0)
+        {
+          double phase = 2.0*M_PI*(crossing_time - r_state.mLastErkCrossing)/r_state.mPeriodMean;
+          r_state.mNumLags++;
+          r_state.mLagCosSum += cos(phase);
+          r_state.mLagSinSum += sin(phase);
+        }
+
+      r_state.mLastErk = erk;
+      r_state.mLastArea = area;
+      r_state.mLastTime = time;
+    }
+}
+
+template<unsigned DIM>
+void ErkOscillationModifier<DIM>::WriteStatistics()
+{
+  // Per-cell summaries
+  std::vector<double> periods;
+  std::vector<double> period_stds;
+  std::vector<double> amplitudes;
+  std::vector<double> phase_lags;
+  double total_lag_cos = 0.0;
+  double total_lag_sin = 0.0;
+  unsigned total_num_lags = 0;
+  for (typename std::map<unsigned, CellOscillationState>::const_iterator it = mCellStates.begin();
+       it != mCellStates.end();
+       ++it)
+    {
+      const CellOscillationState& r_state = it->second;
+      if (r_state.mNumCycles > 0)
+        {
+          periods.push_back(r_state.mPeriodMean);
+          amplitudes.push_back(r_state.mAmplitudeMean);
+          if (r_state.mNumCycles > 1)
+            {
+              period_stds.push_back(sqrt(r_state.mPeriodSumSquares/(r_state.mNumCycles - 1)));
+            }
+        }
+      if (r_state.mNumLags > 0)
+        {
+          // Mean phase lag as a fraction of a cycle in [0, 1)
+          double lag = atan2(r_state.mLagSinSum, r_state.mLagCosSum)/(2.0*M_PI);
+          phase_lags.push_back(lag - floor(lag));
+          total_lag_cos += r_state.mLagCosSum;
+          total_lag_sin += r_state.mLagSinSum;
+          total_num_lags += r_state.mNumLags;
+        }
+    }
+
+  double mean_period = 0.0;
+  double std_period = 0.0;
+  for (unsigned i=0; i<periods.size(); i++)
+    {
+      mean_period += periods[i]/periods.size();
+    }
+  for (unsigned i=0; i<periods.size(); i++)
+    {
+      std_period += pow(periods[i] - mean_period, 2)/std::max<unsigned>(periods.size() - 1, 1);
+    }
+  std_period = sqrt(std_period);
+  double mean_amplitude = 0.0;
+  for (unsigned i=0; i<amplitudes.size(); i++)
+    {
+      mean_amplitude += amplitudes[i]/amplitudes.size();
+    }
+  double mean_phase_lag = atan2(total_lag_sin, total_lag_cos)/(2.0*M_PI);
+  mean_phase_lag -= floor(mean_phase_lag);
+  double phase_lag_coherence = (total_num_lags > 0) ? sqrt(total_lag_cos*total_lag_cos + total_lag_sin*total_lag_sin)/total_num_lags : 0.0;
+
+  OutputFileHandler output_file_handler(mOutputDirectory, false);
+  out_stream p_file = output_file_handler.OpenOutputFile("erk_oscillations.dat");
+  *p_file << "# Per-cell ERK oscillation statistics (see ErkOscillationModifier)\n"
+          << "num_cells " << mCellStates.size() << "\n"
+          << "num_oscillating_cells " << periods.size() << "\n"
+          << "mean_period " << mean_period << "\n"
+          << "std_period " << std_period << "\n"
+          << "mean_amplitude " << mean_amplitude << "\n"
+          << "mean_phase_lag " << mean_phase_lag << "\n"
+          << "phase_lag_coherence " << phase_lag_coherence << "\n";
+  Histogram::FromValues(periods, mNumBins).Write(*p_file, "period");
+  Histogram::FromValues(period_stds, mNumBins).Write(*p_file, "period_std");
+  Histogram::FromValues(amplitudes, mNumBins).Write(*p_file, "amplitude");
+  Histogram phase_lag_histogram(0.0, 1.0, mNumBins);
+  for (unsigned i=0; i<phase_lags.size(); i++)
+    {
+      phase_lag_histogram.Add(phase_lags[i]);
+    }
+  phase_lag_histogram.Write(*p_file, "phase_lag");
+  p_file->close();
+}
+
+template<unsigned DIM>
+void ErkOscillationModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+  *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+  *rParamsFile << "\t\t\t<Hysteresis>" << mHysteresis << "</Hysteresis>\n";
+  *rParamsFile << "\t\t\t<NumBins>" << mNumBins << "</NumBins>\n";
+
+  // Call method on direct parent class
+  AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+// template class ErkOscillationModifier<1>;
+template class ErkOscillationModifier<2>;
+// template class ErkOscillationModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ErkOscillationModifier)
@@ -0,0 +1,266 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef ERKOSCILLATIONMODIFIER_HPP_
+#define ERKOSCILLATIONMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+
+#include <map>
+
+/**
+ * A modifier class that estimates the period and amplitude of each
+ * cell's ERK oscillation, and the phase lag between its area and its
+ * ERK level, while the simulation runs and with a fixed amount of
+ * memory per cell.
+ *
+ * Every mSamplingTimestepMultiple time steps each cell's "Erk" and
+ * "volume" CellData update running means and variances. An upward
+ * crossing of the running mean, located by linear interpolation
+ * between samples, starts a new cycle. To ignore noise, the signal
+ * must first fall more than mHysteresis standard deviations below the
+ * mean. The time between successive ERK crossings gives one period
+ * and half the range of ERK over the cycle one amplitude. Each area
+ * crossing gives the phase by which area lags ERK, as a fraction of
+ * the cell's mean period. Running moments of the period and amplitude
+ * and the circular mean of the phase lag are kept for each cell.
+ *
+ * At the end of Solve() histograms over cells of the mean period,
+ * amplitude and phase lag are written to erk_oscillations.dat in the
+ * simulation output directory, with summary statistics.
+ *
+ * Only the parameters are archived; the statistics are accumulated
+ * afresh in each call to Solve().
+ */
+template<unsigned DIM>
+class ErkOscillationModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mSamplingTimestepMultiple;
+        archive & mHysteresis;
+        archive & mNumBins;
+    }
+
+    /** The running statistics kept for each cell. */
+    struct CellOscillationState
+    {
+        /** The number of samples seen. */
+        unsigned mNumSamples;
+
+        /** Time of the previous sample. */
+        double mLastTime;
+
+        /** Running mean of ERK. */
+        double mErkMean;
+
+        /** Running sum of squared deviations of ERK from its mean. */
+        double mErkSumSquares;
+
+        /** ERK at the previous sample. */
+        double mLastErk;
+
+        /** Whether ERK has fallen far enough below its mean to count the next upward crossing. */
+        bool mErkArmed;
+
+        /** Time of the last upward crossing of ERK, or a negative value if none yet. */
+        double mLastErkCrossing;
+
+        /** Largest ERK level since the last crossing. */
+        double mCycleMax;
+
+        /** Smallest ERK level since the last crossing. */
+        double mCycleMin;
+
+        /** Running mean of area. */
+        double mAreaMean;
+
+        /** Running sum of squared deviations of area from its mean. */
+        double mAreaSumSquares;
+
+        /** Area at the previous sample. */
+        double mLastArea;
+
+        /** Whether area has fallen far enough below its mean to count the next upward crossing. */
+        bool mAreaArmed;
+
+        /** The number of complete ERK cycles. */
+        unsigned mNumCycles;
+
+        /** Running mean of the period. */
+        double mPeriodMean;
+
+        /** Running sum of squared deviations of the period from its mean. */
+        double mPeriodSumSquares;
+
+        /** Running mean of the amplitude. */
+        double mAmplitudeMean;
+
+        /** The number of phase lags measured. */
+        unsigned mNumLags;
+
+        /** Sum of the cosine of each phase lag. */
+        double mLagCosSum;
+
+        /** Sum of the sine of each phase lag. */
+        double mLagSinSum;
+    };
+
+    /** Number of time steps between samples. Defaults to 1. */
+    unsigned mSamplingTimestepMultiple;
+
+    /** Number of standard deviations below the mean needed to arm the crossing detector. Defaults to 0.5. */
+    double mHysteresis;
+
+    /** Number of bins in each histogram. Defaults to 20. */
+    unsigned mNumBins;
+
+    /** The statistics of each cell, by cell id. */
+    std::map<unsigned, CellOscillationState> mCellStates;
+
+    /** The output directory of the simulation. */
+    std::string mOutputDirectory;
+
+    /**
+     * Update the statistics of every cell with its current ERK and area.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void RecordSample(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Write histograms and summary statistics to file.
+     */
+    void WriteStatistics();
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    ErkOscillationModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~ErkOscillationModifier();
+
+    /**
+     * Set mSamplingTimestepMultiple.
+     *
+     * @param samplingTimestepMultiple the number of time steps between samples
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * Set mHysteresis.
+     *
+     * @param hysteresis the number of standard deviations below the mean needed to arm the crossing detector
+     */
+    void SetHysteresis(double hysteresis);
+
+    /**
+     * Set mNumBins.
+     *
+     * @param numBins the number of bins in each histogram
+     */
+    void SetNumBins(unsigned numBins);
+
+    /**
+     * @param cellId the id of a cell
+     * @return the number of complete ERK cycles of that cell so far in this Solve()
+     */
+    unsigned GetNumCycles(unsigned cellId);
+
+    /**
+     * @param cellId the id of a cell
+     * @return the mean ERK period of that cell so far in this Solve(), or 0 if no cycle is complete
+     */
+    double GetMeanPeriod(unsigned cellId);
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Sample every mSamplingTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Reset the statistics and take the initial sample.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Write the histograms to file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ErkOscillationModifier)
+
+#endif /*ERKOSCILLATIONMODIFIER_HPP_*/
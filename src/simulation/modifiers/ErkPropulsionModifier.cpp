@@ -0,0 +1,277 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ErkPropulsionModifierNoAlignment.hpp"
+#include "ErkPropulsionModifierVelocityAlignment.hpp"
+#include "ErkPropulsionModifierNeighbourAlignment.hpp"
+#include "ErkPropulsionSrnModel.hpp"
+#include "ReorderableToroidal2dVertexMesh.hpp"
+
+#include <type_traits>
+
+template<unsigned DIM, class ALIGNMENT>
+ErkPropulsionModifier<DIM,ALIGNMENT>::ErkPropulsionModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mAlignToNeighbourVelocities(false)
+{
+}
+
+template<unsigned DIM, class ALIGNMENT>
+ErkPropulsionModifier<DIM,ALIGNMENT>::~ErkPropulsionModifier()
+{
+}
+
+template<unsigned DIM, class ALIGNMENT>
+void ErkPropulsionModifier<DIM,ALIGNMENT>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    UpdateCellData(rCellPopulation);
+    double current_time = SimulationTime::Instance()->GetTime();
+    std::cout << "time " << current_time << std::endl;
+}
+
+template<unsigned DIM, class ALIGNMENT>
+void ErkPropulsionModifier<DIM,ALIGNMENT>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    /*
+     * Update CellData in SetupSolve(), to assure that it has been
+     * fully initialised before we enter the main time loop.
+     */
+    // UpdateCellData(rCellPopulation);    // Already doing this explicitly during setup in TestERKWaveWithSelfPropulsionNoAlignment.hpp
+}
+
+template<unsigned DIM, class ALIGNMENT>
+void ErkPropulsionModifier<DIM,ALIGNMENT>::UpdateCellData(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    rCellPopulation.Update();
+
+    // Iterate over the population to compute and update each cell's
+    // data from the ODE solver to the population CellData.
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+      // Get the current values of ERK and theta for this cell
+      ErkPropulsionSrnModel<ALIGNMENT>* p_model = static_cast<ErkPropulsionSrnModel<ALIGNMENT>*>(cell_iter->GetSrnModel());
+
+      // Get the ERK value for this cell from the solver and update in
+      // CellData
+      double this_erk = p_model->GetErk();
+      cell_iter->GetCellData()->SetItem("Erk", this_erk);
+
+      // Get the target area for this cell from the solver and update
+      // in CellData
+      double this_target_area = p_model->GetTargetArea();
+      cell_iter->GetCellData()->SetItem("Target Area", this_target_area);
+
+      // Get the area for this cell from the solver and update in
+      // CellData
+      double cell_volume = rCellPopulation.GetVolumeOfCell(*cell_iter);
+      cell_iter->GetCellData()->SetItem("volume", cell_volume);
+
+      // Get the self-propulsion angle for this cell from the solver and update
+      // in CellData
+      double this_theta = p_model->GetTheta();
+      // Map theta to the range -Pi and Pi for better visualization in
+      // VTK output. Makes no difference for the ODE system which
+      // takes the sine and cosine.
+      this_theta = atan2(sin(this_theta), cos(this_theta));
+      cell_iter->GetCellData()->SetItem("Theta", this_theta);
+    }
+
+    // Resolved at compile time, so the non-aligning policy does no work here
+    UpdateAlignmentAngles(rCellPopulation, ALIGNMENT());
+}
+
+template<unsigned DIM, class ALIGNMENT>
+void ErkPropulsionModifier<DIM,ALIGNMENT>::UpdateAlignmentAngles(AbstractCellPopulation<DIM,DIM>& rCellPopulation, VelocityAlignment)
+{
+    double time_step = SimulationTime::Instance()->GetTimeStep();
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+      // Get the current cell center location
+      c_vector<double, DIM> new_loc = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+      // Get the old cell center location from CellData
+      c_vector<double, DIM> old_loc = zero_vector<double>(DIM);
+      old_loc[0] = cell_iter->GetCellData()->GetItem("loc_x");
+      old_loc[1] = cell_iter->GetCellData()->GetItem("loc_y");
+
+      // Update the cell center location in CellData
+      cell_iter->GetCellData()->SetItem("loc_x", new_loc[0]);
+      cell_iter->GetCellData()->SetItem("loc_y", new_loc[1]);
+
+      // Calculate the velocity
+      c_vector<double, DIM> velocity = zero_vector<double>(DIM);
+      velocity = (new_loc - old_loc)/time_step;
+
+      // Update the velocity theta in CellData. ISSUE: If velocity is
+      // zero atan2 returns 0.0 and cells align towards
+      // theta_vi=0. TODO: Implement velocity alignment dependent on
+      // velocity magnitude.
+      double theta_vi = atan2(velocity[1], velocity[0]);
+      cell_iter->GetCellData()->SetItem("theta_vi", theta_vi);
+    }
+}
+
+template<unsigned DIM, class ALIGNMENT>
+void ErkPropulsionModifier<DIM,ALIGNMENT>::UpdateAlignmentAngles(AbstractCellPopulation<DIM,DIM>& rCellPopulation, NeighbourAlignment)
+{
+    ReorderableToroidal2dVertexMesh* p_mesh = dynamic_cast<ReorderableToroidal2dVertexMesh*>(&(rCellPopulation.rGetMesh()));
+    if (p_mesh == nullptr)
+    {
+        EXCEPTION("NeighbourAlignment requires a VertexBasedCellPopulation on a ReorderableToroidal2dVertexMesh");
+    }
+
+    // The half-edges of element e, numbered consecutively, point to
+    // its edge-sharing neighbours through their twins, so they form a
+    // CSR neighbour list. The view is cached by the mesh and only
+    // rebuilt after ReMesh() has changed the topology.
+    const HalfEdgeMeshView& r_half_edges = p_mesh->rGetHalfEdges();
+
+    // First pass: the direction each cell contributes to its
+    // neighbours' mean, indexed by element (= location index)
+    unsigned num_elements = p_mesh->GetNumAllElements();
+    mAlignmentDirectionsX.assign(num_elements, 0.0);
+    mAlignmentDirectionsY.assign(num_elements, 0.0);
+    mCellsByElement.assign(num_elements, CellPtr());
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+      unsigned elem_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
+      mCellsByElement[elem_index] = *cell_iter;
+
+      if (mAlignToNeighbourVelocities)
+      {
+          // The displacement over the last time step has the direction
+          // of the velocity, and its periodic image is the short one
+          c_vector<double, DIM> new_loc = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+          c_vector<double, DIM> old_loc = new_loc;
+          old_loc[0] = cell_iter->GetCellData()->GetItem("loc_x");
+          old_loc[1] = cell_iter->GetCellData()->GetItem("loc_y");
+          cell_iter->GetCellData()->SetItem("loc_x", new_loc[0]);
+          cell_iter->GetCellData()->SetItem("loc_y", new_loc[1]);
+
+          c_vector<double, DIM> displacement = rCellPopulation.rGetMesh().GetVectorFromAtoB(old_loc, new_loc);
+          mAlignmentDirectionsX[elem_index] = displacement[0];
+          mAlignmentDirectionsY[elem_index] = displacement[1];
+      }
+      else
+      {
+          double theta = static_cast<ErkPropulsionSrnModel<ALIGNMENT>*>(cell_iter->GetSrnModel())->GetTheta();
+          mAlignmentDirectionsX[elem_index] = cos(theta);
+          mAlignmentDirectionsY[elem_index] = sin(theta);
+      }
+    }
+
+    // Second pass: average over each cell's neighbours
+    for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+    {
+      CellPtr p_cell = mCellsByElement[elem_index];
+      if (!p_cell)
+      {
+          continue;
+      }
+
+      double sum_x = 0.0;
+      double sum_y = 0.0;
+      unsigned first = r_half_edges.GetFirstHalfEdge(elem_index);
+      unsigned end = first + r_half_edges.GetNumHalfEdgesOfElement(elem_index);
+      for (unsigned half_edge=first; half_edge<end; half_edge++)
+      {
+          unsigned twin = r_half_edges.GetTwin(half_edge);
+          if (twin != HalfEdgeMeshView::NONE)
+          {
+              unsigned neighbour_index = r_half_edges.GetFace(twin);
+              sum_x += mAlignmentDirectionsX[neighbour_index];
+              sum_y += mAlignmentDirectionsY[neighbour_index];
+          }
+      }
+
+      double theta_vi;
+      if (sum_x == 0.0 && sum_y == 0.0)
+      {
+          // No preferred direction, so no torque
+          theta_vi = p_cell->GetCellData()->GetItem("Theta");
+      }
+      else
+      {
+          theta_vi = atan2(sum_y, sum_x);
+      }
+      p_cell->GetCellData()->SetItem("theta_vi", theta_vi);
+    }
+}
+
+template<unsigned DIM, class ALIGNMENT>
+bool ErkPropulsionModifier<DIM,ALIGNMENT>::GetAlignToNeighbourVelocities() const
+{
+    return mAlignToNeighbourVelocities;
+}
+
+template<unsigned DIM, class ALIGNMENT>
+void ErkPropulsionModifier<DIM,ALIGNMENT>::SetAlignToNeighbourVelocities(bool alignToNeighbourVelocities)
+{
+    mAlignToNeighbourVelocities = alignToNeighbourVelocities;
+}
+
+template<unsigned DIM, class ALIGNMENT>
+void ErkPropulsionModifier<DIM,ALIGNMENT>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    if (std::is_same<ALIGNMENT, NeighbourAlignment>::value)
+    {
+        *rParamsFile << "\t\t\t<AlignToNeighbourVelocities>" << mAlignToNeighbourVelocities << "</AlignToNeighbourVelocities>\n";
+    }
+
+    // Call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class ErkPropulsionModifier<1,NoAlignment>;
+template class ErkPropulsionModifier<2,NoAlignment>;
+template class ErkPropulsionModifier<3,NoAlignment>;
+// template class ErkPropulsionModifier<1,VelocityAlignment>;
+template class ErkPropulsionModifier<2,VelocityAlignment>;
+template class ErkPropulsionModifier<3,VelocityAlignment>;
+// template class ErkPropulsionModifier<1,NeighbourAlignment>;
+template class ErkPropulsionModifier<2,NeighbourAlignment>;
+// template class ErkPropulsionModifier<3,NeighbourAlignment>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ErkPropulsionModifierNoAlignment)
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ErkPropulsionModifierVelocityAlignment)
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ErkPropulsionModifierNeighbourAlignment)
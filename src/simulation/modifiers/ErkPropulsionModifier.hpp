@@ -0,0 +1,187 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ERKPROPULSIONMODIFIER_HPP_
+#define ERKPROPULSIONMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include <vector>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "ErkPropulsionAlignmentPolicies.hpp"
+
+/**
+ * A modifier class which copies the ERK level, target area and self
+ * propulsion angle of each cell's ErkPropulsionSrnModel<ALIGNMENT>,
+ * and the cell's area, to the CellData. Aligning policies also store
+ * the angle theta_vi that the self propulsion angle aligns with.
+ *
+ * Instantiated for NoAlignment and, in 2D and 3D, VelocityAlignment,
+ * and for NeighbourAlignment in 2D.
+ */
+template<unsigned DIM, class ALIGNMENT>
+class ErkPropulsionModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mAlignToNeighbourVelocities;
+    }
+
+    /**
+     * Whether NeighbourAlignment aligns with the mean velocity of the
+     * neighbours, rather than their mean polarity. Defaults to false.
+     */
+    bool mAlignToNeighbourVelocities;
+
+    /** Work space: the direction each cell contributes to its neighbours' mean, indexed by element. */
+    std::vector<double> mAlignmentDirectionsX;
+
+    /** Work space: the direction each cell contributes to its neighbours' mean, indexed by element. */
+    std::vector<double> mAlignmentDirectionsY;
+
+    /** Work space: the cell of each element. */
+    std::vector<CellPtr> mCellsByElement;
+
+    /**
+     * Without alignment there is no alignment angle to update.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void UpdateAlignmentAngles(AbstractCellPopulation<DIM,DIM>& rCellPopulation, NoAlignment)
+    {
+    }
+
+    /**
+     * Store the direction of each cell's velocity, found by finite
+     * differencing its centre location ("loc_x", "loc_y"), as
+     * "theta_vi" in the CellData.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void UpdateAlignmentAngles(AbstractCellPopulation<DIM,DIM>& rCellPopulation, VelocityAlignment);
+
+    /**
+     * Store the direction of the mean polarity (cos theta, sin theta),
+     * or of the mean velocity, of the cells sharing an edge with each
+     * cell as "theta_vi" in the CellData. A cell whose neighbours'
+     * mean vanishes is given its own theta, so it feels no torque.
+     *
+     * The neighbours are read from the half-edge view of the mesh,
+     * which is only rebuilt when the topology changes, so this is one
+     * O(N) pass over the cells per time step. Requires a
+     * VertexBasedCellPopulation on a ReorderableToroidal2dVertexMesh.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void UpdateAlignmentAngles(AbstractCellPopulation<DIM,DIM>& rCellPopulation, NeighbourAlignment);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    ErkPropulsionModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~ErkPropulsionModifier();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Specifies what to do in the simulation at the end of each time step.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Specifies what to do in the simulation before the start of the time loop.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Helper method to copy each cell's SRN state and area, and the
+     * alignment angle of aligning policies, to the CellData.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void UpdateCellData(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * @return whether NeighbourAlignment aligns with the neighbours'
+     *     velocities rather than their polarities
+     */
+    bool GetAlignToNeighbourVelocities() const;
+
+    /**
+     * Set whether NeighbourAlignment aligns with the mean velocity of
+     * the neighbours, found by finite differencing their centres
+     * ("loc_x", "loc_y" in the CellData, which must be initialised),
+     * rather than their mean polarity.
+     *
+     * @param alignToNeighbourVelocities whether to align with velocities
+     */
+    void SetAlignToNeighbourVelocities(bool alignToNeighbourVelocities);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#endif /*ERKPROPULSIONMODIFIER_HPP_*/
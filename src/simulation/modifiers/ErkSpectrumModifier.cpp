@@ -0,0 +1,361 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "ErkSpectrumModifier.hpp"
+#include "Fft.hpp"
+#include "PeriodicGrid.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+
+/**
+ * Locate the largest value of a spectrum, excluding the zero
+ * frequency or wave number, to within a fraction of a bin by fitting
+ * a parabola through it and its neighbours.
+ *
+ * @param rPower the spectrum (at least two values)
+ * @return the interpolated index of the peak
+ */
+static double FindPeak(const std::vector<double>& rPower)
+{
+  unsigned peak = std::max_element(rPower.begin() + 1, rPower.end()) - rPower.begin();
+  double offset = 0.0;
+  if (peak + 1 < rPower.size())
+    {
+      double curvature = rPower[peak-1] - 2.0*rPower[peak] + rPower[peak+1];
+      if (curvature < 0.0)
+        {
+          offset = 0.5*(rPower[peak-1] - rPower[peak+1])/curvature;
+        }
+    }
+  return peak + offset;
+}
+
+template<unsigned DIM>
+ErkSpectrumModifier<DIM>::ErkSpectrumModifier()
+  : AbstractCellBasedSimulationModifier<DIM>(),
+    mNumGridPointsX(16),
+    mNumGridPointsY(16),
+    mSegmentLength(64),
+    mSamplingTimestepMultiple(1),
+    mNumFrames(0),
+    mNumSegments(0)
+{
+  mDomainSize[0] = 0.0;
+  mDomainSize[1] = 0.0;
+}
+
+template<unsigned DIM>
+ErkSpectrumModifier<DIM>::~ErkSpectrumModifier()
+{
+}
+
+template<unsigned DIM>
+void ErkSpectrumModifier<DIM>::SetGridSize(unsigned numGridPointsX, unsigned numGridPointsY)
+{
+  if (numGridPointsX < 2 || numGridPointsY < 2 || !Fft::IsPowerOfTwo(numGridPointsX) || !Fft::IsPowerOfTwo(numGridPointsY))
+    {
+      EXCEPTION("The ERK spectrum grid size must be a power of two and at least 2 in each direction");
+    }
+  mNumGridPointsX = numGridPointsX;
+  mNumGridPointsY = numGridPointsY;
+}
+
+template<unsigned DIM>
+void ErkSpectrumModifier<DIM>::SetSegmentLength(unsigned segmentLength)
+{
+  if (segmentLength < 2 || !Fft::IsPowerOfTwo(segmentLength))
+    {
+      EXCEPTION("The ERK spectrum segment length must be a power of two and at least 2");
+    }
+  mSegmentLength = segmentLength;
+}
+
+template<unsigned DIM>
+void ErkSpectrumModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+  assert(samplingTimestepMultiple > 0);
+  mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+unsigned ErkSpectrumModifier<DIM>::GetNumSegments()
+{
+  return mNumSegments;
+}
+
+template<unsigned DIM>
+void ErkSpectrumModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  if (SimulationTime::Instance()->GetTimeStepsElapsed()%mSamplingTimestepMultiple == 0)
+    {
+      RecordFrame(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void ErkSpectrumModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+  mOutputDirectory = outputDirectory;
+
+  // The periodic width and height of the (toroidal) mesh
+  mDomainSize[0] = rCellPopulation.rGetMesh().GetWidth(0);
+  mDomainSize[1] = rCellPopulation.rGetMesh().GetWidth(1);
+
+  mFrames.assign(mSegmentLength, std::vector<double>(mNumGridPointsX*mNumGridPointsY, 0.0));
+  mNumFrames = 0;
+  mPower.assign(mSegmentLength*mNumGridPointsX*mNumGridPointsY, 0.0);
+  mNumSegments = 0;
+
+  RecordFrame(rCellPopulation);
+}
+
+template<unsigned DIM>
+void ErkSpectrumModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  WriteSpectrum();
+}
+
+template<unsigned DIM>
+void ErkSpectrumModifier<DIM>::RecordFrame(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  PeriodicGrid grid(mNumGridPointsX, mNumGridPointsY, mDomainSize[0], mDomainSize[1]);
+  std::vector<double> erk_sums(grid.GetNumPoints(), 0.0);
+  std::vector<double> weights(grid.GetNumPoints(), 0.0);
+  std::vector<std::pair<unsigned, double> > stencil;
+  double total_erk = 0.0;
+  unsigned num_cells = 0;
+
+  for (typename AbstractCellPopulation<DIM,DIM>::Iterator cell_iter = rCellPopulation.Begin();
+       cell_iter != rCellPopulation.End();
+       ++cell_iter)
+    {
+      double erk = cell_iter->GetCellData()->GetItem("Erk");
+      c_vector<double, DIM> centroid = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+      grid.GetStencil(centroid[0], centroid[1], stencil);
+      for (unsigned i=0; i<stencil.size(); i++)
+        {
+          erk_sums[stencil[i].first] += stencil[i].second*erk;
+          weights[stencil[i].first] += stencil[i].second;
+        }
+      total_erk += erk;
+      num_cells++;
+    }
+
+  // Grid points with no nearby cell centroid (only possible if the
+  // grid is finer than the cells) take the mean value
+  double mean_erk = (num_cells > 0) ? total_erk/num_cells : 0.0;
+  std::vector<double>& r_frame = mFrames[mNumFrames%mSegmentLength];
+  for (unsigned i=0; i<r_frame.size(); i++)
+    {
+      r_frame[i] = (weights[i] > 0.0) ? erk_sums[i]/weights[i] : mean_erk;
+    }
+  mNumFrames++;
+
+  // Segments overlap by half
+  if (mNumFrames >= mSegmentLength && (mNumFrames - mSegmentLength)%(mSegmentLength/2) == 0)
+    {
+      AccumulateSegment();
+    }
+}
+
+template<unsigned DIM>
+void ErkSpectrumModifier<DIM>::AccumulateSegment()
+{
+  unsigned num_points = mNumGridPointsX*mNumGridPointsY;
+
+  // Remove the mean of the segment
+  double mean = 0.0;
+  for (unsigned t=0; t<mSegmentLength; t++)
+    {
+      for (unsigned i=0; i<num_points; i++)
+        {
+          mean += mFrames[t][i];
+        }
+    }
+  mean /= mSegmentLength*num_points;
+
+  // Copy the frames in time order, applying a (periodic) Hann window
+  std::vector<std::complex<double> > data(mSegmentLength*num_points);
+  double window_power = 0.0;
+  unsigned first_frame = mNumFrames - mSegmentLength;
+  for (unsigned t=0; t<mSegmentLength; t++)
+    {
+      double window = 0.5*(1.0 - cos(2.0*M_PI*t/mSegmentLength));
+      window_power += window*window;
+      const std::vector<double>& r_frame = mFrames[(first_frame + t)%mSegmentLength];
+      for (unsigned i=0; i<num_points; i++)
+        {
+          data[t*num_points + i] = window*(r_frame[i] - mean);
+        }
+    }
+
+  std::vector<unsigned> shape(3);
+  shape[0] = mSegmentLength;
+  shape[1] = mNumGridPointsY;
+  shape[2] = mNumGridPointsX;
+  for (unsigned axis=0; axis<3; axis++)
+    {
+      Fft::TransformAxis(data, shape, axis);
+    }
+
+  double normalisation = 1.0/(window_power*num_points);
+  for (unsigned i=0; i<data.size(); i++)
+    {
+      mPower[i] += std::norm(data[i])*normalisation;
+    }
+  mNumSegments++;
+}
+
+template<unsigned DIM>
+void ErkSpectrumModifier<DIM>::WriteSpectrum()
+{
+  double sample_interval = mSamplingTimestepMultiple*SimulationTime::Instance()->GetTimeStep();
+
+  // Non-negative frequencies (negative ones are folded onto these)
+  unsigned num_frequencies = mSegmentLength/2 + 1;
+
+  // Bin wave vectors by magnitude, in steps of the coarser of the two
+  // fundamental wave numbers
+  double bin_width = std::max(1.0/mDomainSize[0], 1.0/mDomainSize[1]);
+  double max_wave_number = sqrt(pow(0.5*mNumGridPointsX/mDomainSize[0], 2) + pow(0.5*mNumGridPointsY/mDomainSize[1], 2));
+  unsigned num_bins = static_cast<unsigned>(floor(max_wave_number/bin_width + 0.5)) + 1;
+
+  std::vector<double> binned_power(num_frequencies*num_bins, 0.0);
+  if (mNumSegments > 0)
+    {
+      for (unsigned t=0; t<mSegmentLength; t++)
+        {
+          unsigned frequency_index = (t < num_frequencies) ? t : mSegmentLength - t;
+          for (unsigned j=0; j<mNumGridPointsY; j++)
+            {
+              int signed_j = (j <= mNumGridPointsY/2) ? (int)j : (int)j - (int)mNumGridPointsY;
+              double ky = signed_j/mDomainSize[1];
+              for (unsigned i=0; i<mNumGridPointsX; i++)
+                {
+                  int signed_i = (i <= mNumGridPointsX/2) ? (int)i : (int)i - (int)mNumGridPointsX;
+                  double kx = signed_i/mDomainSize[0];
+                  unsigned bin = static_cast<unsigned>(floor(sqrt(kx*kx + ky*ky)/bin_width + 0.5));
+                  binned_power[frequency_index*num_bins + bin] += mPower[(t*mNumGridPointsY + j)*mNumGridPointsX + i]/mNumSegments;
+                }
+            }
+        }
+    }
+
+  // Marginal spectra and the location of their (non-zero) peaks
+  std::vector<double> temporal_power(num_frequencies, 0.0);
+  std::vector<double> spatial_power(num_bins, 0.0);
+  for (unsigned f=0; f<num_frequencies; f++)
+    {
+      for (unsigned b=0; b<num_bins; b++)
+        {
+          temporal_power[f] += binned_power[f*num_bins + b];
+          spatial_power[b] += binned_power[f*num_bins + b];
+        }
+    }
+  double peak_period = std::numeric_limits<double>::quiet_NaN();
+  double peak_wavelength = std::numeric_limits<double>::quiet_NaN();
+  if (mNumSegments > 0)
+    {
+      peak_period = mSegmentLength*sample_interval/FindPeak(temporal_power);
+      peak_wavelength = 1.0/(FindPeak(spatial_power)*bin_width);
+    }
+
+  OutputFileHandler output_file_handler(mOutputDirectory, false);
+  out_stream p_file = output_file_handler.OpenOutputFile("erk_spectrum.dat");
+  *p_file << "# ERK space-time power spectrum (see ErkSpectrumModifier)\n"
+          << "grid " << mNumGridPointsX << " " << mNumGridPointsY << "\n"
+          << "domain " << mDomainSize[0] << " " << mDomainSize[1] << "\n"
+          << "sample_interval " << sample_interval << "\n"
+          << "segment_length " << mSegmentLength << "\n"
+          << "num_frames " << mNumFrames << "\n"
+          << "num_segments " << mNumSegments << "\n"
+          << "peak_period " << peak_period << "\n"
+          << "peak_wavelength " << peak_wavelength << "\n";
+
+  *p_file << "frequencies";
+  for (unsigned f=0; f<num_frequencies; f++)
+    {
+      *p_file << " " << f/(mSegmentLength*sample_interval);
+    }
+  *p_file << "\nwave_numbers";
+  for (unsigned b=0; b<num_bins; b++)
+    {
+      *p_file << " " << b*bin_width;
+    }
+  *p_file << "\ntemporal_power";
+  for (unsigned f=0; f<num_frequencies; f++)
+    {
+      *p_file << " " << temporal_power[f];
+    }
+  *p_file << "\nspatial_power";
+  for (unsigned b=0; b<num_bins; b++)
+    {
+      *p_file << " " << spatial_power[b];
+    }
+  *p_file << "\n# space_time_power: one row per frequency, one column per wave number bin\n";
+  for (unsigned f=0; f<num_frequencies; f++)
+    {
+      for (unsigned b=0; b<num_bins; b++)
+        {
+          *p_file << binned_power[f*num_bins + b] << ((b + 1 < num_bins) ? " " : "\n");
+        }
+    }
+  p_file->close();
+}
+
+template<unsigned DIM>
+void ErkSpectrumModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+  *rParamsFile << "\t\t\t<NumGridPointsX>" << mNumGridPointsX << "</NumGridPointsX>\n";
+  *rParamsFile << "\t\t\t<NumGridPointsY>" << mNumGridPointsY << "</NumGridPointsY>\n";
+  *rParamsFile << "\t\t\t<SegmentLength>" << mSegmentLength << "</SegmentLength>\n";
+  *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+
+  // Call method on direct parent class
+  AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+// template class ErkSpectrumModifier<1>;
+template class ErkSpectrumModifier<2>;
+// template class ErkSpectrumModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ErkSpectrumModifier)
@@ -0,0 +1,216 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef ERKSPECTRUMMODIFIER_HPP_
+#define ERKSPECTRUMMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+
+#include <vector>
+
+/**
+ * A modifier class that measures ERK waves in situ, instead of
+ * writing every cell's ERK time series to file for post-processing.
+ *
+ * Every mSamplingTimestepMultiple time steps the "Erk" CellData of
+ * each cell is deposited onto a regular grid covering the periodic
+ * domain (cloud-in-cell assignment at the cell centroid), and the
+ * frame is stored in a ring buffer. Whenever a segment of
+ * mSegmentLength frames is complete, overlapping the previous one by
+ * half, its mean is removed, a Hann window is applied in time and the
+ * squared modulus of its space-time FFT is accumulated (Welch's
+ * method).
+ *
+ * At the end of Solve() the averaged spectrum is binned by frequency
+ * and by the magnitude of the wave vector, and written to
+ * erk_spectrum.dat in the simulation output directory together with
+ * the period and wavelength at which the power peaks. The grid size
+ * in each direction and the segment length must be powers of two.
+ *
+ * Only the parameters are archived; the spectrum is accumulated
+ * afresh in each call to Solve().
+ */
+template<unsigned DIM>
+class ErkSpectrumModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mNumGridPointsX;
+        archive & mNumGridPointsY;
+        archive & mSegmentLength;
+        archive & mSamplingTimestepMultiple;
+    }
+
+    /** Number of grid points in x. Defaults to 16. */
+    unsigned mNumGridPointsX;
+
+    /** Number of grid points in y. Defaults to 16. */
+    unsigned mNumGridPointsY;
+
+    /** Number of frames in each Welch segment. Defaults to 64. */
+    unsigned mSegmentLength;
+
+    /** Number of time steps between frames. Defaults to 1. */
+    unsigned mSamplingTimestepMultiple;
+
+    /** Width and height of the periodic domain. */
+    double mDomainSize[2];
+
+    /** Ring buffer of the last mSegmentLength frames. */
+    std::vector<std::vector<double> > mFrames;
+
+    /** The number of frames recorded in this Solve(). */
+    unsigned mNumFrames;
+
+    /** Sum over segments of the space-time power, indexed [frequency][y wave number][x wave number]. */
+    std::vector<double> mPower;
+
+    /** The number of segments accumulated in mPower. */
+    unsigned mNumSegments;
+
+    /** The output directory of the simulation. */
+    std::string mOutputDirectory;
+
+    /**
+     * Deposit ERK onto the grid and add the frame to the ring buffer,
+     * accumulating a segment if one is complete.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void RecordFrame(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Add the power spectrum of the last mSegmentLength frames to mPower.
+     */
+    void AccumulateSegment();
+
+    /**
+     * Write the binned spectrum and peak estimates to file.
+     */
+    void WriteSpectrum();
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    ErkSpectrumModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~ErkSpectrumModifier();
+
+    /**
+     * Set the grid size.
+     *
+     * @param numGridPointsX number of grid points in x (a power of two, at least 2)
+     * @param numGridPointsY number of grid points in y (a power of two, at least 2)
+     */
+    void SetGridSize(unsigned numGridPointsX, unsigned numGridPointsY);
+
+    /**
+     * Set mSegmentLength.
+     *
+     * @param segmentLength the number of frames in each Welch segment (a power of two, at least 2)
+     */
+    void SetSegmentLength(unsigned segmentLength);
+
+    /**
+     * Set mSamplingTimestepMultiple.
+     *
+     * @param samplingTimestepMultiple the number of time steps between frames
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * @return the number of segments averaged so far in this Solve()
+     */
+    unsigned GetNumSegments();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Record a frame every mSamplingTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Reset the spectrum and record the initial frame.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Write the spectrum to file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ErkSpectrumModifier)
+
+#endif /*ERKSPECTRUMMODIFIER_HPP_*/
@@ -0,0 +1,164 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "ForceBudgetModifier.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+
+template<unsigned DIM>
+ForceBudgetModifier<DIM>::ForceBudgetModifier()
+  : AbstractCellBasedSimulationModifier<DIM>(),
+    mSamplingTimestepMultiple(1),
+    mNematicWork(0.0),
+    mPropulsionWork(0.0),
+    mShearWork(0.0)
+{
+}
+
+template<unsigned DIM>
+ForceBudgetModifier<DIM>::~ForceBudgetModifier()
+{
+}
+
+template<unsigned DIM>
+void ForceBudgetModifier<DIM>::SetNematicForce(boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > pNematicForce)
+{
+  mpNematicForce = pNematicForce;
+}
+
+template<unsigned DIM>
+void ForceBudgetModifier<DIM>::SetPropulsionForce(boost::shared_ptr<SelfPropulsionForce<DIM> > pPropulsionForce)
+{
+  mpPropulsionForce = pPropulsionForce;
+}
+
+template<unsigned DIM>
+void ForceBudgetModifier<DIM>::SetShearForce(boost::shared_ptr<SinusoidalShearForce<DIM> > pShearForce)
+{
+  mpShearForce = pShearForce;
+}
+
+template<unsigned DIM>
+void ForceBudgetModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+  assert(samplingTimestepMultiple > 0);
+  mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+double ForceBudgetModifier<DIM>::GetPower(AbstractCellPopulation<DIM,DIM>& rCellPopulation, const std::vector<c_vector<double, DIM> >& rNodeForces)
+{
+  unsigned num_nodes = rCellPopulation.GetNumNodes();
+  if (rNodeForces.size() != num_nodes)
+    {
+      return 0.0;
+    }
+  double power = 0.0;
+  for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+      power += inner_prod(rNodeForces[node_index], rCellPopulation.GetNode(node_index)->rGetAppliedForce())/rCellPopulation.GetDampingConstant(node_index);
+    }
+  return power;
+}
+
+template<unsigned DIM>
+void ForceBudgetModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  if (SimulationTime::Instance()->GetTimeStepsElapsed()%mSamplingTimestepMultiple != 0)
+    {
+      return;
+    }
+
+  // The applied forces are still those used to move the nodes this
+  // time step, so F/zeta is the velocity each force term acted against
+  double dissipation = 0.0;
+  for (unsigned node_index=0; node_index<rCellPopulation.GetNumNodes(); node_index++)
+    {
+      const c_vector<double, DIM>& r_force = rCellPopulation.GetNode(node_index)->rGetAppliedForce();
+      dissipation += inner_prod(r_force, r_force)/rCellPopulation.GetDampingConstant(node_index);
+    }
+
+  double area_energy = mpNematicForce ? mpNematicForce->GetAreaEnergy() : 0.0;
+  double perimeter_energy = mpNematicForce ? mpNematicForce->GetPerimeterEnergy() : 0.0;
+  double nematic_power = mpNematicForce ? GetPower(rCellPopulation, mpNematicForce->rGetNematicNodeForces()) : 0.0;
+  double propulsion_power = mpPropulsionForce ? GetPower(rCellPopulation, mpPropulsionForce->rGetNodeForces()) : 0.0;
+  double shear_power = mpShearForce ? GetPower(rCellPopulation, mpShearForce->rGetNodeForces()) : 0.0;
+
+  double sampling_time = mSamplingTimestepMultiple*SimulationTime::Instance()->GetTimeStep();
+  mNematicWork += nematic_power*sampling_time;
+  mPropulsionWork += propulsion_power*sampling_time;
+  mShearWork += shear_power*sampling_time;
+
+  *mpBudgetFile << SimulationTime::Instance()->GetTime() << " "
+                << area_energy << " " << perimeter_energy << " "
+                << nematic_power << " " << propulsion_power << " " << shear_power << " "
+                << dissipation << " "
+                << mNematicWork << " " << mPropulsionWork << " " << mShearWork << "\n";
+}
+
+template<unsigned DIM>
+void ForceBudgetModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+  mNematicWork = 0.0;
+  mPropulsionWork = 0.0;
+  mShearWork = 0.0;
+
+  OutputFileHandler output_file_handler(outputDirectory, false);
+  mpBudgetFile = output_file_handler.OpenOutputFile("force_budget.dat");
+  *mpBudgetFile << "# time area_energy perimeter_energy nematic_power propulsion_power shear_power dissipation nematic_work propulsion_work shear_work\n";
+}
+
+template<unsigned DIM>
+void ForceBudgetModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  mpBudgetFile->close();
+}
+
+template<unsigned DIM>
+void ForceBudgetModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+  *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+
+  // Call method on direct parent class
+  AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+// template class ForceBudgetModifier<1>;
+template class ForceBudgetModifier<2>;
+// template class ForceBudgetModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS1(ForceBudgetModifier, 2)
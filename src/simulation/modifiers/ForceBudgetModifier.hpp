@@ -0,0 +1,211 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef FORCEBUDGETMODIFIER_HPP_
+#define FORCEBUDGETMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "TargetAreaAndNematicPerimeterForce.hpp"
+#include "SelfPropulsionForce.hpp"
+#include "SinusoidalShearForce.hpp"
+
+/**
+ * A modifier class that writes a time series of the mechanical energy
+ * and the power delivered by each force term, for convergence checks.
+ *
+ * The area and perimeter energies are summed by
+ * TargetAreaAndNematicPerimeterForce while it computes the forces, so
+ * no geometry is recomputed here. The nematic line tensions,
+ * propulsion and shear are not conservative, so their contribution is
+ * measured by the power sum f.v over nodes, where f is the term's
+ * force on the node (cached by each force) and v = F/zeta is the node
+ * velocity from the total applied force F and damping constant zeta.
+ * The dissipation sum F.F/zeta is computed in the same pass over the
+ * nodes. In the overdamped dynamics the rate of change of the energy
+ * is the active power minus the dissipation, so at steady state the
+ * two balance.
+ *
+ * Every mSamplingTimestepMultiple time steps a row is appended to
+ * force_budget.dat in the simulation output directory with columns
+ * time, area_energy, perimeter_energy, nematic_power,
+ * propulsion_power, shear_power, dissipation, nematic_work,
+ * propulsion_work and shear_work, where the work columns are running
+ * integrals of the powers over the samples. Terms without a force set
+ * are written as zero. If the number of nodes has changed since the
+ * forces were computed (e.g. after a T2 swap) the powers of that
+ * sample are skipped.
+ *
+ * Only the parameters are archived; the work integrals start afresh in
+ * each call to Solve().
+ */
+template<unsigned DIM>
+class ForceBudgetModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mpNematicForce;
+        archive & mpPropulsionForce;
+        archive & mpShearForce;
+        archive & mSamplingTimestepMultiple;
+    }
+
+    /** The area, perimeter and nematic force. */
+    boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > mpNematicForce;
+
+    /** The self-propulsion force. */
+    boost::shared_ptr<SelfPropulsionForce<DIM> > mpPropulsionForce;
+
+    /** The sinusoidal shear force. */
+    boost::shared_ptr<SinusoidalShearForce<DIM> > mpShearForce;
+
+    /** Number of time steps between samples. Defaults to 1. */
+    unsigned mSamplingTimestepMultiple;
+
+    /** Work done by the nematic line tensions since the start of Solve(). */
+    double mNematicWork;
+
+    /** Work done by self-propulsion since the start of Solve(). */
+    double mPropulsionWork;
+
+    /** Work done by the shear force since the start of Solve(). */
+    double mShearWork;
+
+    /** The output file, open during Solve(). */
+    out_stream mpBudgetFile;
+
+    /**
+     * @return the power f.v delivered by a force term, or zero if it
+     * has not been computed for the current nodes
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param rNodeForces the term's force on each node
+     */
+    double GetPower(AbstractCellPopulation<DIM,DIM>& rCellPopulation, const std::vector<c_vector<double, DIM> >& rNodeForces);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    ForceBudgetModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~ForceBudgetModifier();
+
+    /**
+     * Set mpNematicForce.
+     *
+     * @param pNematicForce the area, perimeter and nematic force
+     */
+    void SetNematicForce(boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > pNematicForce);
+
+    /**
+     * Set mpPropulsionForce.
+     *
+     * @param pPropulsionForce the self-propulsion force
+     */
+    void SetPropulsionForce(boost::shared_ptr<SelfPropulsionForce<DIM> > pPropulsionForce);
+
+    /**
+     * Set mpShearForce.
+     *
+     * @param pShearForce the sinusoidal shear force
+     */
+    void SetShearForce(boost::shared_ptr<SinusoidalShearForce<DIM> > pShearForce);
+
+    /**
+     * Set mSamplingTimestepMultiple.
+     *
+     * @param samplingTimestepMultiple the number of time steps between samples
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Write a row of the budget every mSamplingTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Open force_budget.dat and reset the work integrals.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Close force_budget.dat.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS1(ForceBudgetModifier, 2)
+
+#endif /*FORCEBUDGETMODIFIER_HPP_*/
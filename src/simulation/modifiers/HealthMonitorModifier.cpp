@@ -0,0 +1,312 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "HealthMonitorModifier.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+
+#include <cmath>
+
+template<unsigned DIM>
+HealthMonitorModifier<DIM>::HealthMonitorModifier()
+  : AbstractCellBasedSimulationModifier<DIM>(),
+    mCheckTimestepMultiple(1),
+    mMaxForce(1e3),
+    mMaxEnergyPerCell(1e3),
+    mLargestForce(0.0),
+    mReason(HEALTHY)
+{
+}
+
+template<unsigned DIM>
+HealthMonitorModifier<DIM>::~HealthMonitorModifier()
+{
+}
+
+template<unsigned DIM>
+std::string HealthMonitorModifier<DIM>::GetReasonName(Reason reason)
+{
+  switch (reason)
+    {
+    case HEALTHY:
+      return "HEALTHY";
+    case NON_FINITE:
+      return "NON_FINITE";
+    case EXCESSIVE_FORCE:
+      return "EXCESSIVE_FORCE";
+    case INVERTED_CELL:
+      return "INVERTED_CELL";
+    case RUNAWAY_ENERGY:
+      return "RUNAWAY_ENERGY";
+    }
+  return "UNKNOWN";
+}
+
+template<unsigned DIM>
+void HealthMonitorModifier<DIM>::SetNematicForce(boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > pNematicForce)
+{
+  mpNematicForce = pNematicForce;
+}
+
+template<unsigned DIM>
+void HealthMonitorModifier<DIM>::SetCheckTimestepMultiple(unsigned checkTimestepMultiple)
+{
+  assert(checkTimestepMultiple > 0);
+  mCheckTimestepMultiple = checkTimestepMultiple;
+}
+
+template<unsigned DIM>
+void HealthMonitorModifier<DIM>::SetMaxForce(double maxForce)
+{
+  assert(maxForce > 0.0);
+  mMaxForce = maxForce;
+}
+
+template<unsigned DIM>
+void HealthMonitorModifier<DIM>::SetMaxEnergyPerCell(double maxEnergyPerCell)
+{
+  assert(maxEnergyPerCell > 0.0);
+  mMaxEnergyPerCell = maxEnergyPerCell;
+}
+
+template<unsigned DIM>
+typename HealthMonitorModifier<DIM>::Reason HealthMonitorModifier<DIM>::GetReason()
+{
+  return mReason;
+}
+
+template<unsigned DIM>
+void HealthMonitorModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  if (SimulationTime::Instance()->GetTimeStepsElapsed()%mCheckTimestepMultiple == 0)
+    {
+      CheckHealth(rCellPopulation, true);
+    }
+}
+
+template<unsigned DIM>
+void HealthMonitorModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+  // Throw an exception message if not using a VertexBasedCellPopulation
+  if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == nullptr)
+    {
+      EXCEPTION("HealthMonitorModifier is to be used with a VertexBasedCellPopulation only");
+    }
+
+  mOutputDirectory = outputDirectory;
+  mLargestForce = 0.0;
+  mReason = HEALTHY;
+  CheckHealth(rCellPopulation, false);
+}
+
+template<unsigned DIM>
+void HealthMonitorModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  OutputFileHandler output_file_handler(mOutputDirectory, false);
+  out_stream p_file = output_file_handler.OpenOutputFile("health.dat");
+  *p_file << "status ok\n"
+          << "reason " << GetReasonName(mReason) << "\n"
+          << "reason_code " << mReason << "\n"
+          << "time " << SimulationTime::Instance()->GetTime() << "\n"
+          << "largest_force " << mLargestForce << "\n";
+  p_file->close();
+}
+
+template<unsigned DIM>
+double HealthMonitorModifier<DIM>::GetSignedArea(AbstractCellPopulation<DIM,DIM>& rCellPopulation, unsigned elemIndex)
+{
+  MutableVertexMesh<DIM,DIM>& r_mesh = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation)->rGetMesh();
+  VertexElement<DIM,DIM>* p_element = r_mesh.GetElement(elemIndex);
+
+  // Shoelace formula relative to the first node, which handles
+  // elements that cross the periodic boundaries
+  double area = 0.0;
+  const c_vector<double, DIM>& r_first_location = p_element->GetNodeLocation(0);
+  c_vector<double, DIM> previous = zero_vector<double>(DIM);
+  for (unsigned i=1; i<=p_element->GetNumNodes(); i++)
+    {
+      c_vector<double, DIM> current = r_mesh.GetVectorFromAtoB(r_first_location, p_element->GetNodeLocation(i%p_element->GetNumNodes()));
+      area += 0.5*(previous[0]*current[1] - current[0]*previous[1]);
+      previous = current;
+    }
+  return area;
+}
+
+template<unsigned DIM>
+void HealthMonitorModifier<DIM>::CheckHealth(AbstractCellPopulation<DIM,DIM>& rCellPopulation, bool checkForces)
+{
+  VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+  MutableVertexMesh<DIM,DIM>& r_mesh = p_cell_population->rGetMesh();
+
+  // Nodes: locations and forces must be finite and forces bounded
+  for (unsigned node_index=0; node_index<p_cell_population->GetNumNodes(); node_index++)
+    {
+      Node<DIM>* p_node = p_cell_population->GetNode(node_index);
+      const c_vector<double, DIM>& r_location = p_node->rGetLocation();
+      for (unsigned d=0; d<DIM; d++)
+        {
+          if (!std::isfinite(r_location[d]))
+            {
+              std::stringstream details;
+              details << "node " << node_index << "\n" << "quantity location\n";
+              Abort(rCellPopulation, NON_FINITE, details.str());
+            }
+        }
+      if (!checkForces)
+        {
+          continue;
+        }
+      const c_vector<double, DIM>& r_force = p_node->rGetAppliedForce();
+      double force_magnitude = norm_2(r_force);
+      if (!std::isfinite(force_magnitude))
+        {
+          std::stringstream details;
+          details << "node " << node_index << "\n" << "quantity force\n";
+          Abort(rCellPopulation, NON_FINITE, details.str());
+        }
+      if (force_magnitude > mLargestForce)
+        {
+          mLargestForce = force_magnitude;
+        }
+      if (force_magnitude > mMaxForce)
+        {
+          std::stringstream details;
+          details << "node " << node_index << "\n" << "force " << force_magnitude << "\n" << "max_force " << mMaxForce << "\n";
+          Abort(rCellPopulation, EXCESSIVE_FORCE, details.str());
+        }
+    }
+
+  // Cells: no inverted elements, bounded energy. Once the force has
+  // been evaluated in this time step its areas and energy are used,
+  // unless a T2 swap since has changed the elements.
+  unsigned num_cells = p_cell_population->GetNumElements();
+  bool use_force = (checkForces && mpNematicForce && mpNematicForce->rGetSignedElementAreas().size() == num_cells);
+  double energy = use_force ? mpNematicForce->GetAreaEnergy() + mpNematicForce->GetPerimeterEnergy() : 0.0;
+  for (unsigned elem_index=0; elem_index<num_cells; elem_index++)
+    {
+      double signed_area = use_force ? mpNematicForce->rGetSignedElementAreas()[elem_index] : GetSignedArea(rCellPopulation, elem_index);
+      if (!(signed_area > 0.0))
+        {
+          std::stringstream details;
+          details << "cell " << p_cell_population->GetCellUsingLocationIndex(elem_index)->GetCellId() << "\n" << "element " << elem_index << "\n" << "signed_area " << signed_area << "\n";
+          Abort(rCellPopulation, INVERTED_CELL, details.str());
+        }
+      if (mpNematicForce && !use_force)
+        {
+          double area_deviation = signed_area - p_cell_population->GetCellUsingLocationIndex(elem_index)->GetCellData()->GetItem("Target Area");
+          double perimeter_deviation = r_mesh.GetSurfaceAreaOfElement(elem_index) - mpNematicForce->GetP0();
+          energy += mpNematicForce->GetKA()*area_deviation*area_deviation + mpNematicForce->GetKP()*perimeter_deviation*perimeter_deviation;
+        }
+    }
+  if (mpNematicForce && num_cells > 0 && !(energy/num_cells <= mMaxEnergyPerCell))
+    {
+      std::stringstream details;
+      details << "energy_per_cell " << energy/num_cells << "\n" << "max_energy_per_cell " << mMaxEnergyPerCell << "\n";
+      Abort(rCellPopulation, RUNAWAY_ENERGY, details.str());
+    }
+}
+
+template<unsigned DIM>
+void HealthMonitorModifier<DIM>::Abort(AbstractCellPopulation<DIM,DIM>& rCellPopulation, Reason reason, const std::string& rDetails)
+{
+  mReason = reason;
+  double time = SimulationTime::Instance()->GetTime();
+  VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+  MutableVertexMesh<DIM,DIM>& r_mesh = p_cell_population->rGetMesh();
+
+  OutputFileHandler output_file_handler(mOutputDirectory, false);
+  out_stream p_file = output_file_handler.OpenOutputFile("health.dat");
+  *p_file << "status aborted\n"
+          << "reason " << GetReasonName(reason) << "\n"
+          << "reason_code " << reason << "\n"
+          << "time " << time << "\n"
+          << "time_step " << SimulationTime::Instance()->GetTimeStepsElapsed() << "\n"
+          << rDetails
+          << "largest_force " << mLargestForce << "\n";
+  p_file->close();
+
+  // The state at the point of failure, with the forces that led to it
+  out_stream p_snapshot = output_file_handler.OpenOutputFile("health_snapshot.dat");
+  *p_snapshot << "# time " << time << "\n"
+              << "# node x y fx fy\n";
+  for (unsigned node_index=0; node_index<p_cell_population->GetNumNodes(); node_index++)
+    {
+      Node<DIM>* p_node = p_cell_population->GetNode(node_index);
+      *p_snapshot << node_index;
+      for (unsigned d=0; d<DIM; d++)
+        {
+          *p_snapshot << " " << p_node->rGetLocation()[d];
+        }
+      for (unsigned d=0; d<DIM; d++)
+        {
+          *p_snapshot << " " << p_node->rGetAppliedForce()[d];
+        }
+      *p_snapshot << "\n";
+    }
+  *p_snapshot << "# cell element signed_area perimeter target_area\n";
+  for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+       cell_iter != rCellPopulation.End();
+       ++cell_iter)
+    {
+      unsigned elem_index = p_cell_population->GetLocationIndexUsingCell(*cell_iter);
+      *p_snapshot << cell_iter->GetCellId() << " " << elem_index << " "
+                  << GetSignedArea(rCellPopulation, elem_index) << " "
+                  << r_mesh.GetSurfaceAreaOfElement(elem_index) << " "
+                  << cell_iter->GetCellData()->GetItem("Target Area") << "\n";
+    }
+  p_snapshot->close();
+
+  EXCEPTION("Simulation aborted by HealthMonitorModifier at time " << time << ": " << GetReasonName(reason));
+}
+
+template<unsigned DIM>
+void HealthMonitorModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+  *rParamsFile << "\t\t\t<CheckTimestepMultiple>" << mCheckTimestepMultiple << "</CheckTimestepMultiple>\n";
+  *rParamsFile << "\t\t\t<MaxForce>" << mMaxForce << "</MaxForce>\n";
+  *rParamsFile << "\t\t\t<MaxEnergyPerCell>" << mMaxEnergyPerCell << "</MaxEnergyPerCell>\n";
+
+  // Call method on direct parent class
+  AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+// template class HealthMonitorModifier<1>;
+template class HealthMonitorModifier<2>;
+// template class HealthMonitorModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS1(HealthMonitorModifier, 2)
@@ -0,0 +1,251 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef HEALTHMONITORMODIFIER_HPP_
+#define HEALTHMONITORMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "TargetAreaAndNematicPerimeterForce.hpp"
+
+#include <sstream>
+
+/**
+ * A modifier class that checks a vertex model for numerical blow-up or
+ * geometric failure as the simulation runs and aborts it as soon as
+ * one is found, rather than letting it crash late or run on and
+ * produce meaningless output.
+ *
+ * Every mCheckTimestepMultiple time steps it checks, in order, for:
+ *  - NON_FINITE: a node location or applied force that is NaN or
+ *    infinite;
+ *  - EXCESSIVE_FORCE: an applied force larger than mMaxForce;
+ *  - INVERTED_CELL: a cell whose signed area (by the shoelace formula
+ *    over its nodes, which are ordered anticlockwise) is not positive;
+ *  - RUNAWAY_ENERGY: a mean energy per cell,
+ *    KA (A - A0)^2 + KP (P - P0)^2, larger than mMaxEnergyPerCell
+ *    (only if a TargetAreaAndNematicPerimeterForce has been set).
+ *
+ * If a TargetAreaAndNematicPerimeterForce has been set, the signed
+ * areas and the energy it computed at the start of the time step are
+ * checked, rather than computing them again; otherwise, and in
+ * SetupSolve() before the force has been evaluated, the signed areas
+ * are computed from the current node locations.
+ *
+ * On a failure health.dat is written to the simulation output
+ * directory with the reason code and the offending node or cell, and
+ * health_snapshot.dat with the location and force of every node and
+ * the area, perimeter and energy of every cell. An Exception naming
+ * the reason is then thrown out of Solve(). After a healthy Solve()
+ * health.dat records status "ok" and the largest force seen.
+ *
+ * Only the parameters are archived.
+ */
+template<unsigned DIM>
+class HealthMonitorModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mpNematicForce;
+        archive & mCheckTimestepMultiple;
+        archive & mMaxForce;
+        archive & mMaxEnergyPerCell;
+    }
+
+public:
+
+    /** The outcome of the health checks. */
+    enum Reason
+    {
+        HEALTHY = 0,
+        NON_FINITE = 1,
+        EXCESSIVE_FORCE = 2,
+        INVERTED_CELL = 3,
+        RUNAWAY_ENERGY = 4
+    };
+
+private:
+
+    /** The force providing the mechanical parameters, if any. */
+    boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > mpNematicForce;
+
+    /** Number of time steps between checks. Defaults to 1. */
+    unsigned mCheckTimestepMultiple;
+
+    /** Largest magnitude of applied force allowed on a node. Defaults to 1e3. */
+    double mMaxForce;
+
+    /** Largest mean energy per cell allowed. Defaults to 1e3. */
+    double mMaxEnergyPerCell;
+
+    /** Largest force magnitude seen in this Solve(). */
+    double mLargestForce;
+
+    /** The outcome of the checks in this Solve(). */
+    Reason mReason;
+
+    /** The output directory of the simulation. */
+    std::string mOutputDirectory;
+
+    /**
+     * Run the health checks.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param checkForces whether the applied forces are current and should be checked
+     */
+    void CheckHealth(AbstractCellPopulation<DIM,DIM>& rCellPopulation, bool checkForces);
+
+    /**
+     * @param rCellPopulation reference to the cell population
+     * @param elemIndex the index of an element
+     * @return the signed area of the element
+     */
+    double GetSignedArea(AbstractCellPopulation<DIM,DIM>& rCellPopulation, unsigned elemIndex);
+
+    /**
+     * Write health.dat and health_snapshot.dat and throw an exception.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param reason the failed check
+     * @param rDetails "key value" lines describing the failure
+     */
+    void Abort(AbstractCellPopulation<DIM,DIM>& rCellPopulation, Reason reason, const std::string& rDetails);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    HealthMonitorModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~HealthMonitorModifier();
+
+    /**
+     * @param reason a reason code
+     * @return its name, e.g. "INVERTED_CELL"
+     */
+    static std::string GetReasonName(Reason reason);
+
+    /**
+     * Set mpNematicForce, enabling the energy check.
+     *
+     * @param pNematicForce the force providing the mechanical parameters
+     */
+    void SetNematicForce(boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > pNematicForce);
+
+    /**
+     * Set mCheckTimestepMultiple.
+     *
+     * @param checkTimestepMultiple the number of time steps between checks
+     */
+    void SetCheckTimestepMultiple(unsigned checkTimestepMultiple);
+
+    /**
+     * Set mMaxForce.
+     *
+     * @param maxForce the largest magnitude of applied force allowed on a node
+     */
+    void SetMaxForce(double maxForce);
+
+    /**
+     * Set mMaxEnergyPerCell.
+     *
+     * @param maxEnergyPerCell the largest mean energy per cell allowed
+     */
+    void SetMaxEnergyPerCell(double maxEnergyPerCell);
+
+    /**
+     * @return the outcome of the checks in the current or last Solve()
+     */
+    Reason GetReason();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Check every mCheckTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Reset the outcome. Forces have not been applied yet, so only the
+     * geometry is checked.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Record a healthy run.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS1(HealthMonitorModifier, 2)
+
+#endif /*HEALTHMONITORMODIFIER_HPP_*/
@@ -0,0 +1,245 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "ShearRheometerModifier.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+
+#include <cmath>
+
+template<unsigned DIM>
+ShearRheometerModifier<DIM>::ShearRheometerModifier()
+  : AbstractCellBasedSimulationModifier<DIM>(),
+    mSamplingTimestepMultiple(1),
+    mBatchLength(100),
+    mMinNumBatches(10),
+    mTolerance(0.01),
+    mStopOnConvergence(false),
+    mAmplitudes(100),
+    mMeanDamping(0.0),
+    mNumSamples(0),
+    mHeight(0.0),
+    mConvergenceTime(-1.0)
+{
+}
+
+template<unsigned DIM>
+ShearRheometerModifier<DIM>::~ShearRheometerModifier()
+{
+}
+
+template<unsigned DIM>
+void ShearRheometerModifier<DIM>::SetShearForce(boost::shared_ptr<SinusoidalShearForce<DIM> > pShearForce)
+{
+  mpShearForce = pShearForce;
+}
+
+template<unsigned DIM>
+void ShearRheometerModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+  assert(samplingTimestepMultiple > 0);
+  mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void ShearRheometerModifier<DIM>::SetBatches(unsigned batchLength, unsigned minNumBatches)
+{
+  assert(batchLength > 0 && minNumBatches > 1);
+  mBatchLength = batchLength;
+  mMinNumBatches = minNumBatches;
+}
+
+template<unsigned DIM>
+void ShearRheometerModifier<DIM>::SetTolerance(double tolerance, bool stopOnConvergence)
+{
+  assert(tolerance > 0.0);
+  mTolerance = tolerance;
+  mStopOnConvergence = stopOnConvergence;
+}
+
+template<unsigned DIM>
+bool ShearRheometerModifier<DIM>::GetStopOnConvergence() const
+{
+  return mStopOnConvergence;
+}
+
+template<unsigned DIM>
+double ShearRheometerModifier<DIM>::GetAmplitude()
+{
+  return mAmplitudes.GetMean();
+}
+
+template<unsigned DIM>
+double ShearRheometerModifier<DIM>::GetAmplitudeError()
+{
+  return mAmplitudes.GetStandardError();
+}
+
+template<unsigned DIM>
+double ShearRheometerModifier<DIM>::GetEffectiveViscosity()
+{
+  double amplitude = mAmplitudes.GetMean();
+  if (amplitude == 0.0 || mHeight == 0.0)
+    {
+      return 0.0;
+    }
+  double wavenumber = 2.0*M_PI/mHeight;
+  return (mpShearForce->GetF1()/amplitude - mMeanDamping)/(wavenumber*wavenumber);
+}
+
+template<unsigned DIM>
+bool ShearRheometerModifier<DIM>::HasConverged()
+{
+  return mConvergenceTime >= 0.0;
+}
+
+template<unsigned DIM>
+void ShearRheometerModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  if (SimulationTime::Instance()->GetTimeStepsElapsed()%mSamplingTimestepMultiple == 0)
+    {
+      RecordSample(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void ShearRheometerModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+  if (!mpShearForce)
+    {
+      EXCEPTION("ShearRheometerModifier needs a SinusoidalShearForce, set using SetShearForce()");
+    }
+
+  mOutputDirectory = outputDirectory;
+  mHeight = rCellPopulation.GetWidth(1);
+  mAmplitudes = BatchMeans(mBatchLength);
+  mMeanDamping = 0.0;
+  mNumSamples = 0;
+  mConvergenceTime = -1.0;
+}
+
+template<unsigned DIM>
+void ShearRheometerModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  WriteResults();
+}
+
+template<unsigned DIM>
+void ShearRheometerModifier<DIM>::RecordSample(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  // Least squares projection of the x-velocity onto sin(2*pi*y/H)
+  double velocity_mode_sum = 0.0;
+  double mode_squared_sum = 0.0;
+  double damping_sum = 0.0;
+  unsigned num_nodes = rCellPopulation.GetNumNodes();
+  for (unsigned node_index=0; node_index<num_nodes; node_index++)
+    {
+      Node<DIM>* p_node = rCellPopulation.GetNode(node_index);
+      double damping = rCellPopulation.GetDampingConstant(node_index);
+      double mode = sin(2.0*M_PI*p_node->rGetLocation()[1]/mHeight);
+      velocity_mode_sum += mode*p_node->rGetAppliedForce()[0]/damping;
+      mode_squared_sum += mode*mode;
+      damping_sum += damping;
+    }
+  if (mode_squared_sum == 0.0)
+    {
+      return;
+    }
+
+  mNumSamples++;
+  mMeanDamping += (damping_sum/num_nodes - mMeanDamping)/mNumSamples;
+  mAmplitudes.Add(velocity_mode_sum/mode_squared_sum);
+
+  if (mConvergenceTime < 0.0
+      && mAmplitudes.GetNumBatches() >= mMinNumBatches
+      && mAmplitudes.GetStandardError() <= mTolerance*fabs(mAmplitudes.GetMean()))
+    {
+      mConvergenceTime = SimulationTime::Instance()->GetTime();
+    }
+}
+
+template<unsigned DIM>
+void ShearRheometerModifier<DIM>::WriteResults()
+{
+  OutputFileHandler output_file_handler(mOutputDirectory, false);
+  out_stream p_file = output_file_handler.OpenOutputFile("shear_rheometer.dat");
+  *p_file << "# Steady response to SinusoidalShearForce (see ShearRheometerModifier)\n"
+          << "f1 " << mpShearForce->GetF1() << "\n"
+          << "height " << mHeight << "\n"
+          << "mean_damping " << mMeanDamping << "\n"
+          << "num_samples " << mNumSamples << "\n"
+          << "batch_length " << mBatchLength << "\n"
+          << "num_batches " << mAmplitudes.GetNumBatches() << "\n"
+          << "amplitude " << GetAmplitude() << "\n"
+          << "amplitude_error " << GetAmplitudeError() << "\n";
+
+  double amplitude = GetAmplitude();
+  double wavenumber = 2.0*M_PI/mHeight;
+  double viscosity_error = (amplitude == 0.0) ? 0.0 :
+    mpShearForce->GetF1()*GetAmplitudeError()/(amplitude*amplitude*wavenumber*wavenumber);
+  *p_file << "effective_viscosity " << GetEffectiveViscosity() << "\n"
+          << "effective_viscosity_error " << viscosity_error << "\n"
+          << "converged " << HasConverged() << "\n"
+          << "convergence_time " << mConvergenceTime << "\n"
+          << "batch_means";
+  const std::vector<double>& r_batch_means = mAmplitudes.rGetBatchMeans();
+  for (unsigned i=0; i<r_batch_means.size(); i++)
+    {
+      *p_file << " " << r_batch_means[i];
+    }
+  *p_file << "\n";
+  p_file->close();
+}
+
+template<unsigned DIM>
+void ShearRheometerModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+  *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+  *rParamsFile << "\t\t\t<BatchLength>" << mBatchLength << "</BatchLength>\n";
+  *rParamsFile << "\t\t\t<MinNumBatches>" << mMinNumBatches << "</MinNumBatches>\n";
+  *rParamsFile << "\t\t\t<Tolerance>" << mTolerance << "</Tolerance>\n";
+  *rParamsFile << "\t\t\t<StopOnConvergence>" << mStopOnConvergence << "</StopOnConvergence>\n";
+
+  // Call method on direct parent class
+  AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+// template class ShearRheometerModifier<1>;
+template class ShearRheometerModifier<2>;
+// template class ShearRheometerModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ShearRheometerModifier)
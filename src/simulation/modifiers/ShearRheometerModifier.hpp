@@ -0,0 +1,254 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef SHEARRHEOMETERMODIFIER_HPP_
+#define SHEARRHEOMETERMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "BatchMeans.hpp"
+#include "SinusoidalShearForce.hpp"
+
+/**
+ * A modifier class that measures the effective viscosity of the tissue
+ * from its steady response to a SinusoidalShearForce, and can stop the
+ * simulation once the measurement has converged.
+ *
+ * Every mSamplingTimestepMultiple time steps the x-velocity of each
+ * node, its applied force divided by its damping constant, is
+ * projected onto the forcing mode sin(2*pi*y/H) by least squares to
+ * give the amplitude a of the velocity profile. The amplitudes are
+ * averaged in batches of mBatchLength samples, with an error bar from
+ * the scatter of the batch means. Balancing the forcing against
+ * friction with damping constant zeta and a viscous stress with
+ * viscosity eta gives a = F1/(zeta + eta*k^2) with k = 2*pi/H, so the
+ * effective viscosity is eta = (F1/a - zeta)/k^2.
+ *
+ * The measurement has converged when there are at least mMinNumBatches
+ * batches and the standard error of the amplitude is at most
+ * mTolerance times its magnitude. If mStopOnConvergence is set, a
+ * simulation whose StoppingEventHasOccurred() checks
+ * GetStopOnConvergence() and HasConverged() can then finish Solve()
+ * (so that other modifiers write their output) at the end of this
+ * time step. At the end of Solve() the results are written
+ * to shear_rheometer.dat in the simulation output directory.
+ *
+ * Only the parameters are archived; the statistics are accumulated
+ * afresh in each call to Solve().
+ */
+template<unsigned DIM>
+class ShearRheometerModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mpShearForce;
+        archive & mSamplingTimestepMultiple;
+        archive & mBatchLength;
+        archive & mMinNumBatches;
+        archive & mTolerance;
+        archive & mStopOnConvergence;
+    }
+
+    /** The shear force whose response is measured. */
+    boost::shared_ptr<SinusoidalShearForce<DIM> > mpShearForce;
+
+    /** Number of time steps between samples. Defaults to 1. */
+    unsigned mSamplingTimestepMultiple;
+
+    /** Number of samples in each batch. Defaults to 100. */
+    unsigned mBatchLength;
+
+    /** Minimum number of batches before the measurement can converge. Defaults to 10. */
+    unsigned mMinNumBatches;
+
+    /** Relative standard error of the amplitude at convergence. Defaults to 0.01. */
+    double mTolerance;
+
+    /** Whether to stop the simulation on convergence. Defaults to false. */
+    bool mStopOnConvergence;
+
+    /** Batch means of the velocity profile amplitude. */
+    BatchMeans mAmplitudes;
+
+    /** Running mean of the node damping constant. */
+    double mMeanDamping;
+
+    /** The number of samples taken. */
+    unsigned mNumSamples;
+
+    /** Height of the domain, the period of the forcing. */
+    double mHeight;
+
+    /** Time at which the measurement converged, or a negative value if it has not. */
+    double mConvergenceTime;
+
+    /** The output directory of the simulation. */
+    std::string mOutputDirectory;
+
+    /**
+     * Project the current node velocities onto the forcing mode and
+     * check for convergence.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void RecordSample(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Write the measurement to file.
+     */
+    void WriteResults();
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    ShearRheometerModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~ShearRheometerModifier();
+
+    /**
+     * Set mpShearForce.
+     *
+     * @param pShearForce the shear force driving the flow
+     */
+    void SetShearForce(boost::shared_ptr<SinusoidalShearForce<DIM> > pShearForce);
+
+    /**
+     * Set mSamplingTimestepMultiple.
+     *
+     * @param samplingTimestepMultiple the number of time steps between samples
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * Set mBatchLength and mMinNumBatches.
+     *
+     * @param batchLength the number of samples in each batch
+     * @param minNumBatches the minimum number of batches before the measurement can converge (at least 2)
+     */
+    void SetBatches(unsigned batchLength, unsigned minNumBatches);
+
+    /**
+     * Set mTolerance and mStopOnConvergence.
+     *
+     * @param tolerance the relative standard error of the amplitude at convergence
+     * @param stopOnConvergence whether to stop the simulation on convergence
+     */
+    void SetTolerance(double tolerance, bool stopOnConvergence=true);
+
+    /**
+     * @return mStopOnConvergence
+     */
+    bool GetStopOnConvergence() const;
+
+    /**
+     * @return the mean amplitude of the velocity profile so far in this Solve()
+     */
+    double GetAmplitude();
+
+    /**
+     * @return the standard error of GetAmplitude()
+     */
+    double GetAmplitudeError();
+
+    /**
+     * @return the effective viscosity estimated from GetAmplitude()
+     */
+    double GetEffectiveViscosity();
+
+    /**
+     * @return whether the measurement has converged in this Solve()
+     */
+    bool HasConverged();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Sample every mSamplingTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Reset the statistics. No sample is taken as forces have not yet
+     * been applied.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Write the measurement to file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(ShearRheometerModifier)
+
+#endif /*SHEARRHEOMETERMODIFIER_HPP_*/
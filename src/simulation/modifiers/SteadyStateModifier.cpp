@@ -0,0 +1,342 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SteadyStateModifier.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+/** Names of the observables in steady_state.dat. */
+static const char* OBSERVABLE_NAMES[] = {"energy", "mean_abs_erk", "area_variance", "polar_order", "nematic_order"};
+
+template<unsigned DIM>
+SteadyStateModifier<DIM>::SteadyStateModifier()
+  : AbstractCellBasedSimulationModifier<DIM>(),
+    mSamplingTimestepMultiple(1),
+    mWindowLength(100),
+    mNumWindows(4),
+    mTolerance(0.05),
+    mMinTime(0.0),
+    mStopOnSteadyState(true),
+    mStartTime(0.0),
+    mNumInWindow(0),
+    mSteadyStateTime(-1.0)
+{
+}
+
+template<unsigned DIM>
+SteadyStateModifier<DIM>::~SteadyStateModifier()
+{
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::SetNematicForce(boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > pNematicForce)
+{
+  mpNematicForce = pNematicForce;
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+  assert(samplingTimestepMultiple > 0);
+  mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::SetWindows(unsigned windowLength, unsigned numWindows)
+{
+  assert(windowLength > 0 && numWindows > 1);
+  mWindowLength = windowLength;
+  mNumWindows = numWindows;
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::SetTolerance(double tolerance)
+{
+  assert(tolerance > 0.0);
+  mTolerance = tolerance;
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::SetMinTime(double minTime)
+{
+  mMinTime = minTime;
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::SetStopOnSteadyState(bool stopOnSteadyState)
+{
+  mStopOnSteadyState = stopOnSteadyState;
+}
+
+template<unsigned DIM>
+bool SteadyStateModifier<DIM>::GetStopOnSteadyState() const
+{
+  return mStopOnSteadyState;
+}
+
+template<unsigned DIM>
+bool SteadyStateModifier<DIM>::HasReachedSteadyState()
+{
+  return mSteadyStateTime >= 0.0;
+}
+
+template<unsigned DIM>
+double SteadyStateModifier<DIM>::GetSteadyStateTime()
+{
+  return mSteadyStateTime;
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  if (SimulationTime::Instance()->GetTimeStepsElapsed()%mSamplingTimestepMultiple == 0)
+    {
+      RecordSample(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+  // Throw an exception message if not using a VertexBasedCellPopulation
+  if (dynamic_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation) == nullptr)
+    {
+      EXCEPTION("SteadyStateModifier is to be used with a VertexBasedCellPopulation only");
+    }
+  if (!mpNematicForce)
+    {
+      EXCEPTION("SteadyStateModifier needs a TargetAreaAndNematicPerimeterForce, set using SetNematicForce()");
+    }
+
+  mOutputDirectory = outputDirectory;
+  mStartTime = SimulationTime::Instance()->GetTime();
+  mWindowSums.assign(NUM_OBSERVABLES, 0.0);
+  mWindowSumSquares.assign(NUM_OBSERVABLES, 0.0);
+  mNumInWindow = 0;
+  mWindowMeans.assign(NUM_OBSERVABLES, std::vector<double>());
+  mWindowVariances.assign(NUM_OBSERVABLES, std::vector<double>());
+  mSteadyStateTime = -1.0;
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  WriteResults();
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::RecordSample(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+  if (mSteadyStateTime >= 0.0)
+    {
+      return;
+    }
+
+  VertexBasedCellPopulation<DIM>* p_cell_population = static_cast<VertexBasedCellPopulation<DIM>*>(&rCellPopulation);
+  MutableVertexMesh<DIM,DIM>& r_mesh = p_cell_population->rGetMesh();
+  // The element shapes at the start of the time step (computed
+  // without random draws if the force did not need them)
+  mpNematicForce->UpdateElementShapesForOutput(*p_cell_population);
+  const std::vector<double>& r_orientations = mpNematicForce->rGetOrientations();
+  double KA = mpNematicForce->GetKA();
+  double KP = mpNematicForce->GetKP();
+  double P0 = mpNematicForce->GetP0();
+
+  // The force has already computed each element's area and the
+  // energy in this time step, so reuse them unless a T2 swap since
+  // has changed the elements
+  const std::vector<double>& r_signed_areas = mpNematicForce->rGetSignedElementAreas();
+  bool use_force = (r_signed_areas.size() == p_cell_population->GetNumElements());
+
+  double energy = use_force ? mpNematicForce->GetAreaEnergy() + mpNematicForce->GetPerimeterEnergy() : 0.0;
+  double abs_erk_sum = 0.0;
+  double area_sum = 0.0;
+  double area_squared_sum = 0.0;
+  double polar_sum[2] = {0.0, 0.0};
+  double nematic_sum[2] = {0.0, 0.0};
+  unsigned num_cells = 0;
+  for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+       cell_iter != rCellPopulation.End();
+       ++cell_iter)
+    {
+      unsigned elem_index = p_cell_population->GetLocationIndexUsingCell(*cell_iter);
+      double area;
+      if (use_force)
+        {
+          area = r_signed_areas[elem_index];
+        }
+      else
+        {
+          area = r_mesh.GetVolumeOfElement(elem_index);
+          double perimeter = r_mesh.GetSurfaceAreaOfElement(elem_index);
+          double target_area = cell_iter->GetCellData()->GetItem("Target Area");
+          energy += KA*(area - target_area)*(area - target_area) + KP*(perimeter - P0)*(perimeter - P0);
+        }
+      abs_erk_sum += fabs(cell_iter->GetCellData()->GetItem("Erk"));
+      area_sum += area;
+      area_squared_sum += area*area;
+      double propulsion_angle = cell_iter->GetCellData()->GetItem("Theta");
+      polar_sum[0] += cos(propulsion_angle);
+      polar_sum[1] += sin(propulsion_angle);
+      nematic_sum[0] += cos(2.0*r_orientations[elem_index]);
+      nematic_sum[1] += sin(2.0*r_orientations[elem_index]);
+      num_cells++;
+    }
+  if (num_cells == 0)
+    {
+      return;
+    }
+
+  double mean_area = area_sum/num_cells;
+  double observables[NUM_OBSERVABLES];
+  observables[0] = energy;
+  observables[1] = abs_erk_sum/num_cells;
+  observables[2] = area_squared_sum/num_cells - mean_area*mean_area;
+  observables[3] = sqrt(polar_sum[0]*polar_sum[0] + polar_sum[1]*polar_sum[1])/num_cells;
+  observables[4] = sqrt(nematic_sum[0]*nematic_sum[0] + nematic_sum[1]*nematic_sum[1])/num_cells;
+
+  for (unsigned i=0; i<NUM_OBSERVABLES; i++)
+    {
+      mWindowSums[i] += observables[i];
+      mWindowSumSquares[i] += observables[i]*observables[i];
+    }
+  mNumInWindow++;
+  if (mNumInWindow < mWindowLength)
+    {
+      return;
+    }
+
+  // Close the window
+  for (unsigned i=0; i<NUM_OBSERVABLES; i++)
+    {
+      double mean = mWindowSums[i]/mWindowLength;
+      mWindowMeans[i].push_back(mean);
+      mWindowVariances[i].push_back(std::max(0.0, mWindowSumSquares[i]/mWindowLength - mean*mean));
+    }
+  mWindowSums.assign(NUM_OBSERVABLES, 0.0);
+  mWindowSumSquares.assign(NUM_OBSERVABLES, 0.0);
+  mNumInWindow = 0;
+
+  double time = SimulationTime::Instance()->GetTime();
+  if (time - mStartTime < mMinTime || mWindowMeans[0].size() < mNumWindows)
+    {
+      return;
+    }
+  for (unsigned i=0; i<NUM_OBSERVABLES; i++)
+    {
+      if (!IsSteady(i))
+        {
+          return;
+        }
+    }
+
+  mSteadyStateTime = time;
+}
+
+template<unsigned DIM>
+bool SteadyStateModifier<DIM>::IsSteady(unsigned observable)
+{
+  const std::vector<double>& r_means = mWindowMeans[observable];
+  const std::vector<double>& r_variances = mWindowVariances[observable];
+  unsigned first = r_means.size() - mNumWindows;
+
+  // Least-squares slope of the window means against window number
+  double mean_index = 0.5*(mNumWindows - 1);
+  double mean = 0.0;
+  double variance = 0.0;
+  for (unsigned k=0; k<mNumWindows; k++)
+    {
+      mean += r_means[first + k]/mNumWindows;
+      variance += r_variances[first + k]/mNumWindows;
+    }
+  double covariance = 0.0;
+  double index_variance = 0.0;
+  for (unsigned k=0; k<mNumWindows; k++)
+    {
+      covariance += (k - mean_index)*(r_means[first + k] - mean);
+      index_variance += (k - mean_index)*(k - mean_index);
+    }
+  double drift = fabs(covariance/index_variance)*(mNumWindows - 1);
+  double scale = std::max(fabs(mean), sqrt(variance));
+  return drift <= mTolerance*scale;
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::WriteResults()
+{
+  OutputFileHandler output_file_handler(mOutputDirectory, false);
+  out_stream p_file = output_file_handler.OpenOutputFile("steady_state.dat");
+  *p_file << "# Burn-in convergence (see SteadyStateModifier)\n"
+          << "start_time " << mStartTime << "\n"
+          << "window_time " << mWindowLength*mSamplingTimestepMultiple*SimulationTime::Instance()->GetTimeStep() << "\n"
+          << "tolerance " << mTolerance << "\n"
+          << "steady_state_time " << mSteadyStateTime << "\n";
+  for (unsigned i=0; i<NUM_OBSERVABLES; i++)
+    {
+      *p_file << OBSERVABLE_NAMES[i] << "_window_means";
+      for (unsigned k=0; k<mWindowMeans[i].size(); k++)
+        {
+          *p_file << " " << mWindowMeans[i][k];
+        }
+      *p_file << "\n";
+    }
+  p_file->close();
+}
+
+template<unsigned DIM>
+void SteadyStateModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+  *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+  *rParamsFile << "\t\t\t<WindowLength>" << mWindowLength << "</WindowLength>\n";
+  *rParamsFile << "\t\t\t<NumWindows>" << mNumWindows << "</NumWindows>\n";
+  *rParamsFile << "\t\t\t<Tolerance>" << mTolerance << "</Tolerance>\n";
+  *rParamsFile << "\t\t\t<MinTime>" << mMinTime << "</MinTime>\n";
+  *rParamsFile << "\t\t\t<StopOnSteadyState>" << mStopOnSteadyState << "</StopOnSteadyState>\n";
+
+  // Call method on direct parent class
+  AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+// template class SteadyStateModifier<1>;
+template class SteadyStateModifier<2>;
+// template class SteadyStateModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS1(SteadyStateModifier, 2)
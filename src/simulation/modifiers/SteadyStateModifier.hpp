@@ -0,0 +1,288 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef STEADYSTATEMODIFIER_HPP_
+#define STEADYSTATEMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "TargetAreaAndNematicPerimeterForce.hpp"
+
+#include <vector>
+
+/**
+ * A modifier class that detects when a simulation has reached a
+ * statistically steady state, so that a burn-in period can end as soon
+ * as the initial transient has died away.
+ *
+ * Every mSamplingTimestepMultiple time steps five whole-tissue
+ * observables are computed:
+ *  - the mechanical energy sum_cells KA (A - A0)^2 + KP (P - P0)^2;
+ *  - the mean of |ERK|;
+ *  - the variance of cell areas;
+ *  - the polar order |<(cos theta_p, sin theta_p)>| of the
+ *    self-propulsion angles;
+ *  - the nematic order |<(cos 2 theta, sin 2 theta)>| of the cell
+ *    shape axes.
+ * The energy, areas and shape axes are those the force computed at
+ * the start of the time step (see
+ * TargetAreaAndNematicPerimeterForce::UpdateElementShapesForOutput()),
+ * so no extra pass over the geometry is needed. If a T2 swap has since
+ * changed the number of elements the energy and areas are recomputed
+ * from the mesh at the end of the step.
+ * Samples are averaged over consecutive windows of mWindowLength
+ * samples. An observable is steady when the least-squares trend of its
+ * last mNumWindows window means, extrapolated across those windows, is
+ * at most mTolerance times the larger of the magnitude of their mean
+ * and the standard deviation of the samples within a window.
+ *
+ * Once every observable is steady, and at least mMinTime has passed
+ * since the start of Solve(), the steady state time is recorded. If
+ * mStopOnSteadyState is set, a simulation whose
+ * StoppingEventHasOccurred() checks GetStopOnSteadyState() and
+ * HasReachedSteadyState() can then finish Solve() at the end of this
+ * time step; the end time set on the simulation is therefore the
+ * longest burn-in allowed. At the end of Solve() the window means and
+ * the steady state time are written to steady_state.dat in the
+ * simulation output directory.
+ *
+ * Only the parameters are archived; the statistics are accumulated
+ * afresh in each call to Solve().
+ */
+template<unsigned DIM>
+class SteadyStateModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mpNematicForce;
+        archive & mSamplingTimestepMultiple;
+        archive & mWindowLength;
+        archive & mNumWindows;
+        archive & mTolerance;
+        archive & mMinTime;
+        archive & mStopOnSteadyState;
+    }
+
+    /** The force providing the mechanical parameters and element shapes. */
+    boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > mpNematicForce;
+
+    /** Number of time steps between samples. Defaults to 1. */
+    unsigned mSamplingTimestepMultiple;
+
+    /** Number of samples in each window. Defaults to 100. */
+    unsigned mWindowLength;
+
+    /** Number of recent windows whose trend is tested. Defaults to 4. */
+    unsigned mNumWindows;
+
+    /** Largest trend, relative to the scale of an observable, counted as steady. Defaults to 0.05. */
+    double mTolerance;
+
+    /** Shortest time after the start of Solve() at which a steady state can be declared. Defaults to 0. */
+    double mMinTime;
+
+    /** Whether to stop the simulation when the steady state is reached. Defaults to true. */
+    bool mStopOnSteadyState;
+
+    /** Simulation time at the start of Solve(). */
+    double mStartTime;
+
+    /** Sum of each observable over the current window. */
+    std::vector<double> mWindowSums;
+
+    /** Sum of the square of each observable over the current window. */
+    std::vector<double> mWindowSumSquares;
+
+    /** The number of samples in the current window. */
+    unsigned mNumInWindow;
+
+    /** The mean of each observable in each complete window, indexed [observable][window]. */
+    std::vector<std::vector<double> > mWindowMeans;
+
+    /** The variance of each observable in each complete window, indexed [observable][window]. */
+    std::vector<std::vector<double> > mWindowVariances;
+
+    /** Time at which the steady state was reached, or a negative value if it has not. */
+    double mSteadyStateTime;
+
+    /** The output directory of the simulation. */
+    std::string mOutputDirectory;
+
+    /**
+     * Compute the observables and, at the end of a window, test them
+     * for a steady state.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void RecordSample(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * @param observable an observable index
+     * @return whether the last mNumWindows window means of the observable are steady
+     */
+    bool IsSteady(unsigned observable);
+
+    /**
+     * Write the window means to file.
+     */
+    void WriteResults();
+
+public:
+
+    /** The number of observables. */
+    static const unsigned NUM_OBSERVABLES = 5;
+
+    /**
+     * Default constructor.
+     */
+    SteadyStateModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~SteadyStateModifier();
+
+    /**
+     * Set mpNematicForce.
+     *
+     * @param pNematicForce the force providing the mechanical parameters and element shapes
+     */
+    void SetNematicForce(boost::shared_ptr<TargetAreaAndNematicPerimeterForce<DIM> > pNematicForce);
+
+    /**
+     * Set mSamplingTimestepMultiple.
+     *
+     * @param samplingTimestepMultiple the number of time steps between samples
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * Set the windows used to test for a steady state.
+     *
+     * @param windowLength the number of samples in each window
+     * @param numWindows the number of recent windows whose trend is tested (at least 2)
+     */
+    void SetWindows(unsigned windowLength, unsigned numWindows);
+
+    /**
+     * Set mTolerance.
+     *
+     * @param tolerance the largest trend, relative to the scale of an observable, counted as steady
+     */
+    void SetTolerance(double tolerance);
+
+    /**
+     * Set mMinTime.
+     *
+     * @param minTime the shortest time after the start of Solve() at which a steady state can be declared
+     */
+    void SetMinTime(double minTime);
+
+    /**
+     * Set mStopOnSteadyState.
+     *
+     * @param stopOnSteadyState whether to stop the simulation when the steady state is reached
+     */
+    void SetStopOnSteadyState(bool stopOnSteadyState);
+
+    /**
+     * @return mStopOnSteadyState
+     */
+    bool GetStopOnSteadyState() const;
+
+    /**
+     * @return whether a steady state has been reached in this Solve()
+     */
+    bool HasReachedSteadyState();
+
+    /**
+     * @return the time at which the steady state was reached, or a negative value if it has not
+     */
+    double GetSteadyStateTime();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Sample every mSamplingTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Reset the statistics.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Write the window means to file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS1(SteadyStateModifier, 2)
+
+#endif /*STEADYSTATEMODIFIER_HPP_*/
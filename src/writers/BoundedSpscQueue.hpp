@@ -0,0 +1,139 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef BOUNDEDSPSCQUEUE_HPP_
+#define BOUNDEDSPSCQUEUE_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+/**
+ * A bounded, lock-free queue for exactly one producer thread and one
+ * consumer thread, implemented as a ring buffer. Used to pass output
+ * buffers between the simulation and a background I/O thread.
+ *
+ * TryPush() and TryPop() never block; callers decide how to wait
+ * when the queue is full or empty.
+ */
+template<typename T>
+class BoundedSpscQueue
+{
+private:
+
+    /** Storage for the ring buffer (one slot more than the capacity). */
+    std::vector<T> mSlots;
+
+    /** Index of the next slot to pop. Only written by the consumer. */
+    std::atomic<std::size_t> mHead;
+
+    /** Index of the next slot to push. Only written by the producer. */
+    std::atomic<std::size_t> mTail;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param capacity the maximum number of items held at once
+     */
+    explicit BoundedSpscQueue(std::size_t capacity=1)
+        : mSlots(capacity+1),
+          mHead(0),
+          mTail(0)
+    {
+    }
+
+    /**
+     * Empty the queue and change its capacity. Not thread safe; only
+     * call when neither thread is using the queue.
+     *
+     * @param capacity the maximum number of items held at once
+     */
+    void Reset(std::size_t capacity)
+    {
+        mSlots.assign(capacity+1, T());
+        mHead.store(0);
+        mTail.store(0);
+    }
+
+    /**
+     * Push an item onto the queue. Producer thread only.
+     *
+     * @param rItem the item
+     * @return false if the queue is full
+     */
+    bool TryPush(const T& rItem)
+    {
+        std::size_t tail = mTail.load(std::memory_order_relaxed);
+        std::size_t next = (tail + 1)%mSlots.size();
+        if (next == mHead.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        mSlots[tail] = rItem;
+        mTail.store(next, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Pop an item from the queue. Consumer thread only.
+     *
+     * @param rItem filled in with the item
+     * @return false if the queue is empty
+     */
+    bool TryPop(T& rItem)
+    {
+        std::size_t head = mHead.load(std::memory_order_relaxed);
+        if (head == mTail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        rItem = mSlots[head];
+        mHead.store((head + 1)%mSlots.size(), std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @return whether the queue is currently empty
+     */
+    bool IsEmpty() const
+    {
+        return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire);
+    }
+};
+
+#endif /*BOUNDEDSPSCQUEUE_HPP_*/
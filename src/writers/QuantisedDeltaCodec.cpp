@@ -0,0 +1,351 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "QuantisedDeltaCodec.hpp"
+#include "Exception.hpp"
+
+#include <cmath>
+#include <cstring>
+
+/** Values further than this (in units of 2e) from zero are rejected to avoid losing integer precision. */
+static const double MAX_QUANTISED_MAGNITUDE = 4503599627370496.0;    // 2^52
+
+/** Largest Rice parameter considered. */
+static const unsigned MAX_RICE_PARAMETER = 56;
+
+/**
+ * Writes bits into a byte buffer, most significant bit first.
+ */
+class BitPacker
+{
+private:
+    /** The buffer. */
+    std::vector<char>& mrBuffer;
+
+    /** The byte being filled. */
+    unsigned mCurrentByte;
+
+    /** The number of bits in mCurrentByte. */
+    unsigned mNumBits;
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param rBuffer the buffer to append to
+     */
+    explicit BitPacker(std::vector<char>& rBuffer)
+        : mrBuffer(rBuffer),
+          mCurrentByte(0),
+          mNumBits(0)
+    {
+    }
+
+    /**
+     * Append the low numBits bits of value.
+     *
+     * @param value the bits
+     * @param numBits the number of bits (at most 64)
+     */
+    void Write(uint64_t value, unsigned numBits)
+    {
+        for (unsigned i=numBits; i>0; i--)
+        {
+            mCurrentByte = (mCurrentByte << 1) | ((value >> (i-1)) & 1u);
+            if (++mNumBits == 8)
+            {
+                mrBuffer.push_back(static_cast<char>(mCurrentByte));
+                mCurrentByte = 0;
+                mNumBits = 0;
+            }
+        }
+    }
+
+    /**
+     * Append a run of identical bits.
+     *
+     * @param bit the bit value
+     * @param count the number of bits
+     */
+    void WriteRun(unsigned bit, unsigned count)
+    {
+        for (unsigned i=0; i<count; i++)
+        {
+            Write(bit, 1);
+        }
+    }
+
+    /**
+     * Write out any partial byte, padded with zero bits.
+     */
+    void Finish()
+    {
+        if (mNumBits > 0)
+        {
+            mrBuffer.push_back(static_cast<char>(mCurrentByte << (8 - mNumBits)));
+            mCurrentByte = 0;
+            mNumBits = 0;
+        }
+    }
+};
+
+/**
+ * Reads bits from a byte buffer written by BitPacker.
+ */
+class BitReader
+{
+private:
+    /** The start of the bits. */
+    const unsigned char* mpBytes;
+
+    /** The index of the next bit. */
+    uint64_t mBitIndex;
+
+public:
+    /**
+     * Constructor.
+     *
+     * @param pBytes the start of the bits
+     */
+    explicit BitReader(const char* pBytes)
+        : mpBytes(reinterpret_cast<const unsigned char*>(pBytes)),
+          mBitIndex(0)
+    {
+    }
+
+    /**
+     * Read numBits bits.
+     *
+     * @param numBits the number of bits (at most 64)
+     * @return the bits, in the low numBits bits of the result
+     */
+    uint64_t Read(unsigned numBits)
+    {
+        uint64_t value = 0;
+        for (unsigned i=0; i<numBits; i++)
+        {
+            unsigned bit = (mpBytes[mBitIndex/8] >> (7 - mBitIndex%8)) & 1u;
+            value = (value << 1) | bit;
+            mBitIndex++;
+        }
+        return value;
+    }
+};
+
+/**
+ * Append the bytes of a value to a buffer in native byte order.
+ *
+ * @param rBuffer the buffer
+ * @param value the value
+ */
+template<typename T>
+static void AppendValue(std::vector<char>& rBuffer, T value)
+{
+    const char* p_bytes = reinterpret_cast<const char*>(&value);
+    rBuffer.insert(rBuffer.end(), p_bytes, p_bytes + sizeof(T));
+}
+
+int64_t QuantisedDeltaCodec::Quantise(double value, double errorBound)
+{
+    double step = 2.0*errorBound;
+    double scaled = value/step;
+    if (!(std::fabs(scaled) < MAX_QUANTISED_MAGNITUDE))
+    {
+        EXCEPTION("Cannot quantise " << value << " with error bound " << errorBound);
+    }
+    int64_t quantised = std::llround(scaled);
+
+    // Rounding in value/step can put the reconstruction just outside
+    // the bound, so nudge towards the value if necessary
+    double reconstructed = Reconstruct(quantised, errorBound);
+    if (std::fabs(reconstructed - value) > errorBound)
+    {
+        quantised += (value > reconstructed) ? 1 : -1;
+    }
+    return quantised;
+}
+
+double QuantisedDeltaCodec::Reconstruct(int64_t quantised, double errorBound)
+{
+    return static_cast<double>(quantised)*(2.0*errorBound);
+}
+
+void QuantisedDeltaCodec::Encode(const std::vector<int64_t>& rQuantised,
+                                 const std::vector<int64_t>& rPrevious,
+                                 const std::vector<int>& rPreviousRows,
+                                 std::vector<char>& rBuffer)
+{
+    // Zigzag encoded prediction residuals
+    std::size_t num_values = rQuantised.size();
+    std::vector<uint64_t> residuals(num_values);
+    double mean_residual = 0.0;
+    for (std::size_t i=0; i<num_values; i++)
+    {
+        int64_t prediction = (rPreviousRows[i] < 0) ? 0 : rPrevious[rPreviousRows[i]];
+        uint64_t difference = static_cast<uint64_t>(rQuantised[i]) - static_cast<uint64_t>(prediction);
+        residuals[i] = (difference << 1) ^ (0 - (difference >> 63));
+        mean_residual += static_cast<double>(residuals[i]);
+    }
+    if (num_values > 0)
+    {
+        mean_residual /= num_values;
+    }
+
+    // The best Rice parameter is close to log2 of the mean residual,
+    // so count the exact coded size for a few values around it
+    int k_guess = (mean_residual < 1.0) ? 0 : static_cast<int>(std::log2(mean_residual));
+    unsigned k = 0;
+    uint64_t best_size = UINT64_MAX;
+    for (int k_try=k_guess-2; k_try<=k_guess+2; k_try++)
+    {
+        if (k_try < 0 || k_try > static_cast<int>(MAX_RICE_PARAMETER))
+        {
+            continue;
+        }
+        uint64_t size = 0;
+        for (std::size_t i=0; i<num_values; i++)
+        {
+            uint64_t quotient = residuals[i] >> k_try;
+            size += (quotient >= ESCAPE) ? ESCAPE + 1 + 64 : quotient + 1;
+        }
+        size += num_values*k_try;
+        if (size < best_size)
+        {
+            best_size = size;
+            k = k_try;
+        }
+    }
+
+    // Block header, with the unary length filled in below
+    std::size_t block_start = rBuffer.size();
+    AppendValue<uint8_t>(rBuffer, k);
+    AppendValue<uint8_t>(rBuffer, 0);
+    AppendValue<uint16_t>(rBuffer, 0);
+    std::size_t num_escapes_position = rBuffer.size();
+    AppendValue<uint32_t>(rBuffer, 0);
+    std::size_t num_unary_bytes_position = rBuffer.size();
+    AppendValue<uint64_t>(rBuffer, 0);
+
+    uint32_t num_escapes = 0;
+    for (std::size_t i=0; i<num_values; i++)
+    {
+        if ((residuals[i] >> k) >= ESCAPE)
+        {
+            AppendValue<uint64_t>(rBuffer, residuals[i]);
+            num_escapes++;
+        }
+    }
+
+    std::size_t unary_start = rBuffer.size();
+    BitPacker unary(rBuffer);
+    for (std::size_t i=0; i<num_values; i++)
+    {
+        uint64_t quotient = residuals[i] >> k;
+        unary.WriteRun(1, (quotient >= ESCAPE) ? ESCAPE : static_cast<unsigned>(quotient));
+        unary.Write(0, 1);
+    }
+    unary.Finish();
+    uint64_t num_unary_bytes = rBuffer.size() - unary_start;
+
+    BitPacker remainders(rBuffer);
+    uint64_t mask = (k == 0) ? 0 : (UINT64_MAX >> (64 - k));
+    for (std::size_t i=0; i<num_values; i++)
+    {
+        uint64_t remainder = ((residuals[i] >> k) >= ESCAPE) ? 0 : (residuals[i] & mask);
+        remainders.Write(remainder, k);
+    }
+    remainders.Finish();
+
+    memcpy(&rBuffer[num_escapes_position], &num_escapes, sizeof(num_escapes));
+    memcpy(&rBuffer[num_unary_bytes_position], &num_unary_bytes, sizeof(num_unary_bytes));
+    rBuffer.resize(block_start + ((rBuffer.size() - block_start + 7)/8)*8, 0);
+}
+
+std::size_t QuantisedDeltaCodec::Decode(const char* pBlock,
+                                        std::size_t numValues,
+                                        const std::vector<int64_t>& rPrevious,
+                                        const std::vector<int>& rPreviousRows,
+                                        std::vector<int64_t>& rQuantised)
+{
+    uint8_t k = static_cast<uint8_t>(pBlock[0]);
+    uint32_t num_escapes;
+    memcpy(&num_escapes, pBlock + 4, sizeof(num_escapes));
+    uint64_t num_unary_bytes;
+    memcpy(&num_unary_bytes, pBlock + 8, sizeof(num_unary_bytes));
+
+    const char* p_escapes = pBlock + 16;
+    BitReader unary(p_escapes + num_escapes*sizeof(uint64_t));
+    BitReader remainders(p_escapes + num_escapes*sizeof(uint64_t) + num_unary_bytes);
+
+    rQuantised.resize(numValues);
+    uint32_t escape_index = 0;
+    for (std::size_t i=0; i<numValues; i++)
+    {
+        uint64_t quotient = 0;
+        while (quotient < ESCAPE && unary.Read(1) == 1u)
+        {
+            quotient++;
+        }
+        if (quotient == ESCAPE)
+        {
+            // The loop stops before reading the zero bit that ends
+            // an escape code, so skip it here
+            unary.Read(1);
+        }
+        uint64_t remainder = remainders.Read(k);
+
+        uint64_t residual;
+        if (quotient == ESCAPE)
+        {
+            if (escape_index >= num_escapes)
+            {
+                EXCEPTION("Corrupt block: more escaped residuals than recorded");
+            }
+            memcpy(&residual, p_escapes + escape_index*sizeof(uint64_t), sizeof(residual));
+            escape_index++;
+        }
+        else
+        {
+            residual = (quotient << k) | remainder;
+        }
+
+        uint64_t difference = (residual >> 1) ^ (0 - (residual & 1u));
+        int64_t prediction = (rPreviousRows[i] < 0) ? 0 : rPrevious[rPreviousRows[i]];
+        rQuantised[i] = static_cast<int64_t>(static_cast<uint64_t>(prediction) + difference);
+    }
+
+    uint64_t num_remainder_bytes = (numValues*k + 7)/8;
+    uint64_t size = 16 + num_escapes*sizeof(uint64_t) + num_unary_bytes + num_remainder_bytes;
+    return ((size + 7)/8)*8;
+}
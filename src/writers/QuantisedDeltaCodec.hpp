@@ -0,0 +1,127 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef QUANTISEDDELTACODEC_HPP_
+#define QUANTISEDDELTACODEC_HPP_
+
+#include <cstddef>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Lossy compression of floating point columns with a guaranteed
+ * absolute error bound, used by ErkPropulsionBinaryWriter.
+ *
+ * Each value v is quantised to the integer q = round(v/(2e)), where e
+ * is the error bound, so that |q*2e - v| <= e. Quantised values are
+ * predicted from the same cell's value in the previous sample and the
+ * prediction residuals, which are small for smoothly varying fields,
+ * are entropy coded with a Golomb-Rice code. The Rice parameter k is
+ * chosen per column to minimise the coded size. Each block has the
+ * layout
+ *
+ *   uint8     k
+ *   uint8[3]  zero
+ *   uint32    number of escaped residuals
+ *   uint64    number of bytes of unary codes
+ *   uint64    escaped residuals
+ *   uint8     unary codes: min(r>>k, ESCAPE) one bits then a zero bit per residual
+ *   uint8     remainders: the low k bits of each residual, packed
+ *   padding to a multiple of 8 bytes
+ *
+ * where residuals are zigzag encoded ((d<<1)^(d>>63)) and bits are
+ * packed most significant first. Residuals with r>>k >= ESCAPE are
+ * stored in full in the escape list instead. Keeping the unary codes
+ * and the fixed-width remainders in separate streams lets a decoder
+ * unpack a whole column with array operations; see
+ * python/read_celldata.py. Decode() reads a block back one value at a
+ * time and is intended for testing.
+ */
+class QuantisedDeltaCodec
+{
+public:
+
+    /** Length of the unary code that marks an escaped residual. */
+    static const unsigned ESCAPE = 24;
+
+    /**
+     * Quantise a value.
+     *
+     * @param value the value
+     * @param errorBound the maximum absolute reconstruction error (> 0)
+     * @return q such that |Reconstruct(q, errorBound) - value| <= errorBound
+     */
+    static int64_t Quantise(double value, double errorBound);
+
+    /**
+     * Reconstruct a quantised value.
+     *
+     * @param quantised the quantised value
+     * @param errorBound the error bound used to quantise it
+     * @return the reconstructed value
+     */
+    static double Reconstruct(int64_t quantised, double errorBound);
+
+    /**
+     * Append a coded block for one column to a buffer.
+     *
+     * @param rQuantised the quantised value of each cell
+     * @param rPrevious the quantised values from the previous sample
+     * @param rPreviousRows for each cell, its index in rPrevious, or -1
+     *     if it was not present (predicted as 0)
+     * @param rBuffer the buffer to append to
+     */
+    static void Encode(const std::vector<int64_t>& rQuantised,
+                       const std::vector<int64_t>& rPrevious,
+                       const std::vector<int>& rPreviousRows,
+                       std::vector<char>& rBuffer);
+
+    /**
+     * Decode a block written by Encode().
+     *
+     * @param pBlock the start of the block
+     * @param numValues the number of values in the block
+     * @param rPrevious the quantised values from the previous sample
+     * @param rPreviousRows for each cell, its index in rPrevious, or -1
+     * @param rQuantised filled with the quantised value of each cell
+     * @return the size of the block in bytes, including padding
+     */
+    static std::size_t Decode(const char* pBlock,
+                              std::size_t numValues,
+                              const std::vector<int64_t>& rPrevious,
+                              const std::vector<int>& rPreviousRows,
+                              std::vector<int64_t>& rQuantised);
+};
+
+#endif /*QUANTISEDDELTACODEC_HPP_*/
@@ -0,0 +1,551 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#include "ErkPropulsionBinaryWriter.hpp"
+#include "AbstractCellPopulation.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "QuantisedDeltaCodec.hpp"
+#include "Exception.hpp"
+#include "UnusedVariable.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+
+/** Number of CellData fields written after the centre coordinates. */
+static const unsigned NUM_CELL_DATA_FIELDS = 4;
+
+/** Names of the CellData fields written after the centre coordinates. */
+static const char* CELL_DATA_FIELD_NAMES[NUM_CELL_DATA_FIELDS] = {"erk", "A0", "A", "theta"};
+
+/** CellData items corresponding to CELL_DATA_FIELD_NAMES. */
+static const char* CELL_DATA_ITEMS[NUM_CELL_DATA_FIELDS] = {"Erk", "Target Area", "volume", "Theta"};
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::ErkPropulsionBinaryWriter()
+    : AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>("celldata.bin"),
+      mNumAsyncBuffers(0),
+      mSamples(1),
+      mCurrentSample(0),
+      mNumPendingSamples(0),
+      mStopIoThread(false),
+      mIoFailed(false)
+{
+    this->mVtkCellDataName = "CellData";
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::~ErkPropulsionBinaryWriter()
+{
+    StopIoThread();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::SetAsynchronous(unsigned numBuffers)
+{
+    if (numBuffers == 1)
+    {
+        EXCEPTION("Asynchronous output needs at least 2 buffers so that one can be filled while another is written");
+    }
+    // Any running I/O thread must finish with the old buffers first
+    StopIoThread();
+    mNumAsyncBuffers = numBuffers;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::GetNumAsyncBuffers()
+{
+    return mNumAsyncBuffers;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::NotifyWaiting()
+{
+    // Taking the lock after changing the queues ensures a thread that
+    // has just checked its wait condition cannot miss this wake-up
+    {
+        std::lock_guard<std::mutex> lock(mWaitMutex);
+    }
+    mWaitCondition.notify_all();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::RecordIoFailure(const std::string& rMessage)
+{
+    if (!mIoFailed.load())
+    {
+        mIoErrorMessage = rMessage;
+        mIoFailed = true;
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::ThrowIfIoFailed()
+{
+    if (mIoFailed.load())
+    {
+        EXCEPTION(mIoErrorMessage);
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::WaitForPendingSamples()
+{
+    std::unique_lock<std::mutex> lock(mWaitMutex);
+    mWaitCondition.wait(lock, [this]{ return mNumPendingSamples.load() == 0; });
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::Flush()
+{
+    WaitForPendingSamples();
+    ThrowIfIoFailed();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::StopIoThread()
+{
+    if (mIoThread.joinable())
+    {
+        // Called from the destructor, so any failure is not raised here
+        WaitForPendingSamples();
+        mStopIoThread = true;
+        NotifyWaiting();
+        mIoThread.join();
+        mStopIoThread = false;
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::IoThreadLoop()
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mWaitMutex);
+            mWaitCondition.wait(lock, [this]{ return !mFilledSamples.IsEmpty() || mStopIoThread.load(); });
+        }
+
+        // Write everything that is ready with the file opened once.
+        // After a failure samples are still taken off the queue, so
+        // the simulation never waits forever for a free buffer.
+        unsigned sample_index;
+        if (mFilledSamples.TryPop(sample_index))
+        {
+            std::ofstream out_stream(mOutputFilePath.c_str(), std::ios::out | std::ios::app | std::ios::binary);
+            if (!out_stream.is_open())
+            {
+                RecordIoFailure("Could not open " + mOutputFilePath + " for asynchronous output");
+            }
+            do
+            {
+                if (!mIoFailed.load())
+                {
+                    try
+                    {
+                        WriteSample(out_stream, mSamples[sample_index]);
+                    }
+                    catch (Exception& e)
+                    {
+                        RecordIoFailure(e.GetMessage());
+                    }
+                    out_stream.flush();
+                    if (!out_stream.good())
+                    {
+                        RecordIoFailure("Could not write the sample at time " + std::to_string(mSamples[sample_index].mTime) + " to " + mOutputFilePath);
+                    }
+                }
+                mFreeSamples.TryPush(sample_index);
+                mNumPendingSamples--;
+                NotifyWaiting();
+            }
+            while (mFilledSamples.TryPop(sample_index));
+        }
+        else if (mStopIoThread.load())
+        {
+            return;
+        }
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::AddExtraField(const std::string& rCellDataName)
+{
+    mExtraFields.push_back(rCellDataName);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::SetErrorBound(const std::string& rFieldName, double errorBound)
+{
+    if (errorBound < 0.0)
+    {
+        EXCEPTION("The error bound for field " << rFieldName << " must be non-negative");
+    }
+    if (errorBound == 0.0)
+    {
+        mErrorBounds.erase(rFieldName);
+    }
+    else
+    {
+        mErrorBounds[rFieldName] = errorBound;
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::GetErrorBound(const std::string& rFieldName)
+{
+    std::map<std::string, double>::const_iterator it = mErrorBounds.find(rFieldName);
+    return (it == mErrorBounds.end()) ? 0.0 : it->second;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+std::vector<std::string> ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::GetFieldNames()
+{
+    std::vector<std::string> names;
+    names.push_back("location_index");
+    names.push_back("cell_id");
+    const char* coordinate_names[3] = {"x", "y", "z"};
+    for (unsigned i=0; i<SPACE_DIM; i++)
+    {
+        names.push_back(coordinate_names[i]);
+    }
+    for (unsigned i=0; i<NUM_CELL_DATA_FIELDS; i++)
+    {
+        names.push_back(CELL_DATA_FIELD_NAMES[i]);
+    }
+    names.insert(names.end(), mExtraFields.begin(), mExtraFields.end());
+    return names;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::WriteColumn(std::ostream& rOutStream, const void* pData, std::size_t numBytes)
+{
+    if (numBytes > 0)
+    {
+        rOutStream.write(static_cast<const char*>(pData), numBytes);
+    }
+    const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    std::size_t num_padding_bytes = (8 - numBytes%8)%8;
+    rOutStream.write(padding, num_padding_bytes);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::WriteSample(std::ostream& rOutStream, const Sample& rSample)
+{
+    uint64_t num_cells = rSample.mCellIds.size();
+    if (mErrorBounds.empty())
+    {
+        rOutStream.write(reinterpret_cast<const char*>(&rSample.mTime), sizeof(rSample.mTime));
+        rOutStream.write(reinterpret_cast<const char*>(&num_cells), sizeof(num_cells));
+
+        WriteColumn(rOutStream, rSample.mLocationIndices.data(), num_cells*sizeof(uint32_t));
+        WriteColumn(rOutStream, rSample.mCellIds.data(), num_cells*sizeof(uint32_t));
+        for (unsigned i=0; i<rSample.mColumns.size(); i++)
+        {
+            assert(rSample.mColumns[i].size() == num_cells);
+            WriteColumn(rOutStream, rSample.mColumns[i].data(), num_cells*sizeof(double));
+        }
+        return;
+    }
+
+    // Find each cell in the previous sample. Cells are nearly always
+    // visited in the same order, in which case no lookup is needed.
+    std::vector<int> previous_rows(num_cells, -1);
+    if (rSample.mCellIds == mPreviousCellIds)
+    {
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            previous_rows[i] = i;
+        }
+    }
+    else
+    {
+        std::unordered_map<uint32_t, int> previous_row_of_cell;
+        for (unsigned i=0; i<mPreviousCellIds.size(); i++)
+        {
+            previous_row_of_cell[mPreviousCellIds[i]] = i;
+        }
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            std::unordered_map<uint32_t, int>::const_iterator it = previous_row_of_cell.find(rSample.mCellIds[i]);
+            if (it != previous_row_of_cell.end())
+            {
+                previous_rows[i] = it->second;
+            }
+        }
+    }
+
+    // Assemble the record so that its size can be written first
+    const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    mRecordBuffer.clear();
+    mRecordBuffer.resize(3*sizeof(uint64_t));
+    mRecordBuffer.insert(mRecordBuffer.end(), reinterpret_cast<const char*>(rSample.mLocationIndices.data()),
+                         reinterpret_cast<const char*>(rSample.mLocationIndices.data() + num_cells));
+    mRecordBuffer.insert(mRecordBuffer.end(), padding, padding + (8 - mRecordBuffer.size()%8)%8);
+    mRecordBuffer.insert(mRecordBuffer.end(), reinterpret_cast<const char*>(rSample.mCellIds.data()),
+                         reinterpret_cast<const char*>(rSample.mCellIds.data() + num_cells));
+    mRecordBuffer.insert(mRecordBuffer.end(), padding, padding + (8 - mRecordBuffer.size()%8)%8);
+    for (unsigned i=0; i<rSample.mColumns.size(); i++)
+    {
+        if (mColumnErrorBounds[i] > 0.0)
+        {
+            assert(rSample.mQuantisedColumns[i].size() == num_cells);
+            QuantisedDeltaCodec::Encode(rSample.mQuantisedColumns[i], mPreviousQuantisedColumns[i], previous_rows, mRecordBuffer);
+        }
+        else
+        {
+            assert(rSample.mColumns[i].size() == num_cells);
+            mRecordBuffer.insert(mRecordBuffer.end(), reinterpret_cast<const char*>(rSample.mColumns[i].data()),
+                                 reinterpret_cast<const char*>(rSample.mColumns[i].data() + num_cells));
+        }
+    }
+
+    uint64_t record_size = mRecordBuffer.size();
+    memcpy(&mRecordBuffer[0], &rSample.mTime, sizeof(rSample.mTime));
+    memcpy(&mRecordBuffer[8], &num_cells, sizeof(num_cells));
+    memcpy(&mRecordBuffer[16], &record_size, sizeof(record_size));
+    rOutStream.write(mRecordBuffer.data(), record_size);
+
+    mPreviousCellIds = rSample.mCellIds;
+    for (unsigned i=0; i<rSample.mColumns.size(); i++)
+    {
+        mPreviousQuantisedColumns[i] = rSample.mQuantisedColumns[i];
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::OpenOutputFile(OutputFileHandler& rOutputFileHandler)
+{
+    // Samples from a previous Solve() belong in the previous file
+    StopIoThread();
+
+    this->mpOutStream = rOutputFileHandler.OpenOutputFile(this->mFileName, std::ios::out | std::ios::trunc | std::ios::binary);
+
+    // Values are written in native byte order, which is recorded in
+    // the magic string and in each numpy dtype
+    const uint16_t byte_order_test = 1;
+    char byte_order = (*reinterpret_cast<const char*>(&byte_order_test) == 1) ? '<' : '>';
+
+    // Work out which floating point columns are compressed
+    std::vector<std::string> names = GetFieldNames();
+    for (std::map<std::string, double>::const_iterator it = mErrorBounds.begin(); it != mErrorBounds.end(); ++it)
+    {
+        if (std::find(names.begin() + 2, names.end(), it->first) == names.end())
+        {
+            EXCEPTION("An error bound is set for " << it->first << ", which is not a floating point field of this writer");
+        }
+    }
+    mColumnErrorBounds.resize(names.size() - 2);
+    for (unsigned i=0; i<mColumnErrorBounds.size(); i++)
+    {
+        mColumnErrorBounds[i] = GetErrorBound(names[i+2]);
+    }
+    mPreviousCellIds.clear();
+    mPreviousQuantisedColumns.assign(mColumnErrorBounds.size(), std::vector<int64_t>());
+
+    uint32_t version = mErrorBounds.empty() ? 1 : 2;
+    uint32_t num_fields = names.size();
+    uint64_t header_size = 24 + ((version == 1) ? 40 : 48)*num_fields;
+
+    char magic[8] = {'E', 'R', 'K', 'C', 'O', 'L', 'S', byte_order};
+    this->mpOutStream->write(magic, 8);
+    this->mpOutStream->write(reinterpret_cast<const char*>(&version), sizeof(version));
+    this->mpOutStream->write(reinterpret_cast<const char*>(&num_fields), sizeof(num_fields));
+    this->mpOutStream->write(reinterpret_cast<const char*>(&header_size), sizeof(header_size));
+
+    for (unsigned i=0; i<num_fields; i++)
+    {
+        // The first two fields are unsigned 32-bit integers, the rest 64-bit floats
+        char name[32];
+        char dtype[8];
+        memset(name, 0, sizeof(name));
+        memset(dtype, 0, sizeof(dtype));
+        strncpy(name, names[i].c_str(), sizeof(name)-1);
+        dtype[0] = byte_order;
+        strncpy(dtype+1, (i < 2) ? "u4" : "f8", sizeof(dtype)-2);
+        this->mpOutStream->write(name, sizeof(name));
+        this->mpOutStream->write(dtype, sizeof(dtype));
+        if (version == 2)
+        {
+            double error_bound = (i < 2) ? 0.0 : mColumnErrorBounds[i-2];
+            this->mpOutStream->write(reinterpret_cast<const char*>(&error_bound), sizeof(error_bound));
+        }
+    }
+    this->mpOutStream->flush();
+
+    // Set up the sample buffers and, if required, start the I/O thread
+    mCurrentSample = 0;
+    if (mNumAsyncBuffers == 0)
+    {
+        mSamples.resize(1);
+    }
+    else
+    {
+        mSamples.resize(mNumAsyncBuffers);
+        mFilledSamples.Reset(mNumAsyncBuffers);
+        mFreeSamples.Reset(mNumAsyncBuffers);
+        for (unsigned i=0; i<mNumAsyncBuffers; i++)
+        {
+            mFreeSamples.TryPush(i);
+        }
+        mOutputFilePath = rOutputFileHandler.GetOutputDirectoryFullPath() + this->mFileName;
+        this->mpOutStream->close();
+        mIoFailed = false;
+        mIoThread = std::thread(&ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::IoThreadLoop, this);
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::OpenOutputFileForAppend(OutputFileHandler& rOutputFileHandler)
+{
+    if (!mIoThread.joinable())
+    {
+        this->mpOutStream = rOutputFileHandler.OpenOutputFile(this->mFileName, std::ios::out | std::ios::app | std::ios::binary);
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::WriteTimeStamp()
+{
+    if (mIoThread.joinable())
+    {
+        // Take a free buffer, waiting for the I/O thread if they are
+        // all still queued (backpressure)
+        if (!mFreeSamples.TryPop(mCurrentSample))
+        {
+            std::unique_lock<std::mutex> lock(mWaitMutex);
+            mWaitCondition.wait(lock, [this]{ return !mFreeSamples.IsEmpty(); });
+            mFreeSamples.TryPop(mCurrentSample);
+        }
+    }
+
+    // Clear the buffer but keep its capacity from the last sample
+    Sample& r_sample = mSamples[mCurrentSample];
+    r_sample.mTime = SimulationTime::Instance()->GetTime();
+    r_sample.mLocationIndices.clear();
+    r_sample.mCellIds.clear();
+    r_sample.mColumns.resize(SPACE_DIM + NUM_CELL_DATA_FIELDS + mExtraFields.size());
+    r_sample.mQuantisedColumns.resize(r_sample.mColumns.size());
+    for (unsigned i=0; i<r_sample.mColumns.size(); i++)
+    {
+        r_sample.mColumns[i].clear();
+        r_sample.mQuantisedColumns[i].clear();
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::WriteNewline()
+{
+    if (mIoThread.joinable())
+    {
+        mNumPendingSamples++;
+        bool pushed = mFilledSamples.TryPush(mCurrentSample);
+        assert(pushed);    // There are only as many samples as queue slots
+        UNUSED_OPT(pushed);
+        NotifyWaiting();
+
+        // Report a failure to write an earlier sample
+        ThrowIfIoFailed();
+    }
+    else
+    {
+        WriteSample(*this->mpOutStream, mSamples[mCurrentSample]);
+        this->mpOutStream->flush();
+        if (!this->mpOutStream->good())
+        {
+            EXCEPTION("Could not write the sample at time " << mSamples[mCurrentSample].mTime << " to " << this->mFileName);
+        }
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+double ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::GetCellDataForVtkOutput(CellPtr pCell, AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
+{
+    double erk = pCell->GetCellData()->GetItem("Erk");
+    return erk;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM>::VisitCell(CellPtr pCell, AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
+{
+    Sample& r_sample = mSamples[mCurrentSample];
+    r_sample.mLocationIndices.push_back(pCellPopulation->GetLocationIndexUsingCell(pCell));
+    r_sample.mCellIds.push_back(pCell->GetCellId());
+
+    // Position of this cell's centre, then Erk, target area, area
+    // and self propulsion angle followed by any extras
+    c_vector<double, SPACE_DIM> centre_location = pCellPopulation->GetLocationOfCellCentre(pCell);
+    for (unsigned i=0; i<r_sample.mColumns.size(); i++)
+    {
+        double value;
+        if (i < SPACE_DIM)
+        {
+            value = centre_location[i];
+        }
+        else if (i < SPACE_DIM + NUM_CELL_DATA_FIELDS)
+        {
+            value = pCell->GetCellData()->GetItem(CELL_DATA_ITEMS[i - SPACE_DIM]);
+        }
+        else
+        {
+            value = pCell->GetCellData()->GetItem(mExtraFields[i - SPACE_DIM - NUM_CELL_DATA_FIELDS]);
+        }
+
+        // Quantise here rather than on the I/O thread so that any
+        // exception is thrown from the simulation
+        if (mColumnErrorBounds[i] > 0.0)
+        {
+            r_sample.mQuantisedColumns[i].push_back(QuantisedDeltaCodec::Quantise(value, mColumnErrorBounds[i]));
+        }
+        else
+        {
+            r_sample.mColumns[i].push_back(value);
+        }
+    }
+}
+
+// Explicit instantiation
+template class ErkPropulsionBinaryWriter<1,1>;
+template class ErkPropulsionBinaryWriter<1,2>;
+template class ErkPropulsionBinaryWriter<2,2>;
+template class ErkPropulsionBinaryWriter<1,3>;
+template class ErkPropulsionBinaryWriter<2,3>;
+template class ErkPropulsionBinaryWriter<3,3>;
+
+#include "SerializationExportWrapperForCpp.hpp"
+// Declare identifier for the serializer
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(ErkPropulsionBinaryWriter)
@@ -0,0 +1,416 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef ERKPROPULSIONBINARYWRITER_HPP_
+#define ERKPROPULSIONBINARYWRITER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include "ChasteSerializationVersion.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+#include "AbstractCellWriter.hpp"
+#include "BoundedSpscQueue.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * A binary, columnar replacement for ErkPropulsionWriterNoAlignment.
+ *
+ * Rather than streaming each cell as whitespace-separated ASCII, the
+ * values of each field are buffered while cells are visited and
+ * written once per sample as a contiguous typed array. The output file
+ * is called celldata.bin by default and has the layout
+ *
+ *   file header:
+ *     char[8]   magic "ERKCOLS" followed by '<' or '>' (byte order)
+ *     uint32    format version (1, or 2 if any field has an error bound)
+ *     uint32    number of fields
+ *     uint64    size of the file header in bytes
+ *     per field: char[32] name and char[8] numpy dtype string (both NUL padded)
+ *
+ *   per sample:
+ *     float64   simulation time
+ *     uint64    number of cells
+ *     per field: one value per cell, padded to a multiple of 8 bytes
+ *
+ * The fields are location_index and cell_id (uint32), the centre
+ * coordinates x, y (and z), erk, A0, A and theta (float64), followed
+ * by any extra CellData items added with AddExtraField(). Every block
+ * is 8-byte aligned so the file can be memory mapped and each column
+ * viewed directly as an array; see python/read_celldata.py.
+ *
+ * If an absolute error bound is set for any floating point field with
+ * SetErrorBound(), the file is written as format version 2 instead.
+ * Each field entry in the file header is followed by a float64 error
+ * bound (0 for fields stored exactly) and each sample starts with an
+ * extra uint64 giving the size of the whole sample record in bytes.
+ * Fields with an error bound are stored as a compressed block (see
+ * QuantisedDeltaCodec) rather than a float64 array, and reconstruct
+ * to within the bound of the simulated values.
+ *
+ * If SetAsynchronous() is called, visiting cells only copies their
+ * values into one of a fixed pool of preallocated sample buffers.
+ * Completed samples are handed to a background I/O thread through a
+ * bounded lock-free queue and the simulation keeps stepping. If all
+ * buffers are waiting to be written the simulation blocks until one
+ * is free (backpressure). Flush() waits for all pending samples to
+ * be written; see AsyncOutputFlushModifier for calling it at the end
+ * of Solve().
+ *
+ * If the I/O thread cannot open or write the output file it drops
+ * the remaining samples and the failure is raised as an exception on
+ * the simulation thread, when the next sample is handed over or at
+ * Flush().
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class ErkPropulsionBinaryWriter : public AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>
+{
+private:
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * Version 0 archives only contain the extra fields, version 1 adds
+     * the number of asynchronous buffers and version 2 the error
+     * bounds. Members missing from older archives keep their defaults.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & mExtraFields;
+        if (version >= 1)
+        {
+            archive & mNumAsyncBuffers;
+        }
+        if (version >= 2)
+        {
+            archive & mErrorBounds;
+        }
+    }
+
+    /** The values of all fields for one sample. */
+    struct Sample
+    {
+        /** Simulation time of the sample. */
+        double mTime;
+
+        /** Location index of each cell. */
+        std::vector<uint32_t> mLocationIndices;
+
+        /** Id of each cell. */
+        std::vector<uint32_t> mCellIds;
+
+        /**
+         * Floating point columns in the order centre coordinates,
+         * erk, A0, A, theta, extra fields. Empty for columns with an
+         * error bound.
+         */
+        std::vector<std::vector<double> > mColumns;
+
+        /** Quantised values of the columns with an error bound. */
+        std::vector<std::vector<int64_t> > mQuantisedColumns;
+    };
+
+    /** Names of additional CellData items to output after the standard fields. */
+    std::vector<std::string> mExtraFields;
+
+    /**
+     * The number of sample buffers used for asynchronous output, or 0
+     * to write synchronously from the simulation thread.
+     */
+    unsigned mNumAsyncBuffers;
+
+    /** Pool of sample buffers (a single buffer for synchronous output). */
+    std::vector<Sample> mSamples;
+
+    /** Index in mSamples of the sample currently being filled. */
+    unsigned mCurrentSample;
+
+    /** Indices of filled samples waiting to be written by the I/O thread. */
+    BoundedSpscQueue<unsigned> mFilledSamples;
+
+    /** Indices of samples that have been written and may be reused. */
+    BoundedSpscQueue<unsigned> mFreeSamples;
+
+    /** The number of samples handed to the I/O thread but not yet written. */
+    std::atomic<unsigned> mNumPendingSamples;
+
+    /** Set to tell the I/O thread to exit once the queue is drained. */
+    std::atomic<bool> mStopIoThread;
+
+    /**
+     * Set by the I/O thread if the output file could not be opened or
+     * written. Later samples are then dropped and the failure is
+     * raised on the simulation thread at the next hand-off or Flush().
+     */
+    std::atomic<bool> mIoFailed;
+
+    /** Description of the failure, written before mIoFailed is set. */
+    std::string mIoErrorMessage;
+
+    /** The background I/O thread. */
+    std::thread mIoThread;
+
+    /** Mutex used only to sleep while waiting on the queues. */
+    std::mutex mWaitMutex;
+
+    /** Condition variable signalled whenever either queue changes. */
+    std::condition_variable mWaitCondition;
+
+    /** Full path of the output file, used by the I/O thread. */
+    std::string mOutputFilePath;
+
+    /** Absolute error bounds set with SetErrorBound(), by field name. */
+    std::map<std::string, double> mErrorBounds;
+
+    /** The error bound of each floating point column, or 0 if stored exactly. */
+    std::vector<double> mColumnErrorBounds;
+
+    /** Cell ids of the last sample written, used to predict quantised values. */
+    std::vector<uint32_t> mPreviousCellIds;
+
+    /** Quantised columns of the last sample written. */
+    std::vector<std::vector<int64_t> > mPreviousQuantisedColumns;
+
+    /** Buffer in which compressed sample records are assembled. */
+    std::vector<char> mRecordBuffer;
+
+    /**
+     * Write a column of values followed by zero padding up to a
+     * multiple of 8 bytes.
+     *
+     * @param rOutStream the stream to write to
+     * @param pData pointer to the first value
+     * @param numBytes the number of bytes of data
+     */
+    static void WriteColumn(std::ostream& rOutStream, const void* pData, std::size_t numBytes);
+
+    /**
+     * Write a complete sample record. For compressed output this also
+     * updates the previous sample used for prediction, so samples must
+     * be written in order from a single thread.
+     *
+     * @param rOutStream the stream to write to
+     * @param rSample the sample
+     */
+    void WriteSample(std::ostream& rOutStream, const Sample& rSample);
+
+    /**
+     * Main loop of the background I/O thread.
+     */
+    void IoThreadLoop();
+
+    /**
+     * Wake up any thread waiting on the queues.
+     */
+    void NotifyWaiting();
+
+    /**
+     * Record a failure of the I/O thread, unless one is already recorded.
+     *
+     * @param rMessage description of the failure
+     */
+    void RecordIoFailure(const std::string& rMessage);
+
+    /**
+     * Throw an exception on the calling thread if the I/O thread has
+     * failed to write a sample.
+     */
+    void ThrowIfIoFailed();
+
+    /**
+     * Block until every sample handed to the I/O thread has been
+     * written (or dropped after a failure).
+     */
+    void WaitForPendingSamples();
+
+    /**
+     * Stop and join the I/O thread after writing all pending samples.
+     */
+    void StopIoThread();
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    ErkPropulsionBinaryWriter();
+
+    /**
+     * Destructor. Writes any pending samples and stops the I/O thread.
+     */
+    virtual ~ErkPropulsionBinaryWriter();
+
+    /**
+     * Write samples from a background I/O thread.
+     *
+     * @param numBuffers the number of preallocated sample buffers
+     *     (at least 2), or 0 to write synchronously
+     */
+    void SetAsynchronous(unsigned numBuffers);
+
+    /**
+     * @return mNumAsyncBuffers
+     */
+    unsigned GetNumAsyncBuffers();
+
+    /**
+     * Block until every sample handed to the I/O thread has been
+     * written to file. Does nothing for synchronous output.
+     *
+     * Throws an exception if the I/O thread failed to open or write
+     * the output file.
+     */
+    void Flush();
+
+    /**
+     * Store a floating point field with bounded loss of precision.
+     *
+     * @param rFieldName the name of the field, as in GetFieldNames()
+     * @param errorBound the maximum absolute error in the stored
+     *     values, or 0 to store the field exactly
+     */
+    void SetErrorBound(const std::string& rFieldName, double errorBound);
+
+    /**
+     * @param rFieldName the name of a field
+     * @return the error bound of the field (0 if stored exactly)
+     */
+    double GetErrorBound(const std::string& rFieldName);
+
+    /**
+     * Add a CellData item to be written as an extra float64 field.
+     *
+     * @param rCellDataName the name of the item in CellData
+     */
+    void AddExtraField(const std::string& rCellDataName);
+
+    /**
+     * @return the names of all fields in the order they are written
+     */
+    std::vector<std::string> GetFieldNames();
+
+    /**
+     * Overridden OpenOutputFile() method.
+     *
+     * Open the file in binary mode and write the file header. For
+     * asynchronous output this also starts the I/O thread. Throws if an
+     * error bound has been set for a field that is not written.
+     *
+     * @param rOutputFileHandler handler for the directory in which to open this file
+     */
+    virtual void OpenOutputFile(OutputFileHandler& rOutputFileHandler);
+
+    /**
+     * Overridden OpenOutputFileForAppend() method. Does nothing for
+     * asynchronous output since the I/O thread owns the file.
+     *
+     * @param rOutputFileHandler handler for the directory in which to open this file
+     */
+    virtual void OpenOutputFileForAppend(OutputFileHandler& rOutputFileHandler);
+
+    /**
+     * Overridden WriteTimeStamp() method.
+     *
+     * Record the current time and clear a buffer for a new sample,
+     * waiting for one to become free if necessary.
+     */
+    virtual void WriteTimeStamp();
+
+    /**
+     * Overridden WriteNewline() method.
+     *
+     * Write the buffered sample to file, or hand it to the I/O thread.
+     */
+    virtual void WriteNewline();
+
+    /**
+     * Overridden GetCellDataForVtkOutput() method.
+     *
+     * @param pCell a cell
+     * @param pCellPopulation a pointer to the cell population owning the cell
+     *
+     * @return the level of Erk in the cell
+     */
+    double GetCellDataForVtkOutput(CellPtr pCell, AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Overridden VisitCell() method.
+     *
+     * Append this cell's values to the column buffers, quantising
+     * those of fields with an error bound.
+     *
+     * @param pCell a cell
+     * @param pCellPopulation a pointer to the cell population owning the cell
+     */
+    virtual void VisitCell(CellPtr pCell, AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation);
+};
+
+namespace boost
+{
+namespace serialization
+{
+/**
+ * Specify a version number for archives of ErkPropulsionBinaryWriter,
+ * so that checkpoints written before later members were added can
+ * still be loaded.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+struct version<ErkPropulsionBinaryWriter<ELEMENT_DIM, SPACE_DIM> >
+{
+    ///Macro to set the version number of templated archive in known versions of Boost
+    CHASTE_VERSION_CONTENT(2);
+};
+} // namespace serialization
+} // namespace boost
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(ErkPropulsionBinaryWriter)
+
+#endif /*  ERKPROPULSIONBINARYWRITER_HPP_ */
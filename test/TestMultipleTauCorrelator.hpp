@@ -0,0 +1,207 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTMULTIPLETAUCORRELATOR_HPP_
+#define TESTMULTIPLETAUCORRELATOR_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+#include "MultipleTauCorrelator.hpp"
+#include "RandomNumberGenerator.hpp"
+
+class TestMultipleTauCorrelator : public AbstractCellBasedTestSuite
+{
+private:
+
+  // A two-dimensional random walk, or its steps if !cumulative
+  std::vector<std::vector<double> > MakeSeries(unsigned numSamples, bool cumulative)
+  {
+    RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+    std::vector<std::vector<double> > series(numSamples, std::vector<double>(2, 0.0));
+    for (unsigned t=0; t<numSamples; t++)
+      {
+	for (unsigned d=0; d<2; d++)
+	  {
+	    double step = p_gen->ranf() - 0.5;
+	    series[t][d] = (cumulative && t > 0) ? series[t-1][d] + step : step;
+	  }
+      }
+    return series;
+  }
+
+  // Check every lag of a correlator against all pairs of the series
+  // as seen by each level: the last value of each block of
+  // averagingFactor^level samples for squared differences, or the
+  // block average for products
+  void CheckAgainstBruteForce(const MultipleTauCorrelator& rCorrelator,
+			      const std::vector<std::vector<std::vector<double> > >& rAllSeries,
+			      MultipleTauCorrelator::Mode mode,
+			      unsigned numLevels, unsigned pointsPerLevel, unsigned averagingFactor)
+  {
+    unsigned lag_index = 0;
+    unsigned block_size = 1;
+    for (unsigned level=0; level<numLevels; level++)
+      {
+	unsigned first_point = (level == 0) ? 0 : pointsPerLevel/averagingFactor;
+	for (unsigned point=first_point; point<pointsPerLevel; point++)
+	  {
+	    TS_ASSERT_EQUALS(rCorrelator.GetLag(lag_index), (unsigned long)(point*block_size));
+
+	    double sum = 0.0;
+	    unsigned long count = 0;
+	    for (unsigned s=0; s<rAllSeries.size(); s++)
+	      {
+		const std::vector<std::vector<double> >& r_series = rAllSeries[s];
+		unsigned num_blocks = r_series.size()/block_size;
+		std::vector<std::vector<double> > level_values(num_blocks, std::vector<double>(2, 0.0));
+		for (unsigned k=0; k<num_blocks; k++)
+		  {
+		    for (unsigned d=0; d<2; d++)
+		      {
+			if (mode == MultipleTauCorrelator::SQUARED_DIFFERENCE)
+			  {
+			    level_values[k][d] = r_series[(k+1)*block_size - 1][d];
+			  }
+			else
+			  {
+			    for (unsigned t=k*block_size; t<(k+1)*block_size; t++)
+			      {
+				level_values[k][d] += r_series[t][d]/block_size;
+			      }
+			  }
+		      }
+		  }
+		for (unsigned k=point; k<num_blocks; k++)
+		  {
+		    for (unsigned d=0; d<2; d++)
+		      {
+			if (mode == MultipleTauCorrelator::SQUARED_DIFFERENCE)
+			  {
+			    double difference = level_values[k][d] - level_values[k-point][d];
+			    sum += difference*difference;
+			  }
+			else
+			  {
+			    sum += level_values[k][d]*level_values[k-point][d];
+			  }
+		      }
+		    count++;
+		  }
+	      }
+
+	    TS_ASSERT_EQUALS(rCorrelator.GetCount(lag_index), count);
+	    TS_ASSERT_DELTA(rCorrelator.GetSum(lag_index), sum, 1e-10);
+	    lag_index++;
+	  }
+	block_size *= averagingFactor;
+      }
+    TS_ASSERT_EQUALS(lag_index, rCorrelator.GetNumLags());
+  }
+
+public:
+
+  void TestMeanSquaredDisplacement()
+    {
+      const unsigned num_levels = 4;
+      const unsigned points_per_level = 8;
+      const unsigned averaging_factor = 2;
+      std::vector<std::vector<std::vector<double> > > all_series(1, MakeSeries(203, true));
+
+      MultipleTauCorrelator correlator(2, MultipleTauCorrelator::SQUARED_DIFFERENCE, num_levels, points_per_level, averaging_factor);
+      for (unsigned t=0; t<all_series[0].size(); t++)
+	{
+	  correlator.Add(all_series[0][t]);
+	}
+      CheckAgainstBruteForce(correlator, all_series, MultipleTauCorrelator::SQUARED_DIFFERENCE, num_levels, points_per_level, averaging_factor);
+
+      // The zero lag has no displacement
+      TS_ASSERT_DELTA(correlator.GetCorrelation(0), 0.0, 1e-12);
+    }
+
+  void TestVelocityAutocorrelation()
+    {
+      const unsigned num_levels = 3;
+      const unsigned points_per_level = 9;
+      const unsigned averaging_factor = 3;
+      std::vector<std::vector<std::vector<double> > > all_series(1, MakeSeries(250, false));
+
+      MultipleTauCorrelator correlator(2, MultipleTauCorrelator::PRODUCT, num_levels, points_per_level, averaging_factor);
+      for (unsigned t=0; t<all_series[0].size(); t++)
+	{
+	  correlator.Add(all_series[0][t]);
+	}
+      CheckAgainstBruteForce(correlator, all_series, MultipleTauCorrelator::PRODUCT, num_levels, points_per_level, averaging_factor);
+    }
+
+  void TestSharedCorrelator()
+    {
+      // Several series, added interleaved through their own shift
+      // registers, accumulate the pairs of each series only
+      const unsigned num_levels = 4;
+      const unsigned points_per_level = 4;
+      const unsigned averaging_factor = 2;
+      std::vector<std::vector<std::vector<double> > > all_series;
+      all_series.push_back(MakeSeries(100, true));
+      all_series.push_back(MakeSeries(100, true));
+      all_series.push_back(MakeSeries(100, true));
+
+      MultipleTauCorrelator correlator(2, MultipleTauCorrelator::SQUARED_DIFFERENCE, num_levels, points_per_level, averaging_factor);
+      std::vector<MultipleTauCorrelator::ShiftRegister> shift_registers(all_series.size());
+      for (unsigned s=0; s<all_series.size(); s++)
+	{
+	  correlator.ResetShiftRegister(shift_registers[s]);
+	}
+      for (unsigned t=0; t<100; t++)
+	{
+	  for (unsigned s=0; s<all_series.size(); s++)
+	    {
+	      correlator.Add(shift_registers[s], all_series[s][t]);
+	    }
+	}
+      CheckAgainstBruteForce(correlator, all_series, MultipleTauCorrelator::SQUARED_DIFFERENCE, num_levels, points_per_level, averaging_factor);
+    }
+
+  void TestBadParameters()
+    {
+      TS_ASSERT_THROWS_THIS(MultipleTauCorrelator(0), "A correlator needs at least one component and one level");
+      TS_ASSERT_THROWS_THIS(MultipleTauCorrelator(2, MultipleTauCorrelator::PRODUCT, 4, 6, 4),
+			    "The points per level must be a multiple of an averaging factor of at least 2");
+    }
+};
+
+#endif /*TESTMULTIPLETAUCORRELATOR_HPP_*/
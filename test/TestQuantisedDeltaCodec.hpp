@@ -0,0 +1,233 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTQUANTISEDDELTACODEC_HPP_
+#define TESTQUANTISEDDELTACODEC_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+#include "QuantisedDeltaCodec.hpp"
+#include "RandomNumberGenerator.hpp"
+
+#include <cmath>
+#include <cstring>
+
+class TestQuantisedDeltaCodec : public AbstractCellBasedTestSuite
+{
+private:
+
+  // Encode a series of samples of one column, each predicted from the
+  // last, decode them again and check every value is within the bound.
+  // Returns the total number of escaped residuals.
+  unsigned CheckRoundTrip(const std::vector<std::vector<double> >& rSamples,
+			  const std::vector<std::vector<int> >& rPreviousRows,
+			  double errorBound)
+  {
+    unsigned num_escapes = 0;
+    std::vector<int64_t> previous_encoded;
+    std::vector<int64_t> previous_decoded;
+    for (unsigned sample=0; sample<rSamples.size(); sample++)
+      {
+	const std::vector<double>& r_values = rSamples[sample];
+	std::vector<int64_t> quantised(r_values.size());
+	for (unsigned i=0; i<r_values.size(); i++)
+	  {
+	    quantised[i] = QuantisedDeltaCodec::Quantise(r_values[i], errorBound);
+	  }
+
+	// Start the block part way into a buffer, as the writer does
+	std::vector<char> buffer(8, 0);
+	QuantisedDeltaCodec::Encode(quantised, previous_encoded, rPreviousRows[sample], buffer);
+	TS_ASSERT_EQUALS(buffer.size()%8, 0u);
+
+	std::vector<int64_t> decoded;
+	std::size_t block_size = QuantisedDeltaCodec::Decode(&buffer[8], r_values.size(),
+							     previous_decoded, rPreviousRows[sample], decoded);
+	TS_ASSERT_EQUALS(block_size, buffer.size() - 8);
+	TS_ASSERT_EQUALS(decoded.size(), r_values.size());
+
+	for (unsigned i=0; i<r_values.size(); i++)
+	  {
+	    TS_ASSERT_EQUALS(decoded[i], quantised[i]);
+	    double reconstructed = QuantisedDeltaCodec::Reconstruct(decoded[i], errorBound);
+	    TS_ASSERT_LESS_THAN_EQUALS(std::fabs(reconstructed - r_values[i]), errorBound);
+	  }
+
+	uint32_t block_escapes;
+	memcpy(&block_escapes, &buffer[12], sizeof(block_escapes));
+	num_escapes += block_escapes;
+
+	previous_encoded = quantised;
+	previous_decoded = decoded;
+      }
+    return num_escapes;
+  }
+
+  // Each cell is in the same row as in the previous sample
+  std::vector<std::vector<int> > SameRows(unsigned numSamples, unsigned numCells)
+  {
+    std::vector<std::vector<int> > rows(numSamples, std::vector<int>(numCells));
+    for (unsigned i=0; i<numCells; i++)
+      {
+	rows[0][i] = -1;
+	for (unsigned sample=1; sample<numSamples; sample++)
+	  {
+	    rows[sample][i] = i;
+	  }
+      }
+    return rows;
+  }
+
+public:
+
+  void TestSmoothSeries()
+    {
+      const unsigned num_samples = 20;
+      const unsigned num_cells = 100;
+      std::vector<std::vector<double> > samples(num_samples, std::vector<double>(num_cells));
+      for (unsigned sample=0; sample<num_samples; sample++)
+	{
+	  for (unsigned i=0; i<num_cells; i++)
+	    {
+	      samples[sample][i] = 1.0 + 0.5*sin(0.1*sample + 0.3*i);
+	    }
+	}
+
+      for (double error_bound = 1e-6; error_bound < 1.0; error_bound *= 10.0)
+	{
+	  CheckRoundTrip(samples, SameRows(num_samples, num_cells), error_bound);
+	}
+    }
+
+  void TestNoisySeries()
+    {
+      RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+      const unsigned num_samples = 20;
+      const unsigned num_cells = 100;
+      std::vector<std::vector<double> > samples(num_samples, std::vector<double>(num_cells));
+      for (unsigned sample=0; sample<num_samples; sample++)
+	{
+	  for (unsigned i=0; i<num_cells; i++)
+	    {
+	      samples[sample][i] = -3.0 + 6.0*p_gen->ranf();
+	    }
+	}
+
+      // Includes bounds both coarser and much finer than the noise
+      for (double error_bound = 1e-9; error_bound < 10.0; error_bound *= 10.0)
+	{
+	  CheckRoundTrip(samples, SameRows(num_samples, num_cells), error_bound);
+	}
+    }
+
+  void TestJumpingSeriesUsesEscapes()
+    {
+      // Mostly constant values with occasional jumps far larger than
+      // the typical residual, which are coded as escapes
+      const unsigned num_samples = 10;
+      const unsigned num_cells = 200;
+      std::vector<std::vector<double> > samples(num_samples, std::vector<double>(num_cells));
+      for (unsigned sample=0; sample<num_samples; sample++)
+	{
+	  for (unsigned i=0; i<num_cells; i++)
+	    {
+	      samples[sample][i] = 0.01*i;
+	      if ((i + sample)%37 == 0)
+		{
+		  samples[sample][i] += (sample%2 == 0) ? 1e4 : -1e4;
+		}
+	    }
+	}
+
+      unsigned num_escapes = CheckRoundTrip(samples, SameRows(num_samples, num_cells), 1e-5);
+      TS_ASSERT_LESS_THAN(0u, num_escapes);
+    }
+
+  void TestCellsEnteringAndLeaving()
+    {
+      // Cells change rows between samples, some disappear and new ones
+      // appear that are predicted from zero
+      RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+      std::vector<std::vector<double> > samples;
+      std::vector<std::vector<int> > rows;
+
+      std::vector<double> values;
+      std::vector<int> first_rows;
+      for (unsigned i=0; i<50; i++)
+	{
+	  values.push_back(10.0 + p_gen->ranf());
+	  first_rows.push_back(-1);
+	}
+      samples.push_back(values);
+      rows.push_back(first_rows);
+
+      for (unsigned sample=1; sample<10; sample++)
+	{
+	  const std::vector<double>& r_last = samples.back();
+	  std::vector<double> next;
+	  std::vector<int> next_rows;
+
+	  // Keep every cell but the first, in reverse order
+	  for (unsigned i=r_last.size()-1; i>0; i--)
+	    {
+	      next.push_back(r_last[i] + 0.01*(p_gen->ranf() - 0.5));
+	      next_rows.push_back(i);
+	    }
+
+	  // and add two new ones
+	  for (unsigned j=0; j<2; j++)
+	    {
+	      next.push_back(10.0 + p_gen->ranf());
+	      next_rows.push_back(-1);
+	    }
+	  samples.push_back(next);
+	  rows.push_back(next_rows);
+	}
+
+      CheckRoundTrip(samples, rows, 1e-4);
+    }
+
+  void TestEmptyColumn()
+    {
+      std::vector<std::vector<double> > samples(2);
+      std::vector<std::vector<int> > rows(2);
+      CheckRoundTrip(samples, rows, 1e-3);
+    }
+};
+
+#endif /*TESTQUANTISEDDELTACODEC_HPP_*/
@@ -0,0 +1,255 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+
+#ifndef TESTREORDERABLETOROIDAL2DVERTEXMESH_HPP_
+#define TESTREORDERABLETOROIDAL2DVERTEXMESH_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+
+#include "ToroidalHoneycombVertexMeshGenerator2.hpp"
+#include "VertexElementMap.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+
+class TestReorderableToroidal2dVertexMesh : public AbstractCellBasedTestSuite
+{
+private:
+
+  // A copy of a mesh as a plain Toroidal2dVertexMesh, which makes the
+  // full check for internal intersections in MutableVertexMesh
+  Toroidal2dVertexMesh* MakePlainCopy(ReorderableToroidal2dVertexMesh& rMesh)
+  {
+    std::vector<Node<2>*> nodes;
+    for (unsigned node_index=0; node_index<rMesh.GetNumNodes(); node_index++)
+      {
+	nodes.push_back(new Node<2>(node_index, rMesh.GetNode(node_index)->rGetLocation()));
+      }
+    std::vector<VertexElement<2, 2>*> elements;
+    for (unsigned elem_index=0; elem_index<rMesh.GetNumElements(); elem_index++)
+      {
+	VertexElement<2, 2>* p_element = rMesh.GetElement(elem_index);
+	std::vector<Node<2>*> element_nodes;
+	for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+	  {
+	    element_nodes.push_back(nodes[p_element->GetNodeGlobalIndex(local_index)]);
+	  }
+	elements.push_back(new VertexElement<2, 2>(elem_index, element_nodes));
+      }
+    return new Toroidal2dVertexMesh(rMesh.GetWidth(0), rMesh.GetWidth(1), nodes, elements,
+				    rMesh.GetCellRearrangementThreshold(), rMesh.GetT2Threshold());
+  }
+
+  // The node indices of each element
+  std::vector<std::vector<unsigned> > GetElementNodeIndices(MutableVertexMesh<2, 2>& rMesh)
+  {
+    std::vector<std::vector<unsigned> > element_nodes(rMesh.GetNumElements());
+    for (unsigned elem_index=0; elem_index<rMesh.GetNumElements(); elem_index++)
+      {
+	VertexElement<2, 2>* p_element = rMesh.GetElement(elem_index);
+	for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+	  {
+	    element_nodes[elem_index].push_back(p_element->GetNodeGlobalIndex(local_index));
+	  }
+      }
+    return element_nodes;
+  }
+
+public:
+
+  void TestReorderAlongHilbertCurveKeepsConnectivity()
+    {
+      ToroidalHoneycombVertexMeshGenerator2 generator(8, 6, 1.0, 0.05);
+      ReorderableToroidal2dVertexMesh* p_mesh = generator.GetToroidalMesh();
+      unsigned num_nodes = p_mesh->GetNumNodes();
+      unsigned num_elements = p_mesh->GetNumElements();
+
+      // Record each element's nodes by location, which renumbering must not change
+      std::vector<std::vector<c_vector<double, 2> > > element_node_locations(num_elements);
+      for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+	{
+	  VertexElement<2, 2>* p_element = p_mesh->GetElement(elem_index);
+	  for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+	    {
+	      element_node_locations[elem_index].push_back(p_element->GetNodeLocation(local_index));
+	    }
+	}
+
+      std::vector<unsigned> element_order = p_mesh->ReorderAlongHilbertCurve();
+
+      // The order is a permutation of the elements
+      TS_ASSERT_EQUALS(element_order.size(), num_elements);
+      std::vector<unsigned> sorted_order(element_order);
+      std::sort(sorted_order.begin(), sorted_order.end());
+      for (unsigned i=0; i<num_elements; i++)
+	{
+	  TS_ASSERT_EQUALS(sorted_order[i], i);
+	}
+
+      TS_ASSERT_EQUALS(p_mesh->GetNumNodes(), num_nodes);
+      TS_ASSERT_EQUALS(p_mesh->GetNumElements(), num_elements);
+      for (unsigned node_index=0; node_index<num_nodes; node_index++)
+	{
+	  TS_ASSERT_EQUALS(p_mesh->GetNode(node_index)->GetIndex(), node_index);
+	}
+
+      // Each renumbered element has the nodes of the element it came
+      // from, in the same order, and each of its nodes knows it by
+      // its new index
+      unsigned num_memberships = 0;
+      for (unsigned elem_index=0; elem_index<num_elements; elem_index++)
+	{
+	  VertexElement<2, 2>* p_element = p_mesh->GetElement(elem_index);
+	  TS_ASSERT_EQUALS(p_element->GetIndex(), elem_index);
+
+	  const std::vector<c_vector<double, 2> >& r_locations = element_node_locations[element_order[elem_index]];
+	  TS_ASSERT_EQUALS(p_element->GetNumNodes(), r_locations.size());
+	  for (unsigned local_index=0; local_index<p_element->GetNumNodes(); local_index++)
+	    {
+	      Node<2>* p_node = p_element->GetNode(local_index);
+	      TS_ASSERT_EQUALS(p_mesh->GetNode(p_element->GetNodeGlobalIndex(local_index)), p_node);
+	      TS_ASSERT_EQUALS(p_node->rGetContainingElementIndices().count(elem_index), 1u);
+	      TS_ASSERT_DELTA(p_node->rGetLocation()[0], r_locations[local_index][0], 1e-12);
+	      TS_ASSERT_DELTA(p_node->rGetLocation()[1], r_locations[local_index][1], 1e-12);
+	    }
+	  num_memberships += p_element->GetNumNodes();
+	}
+
+      // and no node is left holding an element it is no longer part of
+      unsigned num_containing_elements = 0;
+      for (unsigned node_index=0; node_index<num_nodes; node_index++)
+	{
+	  num_containing_elements += p_mesh->GetNode(node_index)->rGetContainingElementIndices().size();
+	}
+      TS_ASSERT_EQUALS(num_containing_elements, num_memberships);
+
+      // The nodes are numbered as they are first met going round the elements
+      TS_ASSERT_EQUALS(p_mesh->GetElement(0)->GetNodeGlobalIndex(0), 0u);
+    }
+
+  void TestSpatialHashIntersectionCheckMatchesFullCheck()
+    {
+      // Push a node into a neighbouring element, once in the middle of
+      // the domain and once at a corner, where the elements wrap round
+      // the periodic boundaries
+      double targets[2][2] = {{4.0, 3.0}, {0.0, 0.0}};
+      for (unsigned target=0; target<2; target++)
+	{
+	  ToroidalHoneycombVertexMeshGenerator2 generator(8, 6, 1.0, 0.05);
+	  ReorderableToroidal2dVertexMesh* p_mesh = generator.GetToroidalMesh();
+	  Toroidal2dVertexMesh* p_plain_mesh = MakePlainCopy(*p_mesh);
+	  p_mesh->SetCheckForInternalIntersections(true);
+	  p_plain_mesh->SetCheckForInternalIntersections(true);
+
+	  c_vector<double, 2> target_location;
+	  target_location[0] = targets[target][0];
+	  target_location[1] = targets[target][1];
+	  unsigned node_index = 0;
+	  double closest = DBL_MAX;
+	  for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+	    {
+	      double distance = norm_2(p_mesh->GetVectorFromAtoB(target_location, p_mesh->GetNode(i)->rGetLocation()));
+	      if (distance < closest)
+		{
+		  closest = distance;
+		  node_index = i;
+		}
+	    }
+
+	  // Take a neighbour along an edge, and the element on its far
+	  // side, which the edge produced beyond the neighbour runs into
+	  Node<2>* p_node = p_mesh->GetNode(node_index);
+	  VertexElement<2, 2>* p_element = p_mesh->GetElement(*(p_node->rGetContainingElementIndices().begin()));
+	  unsigned local_index = p_element->GetNodeLocalIndex(node_index);
+	  Node<2>* p_neighbour = p_element->GetNode((local_index + 1)%p_element->GetNumNodes());
+	  unsigned far_element_index = UINT_MAX;
+	  for (std::set<unsigned>::const_iterator iter = p_neighbour->rGetContainingElementIndices().begin();
+	       iter != p_neighbour->rGetContainingElementIndices().end();
+	       ++iter)
+	    {
+	      if (p_node->rGetContainingElementIndices().count(*iter) == 0)
+		{
+		  far_element_index = *iter;
+		}
+	    }
+	  TS_ASSERT_DIFFERS(far_element_index, UINT_MAX);
+
+	  c_vector<double, 2> new_location = p_neighbour->rGetLocation()
+	    + 0.25*p_mesh->GetVectorFromAtoB(p_node->rGetLocation(), p_neighbour->rGetLocation());
+	  p_mesh->GetNode(node_index)->rGetModifiableLocation() = new_location;
+	  p_plain_mesh->GetNode(node_index)->rGetModifiableLocation() = new_location;
+	  TS_ASSERT(p_mesh->ElementIncludesPoint(new_location, far_element_index));
+	  TS_ASSERT(p_plain_mesh->ElementIncludesPoint(new_location, far_element_index));
+
+	  std::vector<std::vector<unsigned> > element_nodes_before = GetElementNodeIndices(*p_mesh);
+	  VertexElementMap element_map(p_mesh->GetNumElements());
+	  p_mesh->ReMesh(element_map);
+	  VertexElementMap plain_element_map(p_plain_mesh->GetNumElements());
+	  p_plain_mesh->ReMesh(plain_element_map);
+
+	  // Both checks found and fixed the same intersection
+	  std::vector<std::vector<unsigned> > element_nodes = GetElementNodeIndices(*p_mesh);
+	  TS_ASSERT(element_nodes != element_nodes_before);
+	  TS_ASSERT(element_nodes == GetElementNodeIndices(*p_plain_mesh));
+	  TS_ASSERT_EQUALS(p_mesh->GetNumNodes(), p_plain_mesh->GetNumNodes());
+	  for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+	    {
+	      TS_ASSERT_DELTA(p_mesh->GetNode(i)->rGetLocation()[0], p_plain_mesh->GetNode(i)->rGetLocation()[0], 1e-12);
+	      TS_ASSERT_DELTA(p_mesh->GetNode(i)->rGetLocation()[1], p_plain_mesh->GetNode(i)->rGetLocation()[1], 1e-12);
+	    }
+
+	  // and no node is left inside an element it is not part of
+	  for (unsigned i=0; i<p_mesh->GetNumNodes(); i++)
+	    {
+	      Node<2>* p_other_node = p_mesh->GetNode(i);
+	      for (unsigned elem_index=0; elem_index<p_mesh->GetNumElements(); elem_index++)
+		{
+		  if (p_other_node->rGetContainingElementIndices().count(elem_index) == 0)
+		    {
+		      TS_ASSERT(!p_mesh->ElementIncludesPoint(p_other_node->rGetLocation(), elem_index));
+		    }
+		}
+	    }
+
+	  delete p_plain_mesh;
+	}
+    }
+};
+
+#endif /*TESTREORDERABLETOROIDAL2DVERTEXMESH_HPP_*/
@@ -44,9 +44,10 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "PetscSetupAndFinalize.hpp"
 
 #include "ToroidalHoneycombVertexMeshGenerator2.hpp"    // Modified to give unit size cells
+#include "ToroidalVoronoiVertexMeshGenerator.hpp"    // Disordered initial tissue
 
 #include "OffLatticeSimulation.hpp"
-#include "VertexBasedCellPopulation.hpp"
+#include "OutputCadenceVertexBasedCellPopulation.hpp"    // VertexBasedCellPopulation with separate VTK and writer cadences
 
 #include "WildTypeCellMutationState.hpp"
 #include "DifferentiatedCellProliferativeType.hpp"
@@ -58,12 +59,25 @@ OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ErkPropulsionSrnModelNoAlignment.hpp"
 #include "ErkPropulsionModifierNoAlignment.hpp"
+#include "ErkPropulsionSrnModelNeighbourAlignment.hpp"
+#include "ErkPropulsionModifierNeighbourAlignment.hpp"
 #include "ErkPropulsionWriterNoAlignment.hpp"
+#include "ErkPropulsionBinaryWriter.hpp"
 
 #include "CellTensionModifier.hpp"    // Saves the cell "tension" in CellData
-// #include "CellElongationModifier.hpp"    // Save "elongation" and "orientation" in CellData
+#include "CellElongationModifier.hpp"    // Save "elongation" and "orientation" in CellData
+#include "AsyncOutputFlushModifier.hpp"    // Finish asynchronous output at the end of Solve()
+#include "ErkSpectrumModifier.hpp"    // In-situ ERK space-time power spectrum
+#include "ErkOscillationModifier.hpp"    // Per-cell ERK period, amplitude and area phase lag
+#include "CoarseGrainedFieldsModifier.hpp"    // Time-averaged velocity, nematic and stress fields
+#include "ShearRheometerModifier.hpp"    // Effective viscosity from the sinusoidal shear response
+#include "CellMotilityCorrelationModifier.hpp"    // Cell MSD and velocity autocorrelation
+#include "SteadyStateModifier.hpp"    // Ends the burn-in once the tissue is statistically steady
+#include "HealthMonitorModifier.hpp"    // Aborts runs that blow up numerically or geometrically
+#include "ForceBudgetModifier.hpp"    // Time series of the energy and the power of each force term
 
 #include "CommandLineArguments.hpp"
+#include <algorithm>
 #include <iostream>
 #include <boost/filesystem.hpp>
 
@@ -75,6 +89,108 @@ std::string get_timestamp()
   return std::string(buf, buf + std::strftime(buf, sizeof(buf), "%F_%T", std::gmtime(&now)));
 }
 
+// Record how a run ended in run_status.txt, so that batch scripts
+// can tell an aborted run from a completed one without parsing
+// logs. Runs stopped by an exception that the health monitor did
+// not raise (e.g. a failed T1 swap) have reason EXCEPTION
+void write_run_status(const std::string& rPath, const std::string& rStatus, HealthMonitorModifier<2>::Reason reason, const std::string& rMessage)
+{
+  std::ofstream status_file(rPath);
+  status_file << "status " << rStatus << std::endl
+	      << "reason " << (rStatus == "aborted" && reason == HealthMonitorModifier<2>::HEALTHY ? "EXCEPTION" : HealthMonitorModifier<2>::GetReasonName(reason)) << std::endl
+	      << "time " << std::to_string(SimulationTime::Instance()->GetTime()) << std::endl
+	      << "message " << rMessage << std::endl;
+  status_file.close();
+}
+
+// An OffLatticeSimulation that finishes Solve() early, at the end of
+// the time step in which the SteadyStateModifier reaches a steady
+// state or the ShearRheometerModifier converges, if either was asked
+// to stop the simulation. The modifiers only report, so the end time
+// given to the simulation is left untouched.
+//
+// At the start of each Solve() the output-only modifiers are also set
+// to update CellData at the simulation's own sampling timestep
+// multiple, so they cannot fall out of step with the output.
+class StoppingOffLatticeSimulation : public OffLatticeSimulation<2>
+{
+private:
+  friend class boost::serialization::access;
+  template<class Archive>
+  void serialize(Archive & archive, const unsigned int version)
+  {
+    archive & boost::serialization::base_object<OffLatticeSimulation<2> >(*this);
+  }
+
+protected:
+  void SetupSolve()
+  {
+    OffLatticeSimulation<2>::SetupSolve();
+    for (unsigned i=0; i<this->mSimulationModifiers.size(); i++)
+      {
+	boost::shared_ptr<AbstractOutputOnlyModifier<2> > p_output_modifier = boost::dynamic_pointer_cast<AbstractOutputOnlyModifier<2> >(this->mSimulationModifiers[i]);
+	if (p_output_modifier)
+	  {
+	    p_output_modifier->SetSamplingTimestepMultiple(this->mSamplingTimestepMultiple);
+	  }
+      }
+  }
+
+  bool StoppingEventHasOccurred()
+  {
+    for (unsigned i=0; i<this->mSimulationModifiers.size(); i++)
+      {
+	boost::shared_ptr<SteadyStateModifier<2> > p_steady_state_modifier = boost::dynamic_pointer_cast<SteadyStateModifier<2> >(this->mSimulationModifiers[i]);
+	if (p_steady_state_modifier && p_steady_state_modifier->GetStopOnSteadyState() && p_steady_state_modifier->HasReachedSteadyState())
+	  {
+	    return true;
+	  }
+	boost::shared_ptr<ShearRheometerModifier<2> > p_rheometer_modifier = boost::dynamic_pointer_cast<ShearRheometerModifier<2> >(this->mSimulationModifiers[i]);
+	if (p_rheometer_modifier && p_rheometer_modifier->GetStopOnConvergence() && p_rheometer_modifier->HasConverged())
+	  {
+	    return true;
+	  }
+      }
+    return false;
+  }
+
+public:
+  StoppingOffLatticeSimulation(AbstractCellPopulation<2>& rCellPopulation,
+			       bool deleteCellPopulationInDestructor=false,
+			       bool initialiseCells=true)
+    : OffLatticeSimulation<2>(rCellPopulation, deleteCellPopulationInDestructor, initialiseCells)
+  {
+  }
+};
+
+#include "SerializationExportWrapper.hpp"
+CHASTE_CLASS_EXPORT(StoppingOffLatticeSimulation)
+#include "SerializationExportWrapperForCpp.hpp"
+CHASTE_CLASS_EXPORT(StoppingOffLatticeSimulation)
+
+namespace boost
+{
+namespace serialization
+{
+// As for OffLatticeSimulation, the cell population is needed to
+// construct the simulation
+template<class Archive>
+inline void save_construct_data(Archive & ar, const StoppingOffLatticeSimulation * t, const unsigned int file_version)
+{
+  const AbstractCellPopulation<2>* p_cell_population = &(t->rGetCellPopulation());
+  ar & p_cell_population;
+}
+
+template<class Archive>
+inline void load_construct_data(Archive & ar, StoppingOffLatticeSimulation * t, const unsigned int file_version)
+{
+  AbstractCellPopulation<2>* p_cell_population;
+  ar >> p_cell_population;
+  ::new(t)StoppingOffLatticeSimulation(*p_cell_population, true, false);
+}
+}
+} // namespace
+
 class TestSinusoidalShearForceNematic : public AbstractCellBasedTestSuite
 {
 public:
@@ -106,12 +222,48 @@ public:
       double end_time = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-end_time");
       // How often write data to file
       int sampling_timestep_multiple = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-sampling_timestep_multiple");
+      // How often to write VTK (results.pvd) and Chaste visualizer
+      // output; by default the same as the cell data, 0 for never
+      int vtk_timestep_multiple = sampling_timestep_multiple;
+      if (CommandLineArguments::Instance()->OptionExists("-vtk_timestep_multiple"))
+	{
+	  vtk_timestep_multiple = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-vtk_timestep_multiple");
+	}
+      // The simulation samples whenever either output is due
+      int output_timestep_multiple = sampling_timestep_multiple;
+      for (int remainder = vtk_timestep_multiple; remainder > 0; )
+	{
+	  int next_remainder = output_timestep_multiple%remainder;
+	  output_timestep_multiple = remainder;
+	  remainder = next_remainder;
+	}
 
       // We avoid recording the initial transitiant we run one
       // simulation until end_time (saving only at start and end) then
       // load and simulate again for bonus_time, sampling at the rate
       // set by the sampling_timestep_multiple.
       double bonus_time = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-bonus_time");
+      // With -burn_in_tolerance the burn-in instead ends as soon as
+      // the energy, mean |ERK|, area variance and order parameters
+      // stop drifting (by more than the tolerance, relative to their
+      // size, over four windows of burn_in_window) and end_time is
+      // only the longest burn-in allowed. The burn-in actually used
+      // is added to params.txt as burn_in_time.
+      double burn_in_tolerance = 0.0;
+      if (CommandLineArguments::Instance()->OptionExists("-burn_in_tolerance"))
+	{
+	  burn_in_tolerance = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-burn_in_tolerance");
+	}
+      double burn_in_window = 10.0;
+      if (CommandLineArguments::Instance()->OptionExists("-burn_in_window"))
+	{
+	  burn_in_window = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-burn_in_window");
+	}
+      double burn_in_min_time = 0.0;
+      if (CommandLineArguments::Instance()->OptionExists("-burn_in_min_time"))
+	{
+	  burn_in_min_time = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-burn_in_min_time");
+	}
 
       // Initial mean values of variables
       double init_erk = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-init_erk");
@@ -141,6 +293,9 @@ public:
       double P0 = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-P0");
       // Strength of coupling between cell elongation and line tension
       double Lambda = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-lambda");
+      // Assemble the perimeter and nematic forces edge by edge
+      // (each edge's tension computed once) instead of node by node
+      bool edge_assembly = CommandLineArguments::Instance()->OptionExists("-edge_assembly");
 
       // Self-propulsion force pre-scaled by the subrate friction coefficient
       double F0 = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-F0");
@@ -148,6 +303,17 @@ public:
       // Shear rate magnitute
       double F1 = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-F1");
 
+      // Strength K of the alignment of each cell's self propulsion
+      // angle with the mean polarity of its edge-sharing neighbours
+      // (or their mean velocity with -align_to_neighbour_velocities).
+      // Zero means no alignment.
+      double neighbour_alignment = 0.0;
+      if (CommandLineArguments::Instance()->OptionExists("-neighbour_alignment"))
+	{
+	  neighbour_alignment = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-neighbour_alignment");
+	}
+      bool align_to_neighbour_velocities = CommandLineArguments::Instance()->OptionExists("-align_to_neighbour_velocities");
+
       // Value of mechanochemical coupling strength alpha*beta in
       // terms of the critical value for onset of pattern formaion
       // predicted by linear stability
@@ -211,6 +377,125 @@ public:
       // Checks for geometric errors in simulation, e.g. missing T1s
       // may lead to overlappling (intersecting) cells.
       bool check_for_internal_intersections = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-check_for_internal_intersections");
+      // The check uses a spatial hash so is cheap, but can also be
+      // made only every intersection_check_interval remeshes
+      int intersection_check_interval = 1;
+      if (CommandLineArguments::Instance()->OptionExists("-intersection_check_interval"))
+	{
+	  intersection_check_interval = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-intersection_check_interval");
+	}
+
+      // Start from a disordered (periodic Voronoi) tissue instead of
+      // a noisy honeycomb, relaxed towards equal sized cells by this
+      // many Lloyd steps
+      bool voronoi = CommandLineArguments::Instance()->OptionExists("-voronoi");
+      int voronoi_relaxation_steps = 3;
+      if (CommandLineArguments::Instance()->OptionExists("-voronoi_relaxation_steps"))
+	{
+	  voronoi_relaxation_steps = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-voronoi_relaxation_steps");
+	}
+
+      // Number nodes and elements along a Hilbert curve, for memory
+      // locality in large meshes, when the mesh is generated and then
+      // every renumber_timestep_multiple time steps (0 for never)
+      int renumber_timestep_multiple = 0;
+      if (CommandLineArguments::Instance()->OptionExists("-renumber_timestep_multiple"))
+	{
+	  renumber_timestep_multiple = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-renumber_timestep_multiple");
+	}
+
+      // Cell data is written to the binary columnar file celldata.bin
+      // (see python/read_celldata.py) unless the old whitespace
+      // separated celldata.dat is requested with -text_celldata
+      bool text_celldata = CommandLineArguments::Instance()->OptionExists("-text_celldata");
+
+      // Optional absolute error bounds for celldata.bin fields, given
+      // as name=bound pairs, e.g. -error_bounds x=1e-4 y=1e-4 erk=1e-4.
+      // Bounded fields are stored compressed rather than exactly.
+      std::vector<std::string> error_bounds;
+      if (CommandLineArguments::Instance()->OptionExists("-error_bounds"))
+	{
+	  error_bounds = CommandLineArguments::Instance()->GetStringsCorrespondingToOption("-error_bounds");
+	}
+      // The ERK wave spectrum is measured in situ during the data
+      // capture period on a grid of erk_spectrum_grid^2 points with
+      // Welch segments of erk_spectrum_segment samples (both powers
+      // of two). With -no_celldata the per-cell data is not written.
+      int erk_spectrum_grid = 16;
+      if (CommandLineArguments::Instance()->OptionExists("-erk_spectrum_grid"))
+	{
+	  erk_spectrum_grid = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-erk_spectrum_grid");
+	}
+      int erk_spectrum_segment = 64;
+      if (CommandLineArguments::Instance()->OptionExists("-erk_spectrum_segment"))
+	{
+	  erk_spectrum_segment = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-erk_spectrum_segment");
+	}
+      bool no_celldata = CommandLineArguments::Instance()->OptionExists("-no_celldata");
+      // The per-cell ERK oscillation statistics are measured during
+      // the data capture period only with -erk_oscillations
+      bool erk_oscillations = CommandLineArguments::Instance()->OptionExists("-erk_oscillations");
+      // The shear rheometer runs only with -shear_rheometer
+      bool shear_rheometer = CommandLineArguments::Instance()->OptionExists("-shear_rheometer");
+      // The cell motility correlations are accumulated only with
+      // -motility_correlations
+      bool motility_correlations = CommandLineArguments::Instance()->OptionExists("-motility_correlations");
+      // T1 and T2 swaps are logged during the data capture period
+      // unless -no_rearrangement_log is given
+      bool no_rearrangement_log = CommandLineArguments::Instance()->OptionExists("-no_rearrangement_log");
+      // Velocity, nematic and stress fields are coarse-grained onto a
+      // coarse_grain_grid^2 grid with a Gaussian kernel of width
+      // coarse_grain_kernel_width (0 for cloud-in-cell binning)
+      int coarse_grain_grid = 32;
+      if (CommandLineArguments::Instance()->OptionExists("-coarse_grain_grid"))
+	{
+	  coarse_grain_grid = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-coarse_grain_grid");
+	}
+      double coarse_grain_kernel_width = 0.0;
+      if (CommandLineArguments::Instance()->OptionExists("-coarse_grain_kernel_width"))
+	{
+	  coarse_grain_kernel_width = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-coarse_grain_kernel_width");
+	}
+      // With -shear_rheometer the effective viscosity is measured
+      // from batches of rheometer_batch_length samples. If
+      // rheometer_tolerance is given the data capture period ends
+      // early, once the relative error of the velocity amplitude
+      // falls below it, instead of lasting bonus_time
+      int rheometer_batch_length = 100;
+      if (CommandLineArguments::Instance()->OptionExists("-rheometer_batch_length"))
+	{
+	  rheometer_batch_length = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-rheometer_batch_length");
+	}
+      double rheometer_tolerance = 0.0;
+      if (CommandLineArguments::Instance()->OptionExists("-rheometer_tolerance"))
+	{
+	  rheometer_tolerance = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-rheometer_tolerance");
+	}
+      // The run is aborted, with a snapshot of the failing state in
+      // health_snapshot.dat, if any node force exceeds max_force or
+      // the mean energy per cell exceeds max_energy_per_cell. The
+      // checks are made every health_check_interval time steps
+      int health_check_interval = 1;
+      if (CommandLineArguments::Instance()->OptionExists("-health_check_interval"))
+	{
+	  health_check_interval = CommandLineArguments::Instance()->GetIntCorrespondingToOption("-health_check_interval");
+	}
+      double max_force = 1e3;
+      if (CommandLineArguments::Instance()->OptionExists("-max_force"))
+	{
+	  max_force = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-max_force");
+	}
+      double max_energy_per_cell = 1e3;
+      if (CommandLineArguments::Instance()->OptionExists("-max_energy_per_cell"))
+	{
+	  max_energy_per_cell = CommandLineArguments::Instance()->GetDoubleCorrespondingToOption("-max_energy_per_cell");
+	}
+
+      std::string error_bounds_string;
+      for (unsigned i=0; i<error_bounds.size(); i++)
+	{
+	  error_bounds_string += (i == 0 ? "" : ",") + error_bounds[i];
+	}
 
       // Save all parameters to file.
       std::string outdirpath = std::string(getenv("CHASTE_TEST_OUTPUT")) + "/" + outdir;
@@ -228,7 +513,11 @@ public:
 	     << "dt_ode " << std::to_string(dt_ode) << std::endl
 	     << "end_time " << std::to_string(end_time) << std::endl
 	     << "sampling_timestep_multiple " << std::to_string(sampling_timestep_multiple) << std::endl
+	     << "vtk_timestep_multiple " << std::to_string(vtk_timestep_multiple) << std::endl
 	     << "bonus_time " << std::to_string(bonus_time) << std::endl
+	     << "burn_in_tolerance " << std::to_string(burn_in_tolerance) << std::endl
+	     << "burn_in_window " << std::to_string(burn_in_window) << std::endl
+	     << "burn_in_min_time " << std::to_string(burn_in_min_time) << std::endl
 	     << "init_erk " << std::to_string(init_erk) << std::endl
 	     << "init_A0 " << std::to_string(init_A0) << std::endl
 	     << "init_A " << std::to_string(init_A) << std::endl
@@ -239,30 +528,70 @@ public:
 	     << "eta_std " << std::to_string(eta_std) << std::endl
 	     << "F0 " << std::to_string(F0) << std::endl
 	     << "F1 " << std::to_string(F1) << std::endl
+	     << "neighbour_alignment " << std::to_string(neighbour_alignment) << std::endl
+	     << "align_to_neighbour_velocities " << std::to_string(align_to_neighbour_velocities) << std::endl
 	     << "KA " << std::to_string(KA) << std::endl
 	     << "KP " << std::to_string(KP) << std::endl
 	     << "P0 " << std::to_string(P0) << std::endl
 	     << "lambda " << std::to_string(Lambda) << std::endl
+	     << "edge_assembly " << std::to_string(edge_assembly) << std::endl
 	     << "n_abcrit " << std::to_string(n_abcrit) << std::endl
 	     << "abcrit " << std::to_string(abcrit) << std::endl
 	     << "ab_ratio " << std::to_string(ab_ratio) << std::endl
 	     << "ab " << std::to_string(ab) << std::endl
 	     << "alpha " << std::to_string(alpha) << std::endl
 	     << "beta " << std::to_string(beta) << std::endl
-	     << "check_for_internal_intersections " << std::to_string(check_for_internal_intersections) << std::endl;
+	     << "check_for_internal_intersections " << std::to_string(check_for_internal_intersections) << std::endl
+	     << "intersection_check_interval " << std::to_string(intersection_check_interval) << std::endl
+	     << "text_celldata " << std::to_string(text_celldata) << std::endl
+	     << "error_bounds " << (error_bounds.empty() ? "none" : error_bounds_string) << std::endl
+	     << "erk_spectrum_grid " << std::to_string(erk_spectrum_grid) << std::endl
+	     << "erk_spectrum_segment " << std::to_string(erk_spectrum_segment) << std::endl
+	     << "no_celldata " << std::to_string(no_celldata) << std::endl
+	     << "erk_oscillations " << std::to_string(erk_oscillations) << std::endl
+	     << "shear_rheometer " << std::to_string(shear_rheometer) << std::endl
+	     << "motility_correlations " << std::to_string(motility_correlations) << std::endl
+	     << "no_rearrangement_log " << std::to_string(no_rearrangement_log) << std::endl
+	     << "coarse_grain_grid " << std::to_string(coarse_grain_grid) << std::endl
+	     << "coarse_grain_kernel_width " << std::to_string(coarse_grain_kernel_width) << std::endl
+	     << "rheometer_batch_length " << std::to_string(rheometer_batch_length) << std::endl
+	     << "rheometer_tolerance " << std::to_string(rheometer_tolerance) << std::endl
+	     << "max_force " << std::to_string(max_force) << std::endl
+	     << "max_energy_per_cell " << std::to_string(max_energy_per_cell) << std::endl
+	     << "health_check_interval " << std::to_string(health_check_interval) << std::endl
+	     << "renumber_timestep_multiple " << std::to_string(renumber_timestep_multiple) << std::endl
+	     << "voronoi " << std::to_string(voronoi) << std::endl
+	     << "voronoi_relaxation_steps " << std::to_string(voronoi_relaxation_steps) << std::endl;
       myfile.close();
 
       // Set up the vertex model
 
       // Create a vertex mesh of regular hexagonal cells with unit
       // area and perturb by adding noise to the initial vertex
-      // positions.
-      ToroidalHoneycombVertexMeshGenerator2 generator(nx, ny, init_A0, noiseSD_pos);
-      Toroidal2dVertexMesh* p_mesh = generator.GetToroidalMesh();
+      // positions, or a Voronoi mesh of the same size. The generator
+      // owns the mesh so must outlive the simulation.
+      boost::shared_ptr<ToroidalHoneycombVertexMeshGenerator2> p_honeycomb_generator;
+      boost::shared_ptr<ToroidalVoronoiVertexMeshGenerator> p_voronoi_generator;
+      ReorderableToroidal2dVertexMesh* p_mesh;
+      if (voronoi)
+	{
+	  p_voronoi_generator.reset(new ToroidalVoronoiVertexMeshGenerator(nx, ny, init_A0, voronoi_relaxation_steps));
+	  p_mesh = p_voronoi_generator->GetToroidalMesh();
+	}
+      else
+	{
+	  p_honeycomb_generator.reset(new ToroidalHoneycombVertexMeshGenerator2(nx, ny, init_A0, noiseSD_pos));
+	  p_mesh = p_honeycomb_generator->GetToroidalMesh();
+	}
+      if (renumber_timestep_multiple > 0)
+	{
+	  p_mesh->ReorderAlongHilbertCurve();
+	}
 
       // Add a check for overlapping cells (can happen when T1s aren't
       // properly detected.
       p_mesh->SetCheckForInternalIntersections(check_for_internal_intersections);
+      p_mesh->SetIntersectionCheckInterval(intersection_check_interval);
 
       // Create and initialize cells
       std::vector<CellPtr> cells;
@@ -287,7 +616,15 @@ public:
 	  // Initial values of ERK and A0 plus optional noise
 	  initial_conditions.push_back(RandomNumberGenerator::Instance()->NormalRandomDeviate(init_erk, noiseSD_erk));    // Erk
 	  initial_conditions.push_back(RandomNumberGenerator::Instance()->NormalRandomDeviate(init_A0, noiseSD_A0));    // Target area
-	  ErkPropulsionSrnModelNoAlignment* p_srn_model = new ErkPropulsionSrnModelNoAlignment();
+	  AbstractOdeSrnModel* p_srn_model;
+	  if (neighbour_alignment == 0.0)
+	    {
+	      p_srn_model = new ErkPropulsionSrnModelNoAlignment();
+	    }
+	  else
+	    {
+	      p_srn_model = new ErkPropulsionSrnModelNeighbourAlignment();
+	    }
 	  p_srn_model->SetDt(dt_ode);
 	  p_srn_model->SetInitialConditions(initial_conditions);
 
@@ -317,13 +654,45 @@ public:
 	  // variance in the SDE so that the timestep does not affect
 	  // the persistence time or the persistent random walk.
 	  p_cell->GetCellData()->SetItem("dt_ode", dt_ode);
+	  if (neighbour_alignment != 0.0)
+	    {
+	      // Strength of alignment and the angle to align with
+	      // (updated by the ErkPropulsionModifier)
+	      p_cell->GetCellData()->SetItem("K", neighbour_alignment);
+	      p_cell->GetCellData()->SetItem("theta_vi", initial_conditions[0]);
+	    }
 	  cells.push_back(p_cell);
         }
 
       // Create a cell-based population object, and specify which
       // results to output to file.
-      VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
-      cell_population.AddCellWriter<ErkPropulsionWriterNoAlignment>();
+      OutputCadenceVertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+      cell_population.SetRenumberingTimestepMultiple(renumber_timestep_multiple);
+      boost::shared_ptr<ErkPropulsionBinaryWriter<2,2> > p_writer;
+      if (text_celldata)
+	{
+	  cell_population.AddCellWriter<ErkPropulsionWriterNoAlignment>();
+	}
+      else
+	{
+	  p_writer.reset(new ErkPropulsionBinaryWriter<2,2>());
+	  // Write samples from a background thread so that the time
+	  // loop does not stall on the filesystem
+	  p_writer->SetAsynchronous(4);
+	  p_writer->AddExtraField("tension");
+	  p_writer->AddExtraField("elongation");
+	  p_writer->AddExtraField("orientation");
+	  for (unsigned i=0; i<error_bounds.size(); i++)
+	    {
+	      std::size_t equals = error_bounds[i].find('=');
+	      if (equals == std::string::npos)
+		{
+		  EXCEPTION("Expected name=bound after -error_bounds, got " << error_bounds[i]);
+		}
+	      p_writer->SetErrorBound(error_bounds[i].substr(0, equals), std::stod(error_bounds[i].substr(equals+1)));
+	    }
+	  cell_population.AddCellWriter(p_writer);
+	}
       for (typename VertexBasedCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
 	   cell_iter != cell_population.End();
 	   ++cell_iter)
@@ -341,10 +710,19 @@ public:
 	  unsigned elem_index = cell_population.GetElementCorrespondingToCell(*cell_iter)->GetIndex();
 	  double P = cell_population.rGetMesh().GetSurfaceAreaOfElement(elem_index);
 	  cell_iter->GetCellData()->SetItem("perimeter", P);
+
+	  if (align_to_neighbour_velocities)
+	    {
+	      // Initialize the cell centre, from which velocities are
+	      // found by finite differences
+	      c_vector<double, 2> cell_centre = cell_population.GetLocationOfCellCentre(*cell_iter);
+	      cell_iter->GetCellData()->SetItem("loc_x", cell_centre[0]);
+	      cell_iter->GetCellData()->SetItem("loc_y", cell_centre[1]);
+	    }
 	}
 
       // Create and configure the cell-based simulation object
-      OffLatticeSimulation<2> simulator(cell_population);
+      StoppingOffLatticeSimulation simulator(cell_population);
       simulator.SetOutputDirectory(outdir);
       simulator.SetDt(dt);
       // Only save the start and end points of the burn-in period
@@ -353,8 +731,17 @@ public:
 
       // Add a modifier that keeps track of variables and updates them
       // between the solver and the CellData.
-      MAKE_PTR(ErkPropulsionModifierNoAlignment<2>, p_modifier);
-      simulator.AddSimulationModifier(p_modifier);
+      if (neighbour_alignment == 0.0)
+	{
+	  MAKE_PTR(ErkPropulsionModifierNoAlignment<2>, p_modifier);
+	  simulator.AddSimulationModifier(p_modifier);
+	}
+      else
+	{
+	  MAKE_PTR(ErkPropulsionModifierNeighbourAlignment<2>, p_modifier);
+	  p_modifier->SetAlignToNeighbourVelocities(align_to_neighbour_velocities);
+	  simulator.AddSimulationModifier(p_modifier);
+	}
 
       // Add self propulsion force to use with the persistent random
       // walk in the ODE system / SRN model
@@ -371,6 +758,7 @@ public:
       p_force->SetKP(KP);
       p_force->SetP0(P0);
       p_force->SetLambda(Lambda);
+      p_force->SetUseEdgeAssembly(edge_assembly);
       simulator.AddForce(p_force);
 
       // Add a modifier that keeps track of variables and updates them
@@ -379,19 +767,181 @@ public:
       p_tension_modifier->SetKA(KA);
       p_tension_modifier->SetKP(KP);
       p_tension_modifier->SetP0(P0);
+      // Tension is only used for output so it is only computed on
+      // the simulation's sampling timesteps
       simulator.AddSimulationModifier(p_tension_modifier);
 
+      // Record cell elongation and orientation in CellData, reusing
+      // the shapes computed by the nematic force
+      MAKE_PTR(CellElongationModifier<2>, p_elongation_modifier);
+      p_elongation_modifier->SetNematicForce(p_force);
+      simulator.AddSimulationModifier(p_elongation_modifier);
+
+      // Make sure all asynchronous output is written before Solve()
+      // returns
+      if (p_writer)
+	{
+	  MAKE_PTR(AsyncOutputFlushModifier<2>, p_flush_modifier);
+	  p_flush_modifier->AddWriter(p_writer);
+	  simulator.AddSimulationModifier(p_flush_modifier);
+	}
+
+      // End the burn-in early once the tissue is steady, sampling
+      // about 100 times per window
+      if (burn_in_tolerance > 0.0)
+	{
+	  MAKE_PTR(SteadyStateModifier<2>, p_steady_state_modifier);
+	  p_steady_state_modifier->SetNematicForce(p_force);
+	  int steady_state_sampling = std::max(1, int(round(burn_in_window/dt/100)));
+	  p_steady_state_modifier->SetSamplingTimestepMultiple(steady_state_sampling);
+	  p_steady_state_modifier->SetWindows(std::max(1, int(round(burn_in_window/(dt*steady_state_sampling)))), 4);
+	  p_steady_state_modifier->SetTolerance(burn_in_tolerance);
+	  p_steady_state_modifier->SetMinTime(burn_in_min_time);
+	  simulator.AddSimulationModifier(p_steady_state_modifier);
+	}
+
+      // Stop as soon as the tissue blows up or tangles. The monitor
+      // is checkpointed with the simulation, so it also watches the
+      // data capture period
+      MAKE_PTR(HealthMonitorModifier<2>, p_health_modifier);
+      p_health_modifier->SetNematicForce(p_force);
+      p_health_modifier->SetMaxForce(max_force);
+      p_health_modifier->SetMaxEnergyPerCell(max_energy_per_cell);
+      p_health_modifier->SetCheckTimestepMultiple(health_check_interval);
+      simulator.AddSimulationModifier(p_health_modifier);
+
+      // Energy and power of each force term, for convergence
+      // checks. This is also checkpointed and continues over the data
+      // capture period
+      MAKE_PTR(ForceBudgetModifier<2>, p_budget_modifier);
+      p_budget_modifier->SetNematicForce(p_force);
+      p_budget_modifier->SetPropulsionForce(p_propulsion_force);
+      p_budget_modifier->SetShearForce(p_shear_force);
+      p_budget_modifier->SetSamplingTimestepMultiple(sampling_timestep_multiple);
+      simulator.AddSimulationModifier(p_budget_modifier);
+
       // Run the simulation over the burn-in period
-      simulator.Solve();
+      std::string status_path = outdirpath + "/run_status.txt";
+      try
+	{
+	  simulator.Solve();
+	}
+      catch (Exception& e)
+	{
+	  write_run_status(status_path, "aborted", p_health_modifier->GetReason(), e.GetShortMessage());
+	  throw;
+	}
       CellBasedSimulationArchiver<2, OffLatticeSimulation<2>>::Save(&simulator);
 
+      // Record the burn-in actually used, which the checkpoint is
+      // labelled with
+      end_time = SimulationTime::Instance()->GetTime();
+      myfile.open(outpath, std::ios::app);
+      myfile << "burn_in_time " << std::to_string(end_time) << std::endl;
+      myfile.close();
+
       // Now load from the checkpoint created after the burn-in period
       // and record data at more frequenct intervals
       OffLatticeSimulation<2>* p_simulator = CellBasedSimulationArchiver<2, OffLatticeSimulation<2>>::Load(outdir, end_time);
-      p_simulator->SetSamplingTimestepMultiple(sampling_timestep_multiple);
+      p_simulator->SetSamplingTimestepMultiple(output_timestep_multiple);
+      // Numeric cell data and visualisation output can each be
+      // written less often than the simulation samples
+      OutputCadenceVertexBasedCellPopulation<2>* p_population = dynamic_cast<OutputCadenceVertexBasedCellPopulation<2>*>(&(p_simulator->rGetCellPopulation()));
+      p_population->SetVtkTimestepMultiple(vtk_timestep_multiple);
+      p_population->SetWriterTimestepMultiple("results.viznodes", vtk_timestep_multiple);
+      p_population->SetWriterTimestepMultiple("results.vizelements", vtk_timestep_multiple);
+      p_population->SetWriterTimestepMultiple(text_celldata ? "celldata.dat" : "celldata.bin", no_celldata ? 0 : sampling_timestep_multiple);
+      p_population->SetLogRearrangements(!no_rearrangement_log);
+      std::vector<boost::shared_ptr<AbstractCellBasedSimulationModifier<2,2> > >* p_modifiers = p_simulator->GetSimulationModifiers();
+      for (unsigned i=0; i<p_modifiers->size(); i++)
+	{
+	  // The restored health monitor reports why a run was aborted
+	  boost::shared_ptr<HealthMonitorModifier<2> > p_loaded_health_modifier = boost::dynamic_pointer_cast<HealthMonitorModifier<2> >((*p_modifiers)[i]);
+	  if (p_loaded_health_modifier)
+	    {
+	      p_health_modifier = p_loaded_health_modifier;
+	    }
+	  // Keep checking that the tissue is steady, without stopping
+	  boost::shared_ptr<SteadyStateModifier<2> > p_steady_state_modifier = boost::dynamic_pointer_cast<SteadyStateModifier<2> >((*p_modifiers)[i]);
+	  if (p_steady_state_modifier)
+	    {
+	      p_steady_state_modifier->SetStopOnSteadyState(false);
+	    }
+	}
+
+      // Measure ERK waves over the data capture period
+      MAKE_PTR(ErkSpectrumModifier<2>, p_spectrum_modifier);
+      p_spectrum_modifier->SetGridSize(erk_spectrum_grid, erk_spectrum_grid);
+      p_spectrum_modifier->SetSegmentLength(erk_spectrum_segment);
+      p_spectrum_modifier->SetSamplingTimestepMultiple(sampling_timestep_multiple);
+      p_simulator->AddSimulationModifier(p_spectrum_modifier);
+
+      // Per-cell oscillation statistics
+      if (erk_oscillations)
+	{
+	  MAKE_PTR(ErkOscillationModifier<2>, p_oscillation_modifier);
+	  p_oscillation_modifier->SetSamplingTimestepMultiple(sampling_timestep_multiple);
+	  p_simulator->AddSimulationModifier(p_oscillation_modifier);
+	}
+
+      // Coarse-grained fields and rheology for shear profile
+      // studies, using the forces restored from the checkpoint
+      MAKE_PTR(CoarseGrainedFieldsModifier<2>, p_fields_modifier);
+      MAKE_PTR(ShearRheometerModifier<2>, p_rheometer_modifier);
+      const std::vector<boost::shared_ptr<AbstractForce<2,2> > >& r_forces = p_simulator->rGetForceCollection();
+      for (unsigned i=0; i<r_forces.size(); i++)
+	{
+	  boost::shared_ptr<TargetAreaAndNematicPerimeterForce<2> > p_nematic_force = boost::dynamic_pointer_cast<TargetAreaAndNematicPerimeterForce<2> >(r_forces[i]);
+	  if (p_nematic_force)
+	    {
+	      p_fields_modifier->SetNematicForce(p_nematic_force);
+	    }
+	  boost::shared_ptr<SinusoidalShearForce<2> > p_loaded_shear_force = boost::dynamic_pointer_cast<SinusoidalShearForce<2> >(r_forces[i]);
+	  if (p_loaded_shear_force)
+	    {
+	      p_rheometer_modifier->SetShearForce(p_loaded_shear_force);
+	    }
+	}
+      p_fields_modifier->SetGridSize(coarse_grain_grid, coarse_grain_grid);
+      if (coarse_grain_kernel_width > 0.0)
+	{
+	  p_fields_modifier->SetKernel(PeriodicGrid::GAUSSIAN, coarse_grain_kernel_width);
+	}
+      p_fields_modifier->SetSamplingTimestepMultiple(sampling_timestep_multiple);
+      p_simulator->AddSimulationModifier(p_fields_modifier);
+
+      if (shear_rheometer)
+	{
+	  p_rheometer_modifier->SetBatches(rheometer_batch_length, 10);
+	  if (rheometer_tolerance > 0.0)
+	    {
+	      p_rheometer_modifier->SetTolerance(rheometer_tolerance);
+	    }
+	  p_rheometer_modifier->SetSamplingTimestepMultiple(sampling_timestep_multiple);
+	  p_simulator->AddSimulationModifier(p_rheometer_modifier);
+	}
+
+      // MSD and VACF of cell centres for calibrating the persistent
+      // random walk
+      if (motility_correlations)
+	{
+	  MAKE_PTR(CellMotilityCorrelationModifier<2>, p_motility_modifier);
+	  p_motility_modifier->SetSamplingTimestepMultiple(sampling_timestep_multiple);
+	  p_simulator->AddSimulationModifier(p_motility_modifier);
+	}
+
       p_simulator->SetEndTime(end_time+bonus_time);
-      p_simulator->Solve();
+      try
+	{
+	  p_simulator->Solve();
+	}
+      catch (Exception& e)
+	{
+	  write_run_status(status_path, "aborted", p_health_modifier->GetReason(), e.GetShortMessage());
+	  throw;
+	}
       CellBasedSimulationArchiver<2, OffLatticeSimulation<2>>::Save(p_simulator);
+      write_run_status(status_path, "complete", p_health_modifier->GetReason(), "");
 
     }
 };
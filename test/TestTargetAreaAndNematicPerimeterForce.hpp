@@ -0,0 +1,138 @@
+/*
+
+Copyright (c) 2005-2019, University of Oxford.
+All rights reserved.
+
+University of Oxford means the Chancellor, Masters and Scholars of the
+University of Oxford, having an administrative office at Wellington
+Square, Oxford OX1 2JD, UK.
+
+This file is part of Chaste.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+ * Redistributions of source code must retain the above copyright notice,
+   this list of conditions and the following disclaimer.
+ * Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+ * Neither the name of the University of Oxford nor the names of its
+   contributors may be used to endorse or promote products derived from this
+   software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE
+GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#ifndef TESTTARGETAREAANDNEMATICPERIMETERFORCE_HPP_
+#define TESTTARGETAREAANDNEMATICPERIMETERFORCE_HPP_
+
+#include <cxxtest/TestSuite.h>
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+
+#include "ToroidalHoneycombVertexMeshGenerator2.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "UniformG1GenerationalCellCycleModel.hpp"
+#include "TargetAreaAndNematicPerimeterForce.hpp"
+
+class TestTargetAreaAndNematicPerimeterForce : public AbstractCellBasedTestSuite
+{
+private:
+
+  // Evaluate a force on its own, returning the force on each node
+  std::vector<c_vector<double, 2> > EvaluateForce(TargetAreaAndNematicPerimeterForce<2>& rForce,
+						  VertexBasedCellPopulation<2>& rCellPopulation)
+  {
+    for (unsigned node_index=0; node_index<rCellPopulation.GetNumNodes(); node_index++)
+      {
+	rCellPopulation.GetNode(node_index)->ClearAppliedForce();
+      }
+    rForce.AddForceContribution(rCellPopulation);
+    std::vector<c_vector<double, 2> > node_forces;
+    for (unsigned node_index=0; node_index<rCellPopulation.GetNumNodes(); node_index++)
+      {
+	node_forces.push_back(rCellPopulation.GetNode(node_index)->rGetAppliedForce());
+      }
+    return node_forces;
+  }
+
+public:
+
+  void TestEdgeAssemblyMatchesNodeAssembly()
+    {
+      // A small noisy toroidal tissue, so that no cell is isotropic
+      // and the elements cross the periodic boundaries
+      ToroidalHoneycombVertexMeshGenerator2 generator(6, 6, 1.0, 0.05);
+      ReorderableToroidal2dVertexMesh* p_mesh = generator.GetToroidalMesh();
+
+      std::vector<CellPtr> cells;
+      MAKE_PTR(WildTypeCellMutationState, p_state);
+      MAKE_PTR(DifferentiatedCellProliferativeType, p_diff_type);
+      for (unsigned elem_index=0; elem_index<p_mesh->GetNumElements(); elem_index++)
+        {
+	  UniformG1GenerationalCellCycleModel* p_cc_model = new UniformG1GenerationalCellCycleModel();
+	  p_cc_model->SetDimension(2);
+	  CellPtr p_cell(new Cell(p_state, p_cc_model));
+	  p_cell->SetCellProliferativeType(p_diff_type);
+	  p_cell->SetBirthTime(0.0);
+	  p_cell->GetCellData()->SetItem("Target Area", 0.9 + 0.2*RandomNumberGenerator::Instance()->ranf());
+	  cells.push_back(p_cell);
+	}
+      VertexBasedCellPopulation<2> cell_population(*p_mesh, cells);
+
+      TargetAreaAndNematicPerimeterForce<2> node_force;
+      TargetAreaAndNematicPerimeterForce<2> edge_force;
+      TargetAreaAndNematicPerimeterForce<2>* forces[2] = {&node_force, &edge_force};
+      for (unsigned i=0; i<2; i++)
+	{
+	  forces[i]->SetKA(1.0);
+	  forces[i]->SetKP(0.1);
+	  forces[i]->SetP0(3.2);
+	  forces[i]->SetLambda(0.3);
+	}
+      edge_force.SetUseEdgeAssembly(true);
+
+      std::vector<c_vector<double, 2> > node_assembled = EvaluateForce(node_force, cell_population);
+      std::vector<c_vector<double, 2> > edge_assembled = EvaluateForce(edge_force, cell_population);
+
+      TS_ASSERT_EQUALS(node_assembled.size(), p_mesh->GetNumNodes());
+      TS_ASSERT_EQUALS(edge_assembled.size(), p_mesh->GetNumNodes());
+      TS_ASSERT_EQUALS(node_force.rGetNematicNodeForces().size(), p_mesh->GetNumNodes());
+      TS_ASSERT_EQUALS(edge_force.rGetNematicNodeForces().size(), p_mesh->GetNumNodes());
+      double largest_force = 0.0;
+      double largest_nematic_force = 0.0;
+      for (unsigned node_index=0; node_index<p_mesh->GetNumNodes(); node_index++)
+	{
+	  for (unsigned d=0; d<2; d++)
+	    {
+	      TS_ASSERT_DELTA(edge_assembled[node_index][d], node_assembled[node_index][d], 1e-12);
+	      TS_ASSERT_DELTA(edge_force.rGetNematicNodeForces()[node_index][d], node_force.rGetNematicNodeForces()[node_index][d], 1e-12);
+	    }
+	  largest_force = std::max(largest_force, norm_2(node_assembled[node_index]));
+	  largest_nematic_force = std::max(largest_nematic_force, norm_2(node_force.rGetNematicNodeForces()[node_index]));
+	}
+
+      // Both the total and the nematic forces are not trivially zero
+      TS_ASSERT_LESS_THAN(1e-3, largest_force);
+      TS_ASSERT_LESS_THAN(1e-3, largest_nematic_force);
+
+      // The energies are summed the same way by both
+      TS_ASSERT_DELTA(edge_force.GetAreaEnergy(), node_force.GetAreaEnergy(), 1e-12);
+      TS_ASSERT_DELTA(edge_force.GetPerimeterEnergy(), node_force.GetPerimeterEnergy(), 1e-12);
+    }
+};
+
+#endif /*TESTTARGETAREAANDNEMATICPERIMETERFORCE_HPP_*/